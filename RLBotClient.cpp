@@ -55,7 +55,6 @@ PlayerData ToPlayer(const rlbot::flat::PlayerInfo* playerInfo) {
 	pd.team = (Team)playerInfo->team();
 
 	pd.phys = ToPhysObj(playerInfo->physics());
-	pd.physInv = pd.phys.Invert();
 
 	pd.carState.pos = pd.phys.pos;
 	pd.carState.rotMat = pd.phys.rotMat;
@@ -80,7 +79,6 @@ GameState ToGameState(rlbot::GameTickPacket& gameTickPacket) {
 		gs.players.push_back(ToPlayer(players->Get(i)));
 
 	gs.ball = ToPhysObj(gameTickPacket->ball()->physics());
-	gs.ballInv = gs.ball.Invert();
 
 	auto boostPadStates = gameTickPacket->boostPadStates();
 	if (boostPadStates->size() != CommonValues::BOOST_LOCATIONS_AMOUNT) {
@@ -95,7 +93,6 @@ GameState ToGameState(rlbot::GameTickPacket& gameTickPacket) {
 	} else {
 		for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++) {
 			gs.boostPads[i] = boostPadStates->Get(i)->isActive();
-			gs.boostPadsInv[CommonValues::BOOST_LOCATIONS_AMOUNT - i - 1] = gs.boostPads[i];
 		}
 	}
 
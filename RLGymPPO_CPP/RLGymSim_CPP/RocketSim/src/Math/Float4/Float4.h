@@ -0,0 +1,196 @@
+#pragma once
+#include "../../BaseInc.h"
+
+// 4 floats that are operated on together (one "lane" each)
+// Uses SSE whenever Bullet does, otherwise falls back to plain loops
+//
+// Every operation does the same float math as its scalar equivalent, so lane code can match scalar code exactly
+// as long as it does the operations in the same order (this is also why there are no FMA or reciprocal approximations)
+
+#if defined(BT_USE_SSE) && !defined(RS_NO_SIMD)
+#define RS_FLOAT4_SSE
+#endif
+
+RS_NS_START
+
+struct Bool4 {
+#ifdef RS_FLOAT4_SSE
+	__m128 m;
+
+	Bool4() = default;
+	explicit Bool4(__m128 m) : m(m) {}
+	Bool4(bool a, bool b, bool c, bool d) {
+		m = _mm_castsi128_ps(_mm_set_epi32(-(int)d, -(int)c, -(int)b, -(int)a));
+	}
+
+	int GetBits() const { return _mm_movemask_ps(m); }
+
+	Bool4 operator&(Bool4 other) const { return Bool4(_mm_and_ps(m, other.m)); }
+	Bool4 operator|(Bool4 other) const { return Bool4(_mm_or_ps(m, other.m)); }
+	Bool4 operator!() const { return Bool4(_mm_xor_ps(m, _mm_castsi128_ps(_mm_set1_epi32(-1)))); }
+#else
+	bool m[4];
+
+	Bool4() = default;
+	Bool4(bool a, bool b, bool c, bool d) : m{ a, b, c, d } {}
+
+	int GetBits() const { return m[0] | (m[1] << 1) | (m[2] << 2) | (m[3] << 3); }
+
+	Bool4 operator&(Bool4 other) const { return Bool4(m[0] && other.m[0], m[1] && other.m[1], m[2] && other.m[2], m[3] && other.m[3]); }
+	Bool4 operator|(Bool4 other) const { return Bool4(m[0] || other.m[0], m[1] || other.m[1], m[2] || other.m[2], m[3] || other.m[3]); }
+	Bool4 operator!() const { return Bool4(!m[0], !m[1], !m[2], !m[3]); }
+#endif
+
+	bool operator[](int i) const { return (GetBits() >> i) & 1; }
+	bool Any() const { return GetBits() != 0; }
+	bool All() const { return GetBits() == 0b1111; }
+};
+
+struct Float4 {
+#ifdef RS_FLOAT4_SSE
+	__m128 v;
+
+	Float4() = default;
+	explicit Float4(__m128 v) : v(v) {}
+	Float4(float val) : v(_mm_set1_ps(val)) {}
+	Float4(float a, float b, float c, float d) : v(_mm_setr_ps(a, b, c, d)) {}
+
+	void Store(float* out) const { _mm_storeu_ps(out, v); }
+
+	Float4 operator+(Float4 other) const { return Float4(_mm_add_ps(v, other.v)); }
+	Float4 operator-(Float4 other) const { return Float4(_mm_sub_ps(v, other.v)); }
+	Float4 operator*(Float4 other) const { return Float4(_mm_mul_ps(v, other.v)); }
+	Float4 operator/(Float4 other) const { return Float4(_mm_div_ps(v, other.v)); }
+	Float4 operator-() const { return Float4(_mm_xor_ps(v, _mm_set1_ps(-0.f))); }
+
+	Bool4 operator<(Float4 other) const { return Bool4(_mm_cmplt_ps(v, other.v)); }
+	Bool4 operator<=(Float4 other) const { return Bool4(_mm_cmple_ps(v, other.v)); }
+	Bool4 operator>(Float4 other) const { return Bool4(_mm_cmpgt_ps(v, other.v)); }
+	Bool4 operator>=(Float4 other) const { return Bool4(_mm_cmpge_ps(v, other.v)); }
+	Bool4 operator==(Float4 other) const { return Bool4(_mm_cmpeq_ps(v, other.v)); }
+	Bool4 operator!=(Float4 other) const { return Bool4(_mm_cmpneq_ps(v, other.v)); }
+
+	// Same as RS_MIN()/RS_MAX(), including which one is returned for NAN
+	friend Float4 Min(Float4 a, Float4 b) { return Float4(_mm_min_ps(a.v, b.v)); }
+	friend Float4 Max(Float4 a, Float4 b) { return Float4(_mm_max_ps(a.v, b.v)); }
+
+	friend Float4 Abs(Float4 a) { return Float4(_mm_andnot_ps(_mm_set1_ps(-0.f), a.v)); }
+	friend Float4 Sqrt(Float4 a) { return Float4(_mm_sqrt_ps(a.v)); }
+
+	// Lanes of ifTrue where mask is set, otherwise lanes of ifFalse
+	friend Float4 Select(Bool4 mask, Float4 ifTrue, Float4 ifFalse) {
+		return Float4(_mm_or_ps(_mm_and_ps(mask.m, ifTrue.v), _mm_andnot_ps(mask.m, ifFalse.v)));
+	}
+#else
+	float v[4];
+
+	Float4() = default;
+	Float4(float val) : v{ val, val, val, val } {}
+	Float4(float a, float b, float c, float d) : v{ a, b, c, d } {}
+
+	void Store(float* out) const { memcpy(out, v, sizeof(v)); }
+
+#define RS_FLOAT4_OP(op) \
+	Float4 operator op(Float4 other) const { return Float4(v[0] op other.v[0], v[1] op other.v[1], v[2] op other.v[2], v[3] op other.v[3]); }
+	RS_FLOAT4_OP(+) RS_FLOAT4_OP(-) RS_FLOAT4_OP(*) RS_FLOAT4_OP(/)
+#undef RS_FLOAT4_OP
+
+#define RS_FLOAT4_CMP(op) \
+	Bool4 operator op(Float4 other) const { return Bool4(v[0] op other.v[0], v[1] op other.v[1], v[2] op other.v[2], v[3] op other.v[3]); }
+	RS_FLOAT4_CMP(<) RS_FLOAT4_CMP(<=) RS_FLOAT4_CMP(>) RS_FLOAT4_CMP(>=) RS_FLOAT4_CMP(==) RS_FLOAT4_CMP(!=)
+#undef RS_FLOAT4_CMP
+
+	Float4 operator-() const { return Float4(-v[0], -v[1], -v[2], -v[3]); }
+
+	friend Float4 Min(Float4 a, Float4 b) {
+		return Float4(RS_MIN(a.v[0], b.v[0]), RS_MIN(a.v[1], b.v[1]), RS_MIN(a.v[2], b.v[2]), RS_MIN(a.v[3], b.v[3]));
+	}
+	friend Float4 Max(Float4 a, Float4 b) {
+		return Float4(RS_MAX(a.v[0], b.v[0]), RS_MAX(a.v[1], b.v[1]), RS_MAX(a.v[2], b.v[2]), RS_MAX(a.v[3], b.v[3]));
+	}
+
+	friend Float4 Abs(Float4 a) { return Float4(abs(a.v[0]), abs(a.v[1]), abs(a.v[2]), abs(a.v[3])); }
+	friend Float4 Sqrt(Float4 a) { return Float4(sqrtf(a.v[0]), sqrtf(a.v[1]), sqrtf(a.v[2]), sqrtf(a.v[3])); }
+
+	friend Float4 Select(Bool4 mask, Float4 ifTrue, Float4 ifFalse) {
+		Float4 result;
+		for (int i = 0; i < 4; i++)
+			result.v[i] = mask.m[i] ? ifTrue.v[i] : ifFalse.v[i];
+		return result;
+	}
+#endif
+
+	float operator[](int i) const {
+		float vals[4];
+		Store(vals);
+		return vals[i];
+	}
+
+	// Same as std::clamp(), including for NAN
+	friend Float4 Clamp(Float4 val, Float4 min, Float4 max) {
+		return Select(val < min, min, Select(max < val, max, val));
+	}
+};
+
+// 4 vectors as structure-of-arrays
+// Dot() and Cross() add in the same order as btVector3
+struct Vec3x4 {
+	Float4 x, y, z;
+
+	Vec3x4() = default;
+	Vec3x4(Float4 x, Float4 y, Float4 z) : x(x), y(y), z(z) {}
+
+	// Same vector in every lane
+	Vec3x4(const btVector3& vec) : x(vec.x()), y(vec.y()), z(vec.z()) {}
+
+	Vec3x4(const btVector3& a, const btVector3& b, const btVector3& c, const btVector3& d) :
+		x(a.x(), b.x(), c.x(), d.x()),
+		y(a.y(), b.y(), c.y(), d.y()),
+		z(a.z(), b.z(), c.z(), d.z()) {
+	}
+
+	void Store(btVector3 out[4]) const {
+		float xs[4], ys[4], zs[4];
+		x.Store(xs);
+		y.Store(ys);
+		z.Store(zs);
+		for (int i = 0; i < 4; i++)
+			out[i].setValue(xs[i], ys[i], zs[i]);
+	}
+
+	Vec3x4 operator+(const Vec3x4& other) const { return Vec3x4(x + other.x, y + other.y, z + other.z); }
+	Vec3x4 operator-(const Vec3x4& other) const { return Vec3x4(x - other.x, y - other.y, z - other.z); }
+	Vec3x4 operator*(Float4 scale) const { return Vec3x4(x * scale, y * scale, z * scale); }
+	Vec3x4 operator*(const Vec3x4& other) const { return Vec3x4(x * other.x, y * other.y, z * other.z); }
+	Vec3x4 operator-() const { return Vec3x4(-x, -y, -z); }
+
+	Float4 Dot(const Vec3x4& other) const {
+		return x * other.x + y * other.y + z * other.z;
+	}
+
+	Float4 Length2() const {
+		return Dot(*this);
+	}
+
+	Vec3x4 Cross(const Vec3x4& other) const {
+		return Vec3x4(
+			y * other.z - z * other.y,
+			z * other.x - x * other.z,
+			x * other.y - y * other.x
+		);
+	}
+
+	// Same as btVector3::safeNormalized()
+	Vec3x4 SafeNormalized() const {
+		Float4 l2 = Length2();
+		Bool4 valid = l2 >= Float4(SIMD_EPSILON * SIMD_EPSILON);
+		Vec3x4 normalized = *this * (Float4(1) / Sqrt(l2));
+		return Select(valid, normalized, Vec3x4(Float4(1), Float4(0), Float4(0)));
+	}
+
+	friend Vec3x4 Select(Bool4 mask, const Vec3x4& ifTrue, const Vec3x4& ifFalse) {
+		return Vec3x4(Select(mask, ifTrue.x, ifFalse.x), Select(mask, ifTrue.y, ifFalse.y), Select(mask, ifTrue.z, ifFalse.z));
+	}
+};
+
+RS_NS_END
@@ -2,7 +2,45 @@
 
 RS_NS_START
 
+void LinearPieceCurve::Compile() {
+	if (valueMappings.empty() || valueMappings.size() > MAX_COMPILED_POINTS) {
+		_compiledPointAmount = 0;
+		return;
+	}
+
+	_compiledPointAmount = 0;
+	for (auto& pair : valueMappings) {
+		int i = _compiledPointAmount++;
+		_inputs[i] = pair.first;
+		_outputs[i] = pair.second;
+		if (i > 0) {
+			_inputRanges[i] = _inputs[i] - _inputs[i - 1];
+			_outputDiffs[i] = _outputs[i] - _outputs[i - 1];
+		}
+	}
+}
+
 float LinearPieceCurve::GetOutput(float input, float defaultOutput) const {
+	if (_compiledPointAmount == 0)
+		return _GetOutputFromMappings(input, defaultOutput);
+
+	if (input <= _inputs[0])
+		return _outputs[0];
+
+	// Index of the first point after the input, or the point count if there is none
+	// Inputs are sorted, so this is just a count (written as !(a > b) so NaN ends up past the last point, like the map walk)
+	int after = 1;
+	for (int i = 1; i < _compiledPointAmount; i++)
+		after += !(_inputs[i] > input);
+
+	if (after == _compiledPointAmount)
+		return _outputs[_compiledPointAmount - 1];
+
+	float linearInterpFactor = (input - _inputs[after - 1]) / _inputRanges[after];
+	return _outputs[after - 1] + _outputDiffs[after] * linearInterpFactor;
+}
+
+float LinearPieceCurve::_GetOutputFromMappings(float input, float defaultOutput) const {
 	float output = input;
 
 	if (!valueMappings.empty()) {
@@ -4,9 +4,42 @@
 RS_NS_START
 
 struct LinearPieceCurve {
-	std::map<float, float> valueMappings;
+	// Curves with up to this many points are compiled into flat arrays, instead of walking the map on every call
+	constexpr static int MAX_COMPILED_POINTS = 8;
+
+	// Points from valueMappings, or 0 if not compiled
+	int _compiledPointAmount = 0;
+	float _inputs[MAX_COMPILED_POINTS], _outputs[MAX_COMPILED_POINTS];
+
+	// Differences from the previous point, precomputed exactly like GetOutput() used to compute them
+	float _inputRanges[MAX_COMPILED_POINTS], _outputDiffs[MAX_COMPILED_POINTS];
+
+	LinearPieceCurve() = default;
+	LinearPieceCurve(const std::map<float, float>& valueMappings) : valueMappings(valueMappings) {
+		Compile();
+	}
+
+	const std::map<float, float>& GetValueMappings() const {
+		return valueMappings;
+	}
 
+	// Recompiles the curve, so GetOutput() never uses outdated points
+	void SetValueMappings(const std::map<float, float>& newValueMappings) {
+		valueMappings = newValueMappings;
+		Compile();
+	}
+
+	// Gives the same results as _GetOutputFromMappings()
 	RSAPI float GetOutput(float input, float defaultOutput = 1) const;
+
+	// Walks valueMappings directly
+	RSAPI float _GetOutputFromMappings(float input, float defaultOutput = 1) const;
+
+private:
+	// Only changed through SetValueMappings(), as the compiled arrays must match it
+	std::map<float, float> valueMappings;
+
+	RSAPI void Compile();
 };
 
 namespace Math {
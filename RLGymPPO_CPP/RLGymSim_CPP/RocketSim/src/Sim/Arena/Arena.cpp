@@ -46,8 +46,39 @@ RSAPI void Arena::SetMutatorConfig(const MutatorConfig& mutatorConfig) {
 	ball->_rigidBody.setDamping(mutatorConfig.ballDrag, 0);
 }
 
+Car* Arena::_AllocateCarSlot() {
+	if (_freeCarSlots.empty()) {
+		_CarSlotBlock* block = new _CarSlotBlock();
+		_carSlotBlocks.push_back(block);
+
+		// Reversed so slots are used in order
+		for (int i = CAR_SLOTS_PER_BLOCK - 1; i >= 0; i--)
+			_freeCarSlots.push_back(block->GetSlot(i));
+	}
+
+	Car* slot = _freeCarSlots.back();
+	_freeCarSlots.pop_back();
+	return Car::_ConstructCarAt(slot);
+}
+
+bool Arena::_IsInCarSlot(const Car* car) const {
+	for (_CarSlotBlock* block : _carSlotBlocks)
+		if ((const byte*)car >= block->data && (const byte*)car < block->data + sizeof(block->data))
+			return true;
+	return false;
+}
+
+void Arena::_FreeCar(Car* car) {
+	if (_IsInCarSlot(car)) {
+		car->~Car();
+		_freeCarSlots.push_back(car);
+	} else {
+		delete car;
+	}
+}
+
 Car* Arena::AddCar(Team team, const CarConfig& config) {
-	Car* car = Car::_AllocateCar();
+	Car* car = _NewCar();
 	
 	car->config = config;
 	car->team = team;
@@ -65,10 +96,10 @@ bool Arena::_AddCarFromPtr(Car* car) {
 	car->id = ++_lastCarID;
 
 	if (_carIDMap.find(car->id) == _carIDMap.end()) {
-		assert(!_cars.count(car));
+		assert(std::find(_cars.begin(), _cars.end(), car) == _cars.end());
 		
 		_carIDMap[car->id] = car;
-		_cars.insert(car);
+		_cars.push_back(car);
 		return true;
 
 	} else {
@@ -82,10 +113,10 @@ bool Arena::RemoveCar(uint32_t id) {
 	if (itr != _carIDMap.end()) {
 		Car* car = itr->second;
 		_carIDMap.erase(itr);
-		_cars.erase(car);
+		_cars.erase(std::find(_cars.begin(), _cars.end(), car));
 		_bulletWorld.removeCollisionObject(&car->_rigidBody);
 		if (ownsCars)
-			delete car;
+			_FreeCar(car);
 		return true;
 	} else {
 		return false;
@@ -93,7 +124,8 @@ bool Arena::RemoveCar(uint32_t id) {
 }
 
 Car* Arena::GetCar(uint32_t id) {
-	return _carIDMap[id];
+	auto itr = _carIDMap.find(id);
+	return (itr != _carIDMap.end()) ? itr->second : NULL;
 }
 
 void Arena::SetGoalScoreCallback(GoalScoreEventFn callbackFunc, void* userInfo) {
@@ -122,11 +154,13 @@ void Arena::ResetToRandomKickoff(int seed) {
 
 	auto kickoffOrder = KICKOFF_ORDER_TEMPLATE;
 
+	std::default_random_engine seededEngine;
 	std::default_random_engine* randEngine;
 	if (seed == -1) {
 		randEngine = &Math::GetRandEngine();
 	} else {
-		randEngine = new std::default_random_engine(seed);
+		seededEngine = std::default_random_engine(seed);
+		randEngine = &seededEngine;
 	}
 
 	int locationAmount = (gameMode == GameMode::HEATSEEKER) ? CAR_SPAWN_LOCATION_AMOUNT_HEATSEEKER : CAR_SPAWN_LOCATION_AMOUNT;
@@ -208,11 +242,6 @@ void Arena::ResetToRandomKickoff(int seed) {
 
 	for (BoostPad* boostPad : _boostPads)
 		boostPad->SetState(BoostPadState());
-
-	if (seed != -1) {
-		// Custom random engine was created for this seed, so we need to free it
-		delete randEngine;
-	}
 }
 
 bool Arena::_BulletContactAddedCallback(
@@ -628,12 +657,10 @@ Arena* Arena::DeserializeNew(DataStreamIn& in) {
 				RS_ERR_CLOSE(ERROR_PREFIX << "Failed to load, got repeated car ID of " << id);
 #endif
 
-			Car* newCar = newArena->DeserializeNewCar(in, team);
-
-			// Force ID
-			newArena->_carIDMap.erase(newCar->id);
-			newArena->_carIDMap[id] = newCar;
-			newCar->id = id;
+			// Make the car get its saved ID
+			// Forcing the ID afterwards would break adding cars whose auto-assigned ID is already taken
+			newArena->_lastCarID = id - 1;
+			newArena->DeserializeNewCar(in, team);
 		}
 
 		newArena->_lastCarID = lastCarID;
@@ -682,10 +709,11 @@ Arena* Arena::Clone(bool copyCallbacks) {
 	newArena->ball->_velocityImpulseCache = this->ball->_velocityImpulseCache;
 
 	for (Car* car : this->_cars) {
+		// Same ID, so it's also found by GetCar()
+		newArena->_lastCarID = car->id - 1;
 		Car* newCar = newArena->AddCar(car->team, car->config);
 		
 		newCar->SetState(car->GetState());
-		newCar->id = car->id;
 		newCar->controls = car->controls;
 		newCar->_velocityImpulseCache = car->_velocityImpulseCache;
 	}
@@ -700,8 +728,157 @@ Arena* Arena::Clone(bool copyCallbacks) {
 	return newArena;
 }
 
+int Arena::_GetCarSnapshotIndex(const Car* car) {
+	// Car sets are tiny, so this is faster than sorting them into a list
+	int index = 0;
+	for (Car* otherCar : _cars)
+		if (otherCar->id < car->id)
+			index++;
+	return index;
+}
+
+int Arena::_GetSnapshotBodyIndex(const btCollisionObject* obj) {
+	int userIndex = obj->getUserIndex();
+	if (userIndex == BT_USERINFO_TYPE_BALL)
+		return 0;
+
+	if (userIndex == BT_USERINFO_TYPE_CAR)
+		return 1 + _GetCarSnapshotIndex((Car*)obj->getUserPointer());
+
+	if (_worldCollisionRBAmount > 0 && obj >= _worldCollisionRBs && obj < _worldCollisionRBs + _worldCollisionRBAmount)
+		return 1 + (int)_cars.size() + (int)((const btRigidBody*)obj - _worldCollisionRBs);
+
+	return -1;
+}
+
+void Arena::SaveSnapshot(ArenaSnapshot& snapshot) {
+	snapshot.tickCount = tickCount;
+
+	{ // Ball
+		BallSnapshot& ballSnapshot = snapshot.ball;
+		ballSnapshot.state = ball->_internalState;
+		ballSnapshot.velocityImpulseCache = ball->_velocityImpulseCache;
+		ballSnapshot.groundStickApplied = ball->_groundStickApplied;
+		ballSnapshot.rb.Save(ball->_rigidBody);
+	}
+
+	snapshot.cars.resize(_cars.size());
+	for (Car* car : _cars) {
+		CarSnapshot& carSnapshot = snapshot.cars[_GetCarSnapshotIndex(car)];
+		carSnapshot.id = car->id;
+		carSnapshot.state = car->_internalState;
+		carSnapshot.controls = car->controls;
+		carSnapshot.velocityImpulseCache = car->_velocityImpulseCache;
+		carSnapshot.rb.Save(car->_rigidBody);
+		for (int i = 0; i < 4; i++)
+			carSnapshot.wheels[i] = car->_bulletVehicle.m_wheelInfo[i];
+	}
+
+	snapshot.boostPads.resize(_boostPads.size());
+	snapshot.boostPadLockedCarIndices.resize(_boostPads.size());
+	for (int i = 0; i < _boostPads.size(); i++) {
+		const BoostPadState& padState = _boostPads[i]->_internalState;
+		snapshot.boostPads[i] = padState;
+		snapshot.boostPadLockedCarIndices[i] = padState.curLockedCar ? _GetCarSnapshotIndex(padState.curLockedCar) : -1;
+	}
+
+	snapshot.manifolds.clear();
+	btCollisionDispatcher& dispatcher = _bulletWorldParams.collisionDispatcher;
+	for (int i = 0; i < dispatcher.getNumManifolds(); i++) {
+		btPersistentManifold* manifold = dispatcher.getManifoldByIndexInternal(i);
+		if (manifold->getNumContacts() == 0)
+			continue;
+
+		int bodyIndexA = _GetSnapshotBodyIndex(manifold->getBody0());
+		int bodyIndexB = _GetSnapshotBodyIndex(manifold->getBody1());
+		if (bodyIndexA == -1 || bodyIndexB == -1)
+			continue;
+
+		snapshot.manifolds.emplace_back();
+		ContactManifoldSnapshot& manifoldSnapshot = snapshot.manifolds.back();
+		manifoldSnapshot.bodyIndexA = bodyIndexA;
+		manifoldSnapshot.bodyIndexB = bodyIndexB;
+		manifoldSnapshot.pointAmount = manifold->getNumContacts();
+		for (int j = 0; j < manifoldSnapshot.pointAmount; j++)
+			manifoldSnapshot.points[j] = manifold->getContactPoint(j);
+	}
+}
+
+void Arena::RestoreSnapshot(const ArenaSnapshot& snapshot) {
+	constexpr char ERROR_PREFIX[] = "Arena::RestoreSnapshot(): ";
+
+	if (snapshot.cars.size() != _cars.size() || snapshot.boostPads.size() != _boostPads.size()) {
+		RS_ERR_CLOSE(
+			ERROR_PREFIX << "Snapshot is from an arena with different objects " <<
+			"(cars: " << snapshot.cars.size() << "/" << _cars.size() << ", boost pads: " << snapshot.boostPads.size() << "/" << _boostPads.size() << ")"
+		);
+	}
+
+	tickCount = snapshot.tickCount;
+
+	{ // Ball
+		const BallSnapshot& ballSnapshot = snapshot.ball;
+		ball->_internalState = ballSnapshot.state;
+		ball->_velocityImpulseCache = ballSnapshot.velocityImpulseCache;
+		ball->_groundStickApplied = ballSnapshot.groundStickApplied;
+		ballSnapshot.rb.Restore(ball->_rigidBody);
+	}
+
+	for (Car* car : _cars) {
+		const CarSnapshot& carSnapshot = snapshot.cars[_GetCarSnapshotIndex(car)];
+		if (carSnapshot.id != car->id)
+			RS_ERR_CLOSE(ERROR_PREFIX << "Snapshot has no car with ID " << car->id << " (found ID " << carSnapshot.id << " in its place)");
+
+		car->_internalState = carSnapshot.state;
+		car->controls = carSnapshot.controls;
+		car->_velocityImpulseCache = carSnapshot.velocityImpulseCache;
+		carSnapshot.rb.Restore(car->_rigidBody);
+		for (int i = 0; i < 4; i++) {
+			car->_bulletVehicle.m_wheelInfo[i] = carSnapshot.wheels[i];
+
+			// Only valid within a tick, and may point into the other arena
+			car->_bulletVehicle.m_wheelInfo[i].m_raycastInfo.m_groundObject = NULL;
+		}
+	}
+
+	// Suspension raycasts happen before Bullet updates the broadphase, so it needs to know where everything is now
+	_bulletWorld.updateSingleAabb(&ball->_rigidBody);
+	for (Car* car : _cars)
+		_bulletWorld.updateSingleAabb(&car->_rigidBody);
+
+	for (int i = 0; i < _boostPads.size(); i++) {
+		BoostPadState padState = snapshot.boostPads[i];
+		int lockedCarIndex = snapshot.boostPadLockedCarIndices[i];
+		padState.curLockedCar = (lockedCarIndex != -1) ? GetCar(snapshot.cars[lockedCarIndex].id) : NULL;
+		_boostPads[i]->_internalState = padState;
+	}
+
+	// Replace our contact points with the saved ones
+	// Pairs that aren't overlapping in the broadphase right now have no manifold to restore into, they will start without contacts
+	btCollisionDispatcher& dispatcher = _bulletWorldParams.collisionDispatcher;
+	for (int i = 0; i < dispatcher.getNumManifolds(); i++) {
+		btPersistentManifold* manifold = dispatcher.getManifoldByIndexInternal(i);
+		manifold->clearManifold();
+
+		int bodyIndexA = _GetSnapshotBodyIndex(manifold->getBody0());
+		int bodyIndexB = _GetSnapshotBodyIndex(manifold->getBody1());
+		for (auto& manifoldSnapshot : snapshot.manifolds) {
+			if (manifoldSnapshot.bodyIndexA != bodyIndexA || manifoldSnapshot.bodyIndexB != bodyIndexB)
+				continue;
+
+			manifold->setNumContacts(manifoldSnapshot.pointAmount);
+			for (int j = 0; j < manifoldSnapshot.pointAmount; j++) {
+				btManifoldPoint& point = manifold->getContactPoint(j);
+				point = manifoldSnapshot.points[j];
+				point.m_userPersistentData = NULL;
+			}
+			break;
+		}
+	}
+}
+
 Car* Arena::DeserializeNewCar(DataStreamIn& in, Team team) {
-	Car* car = Car::_AllocateCar();
+	Car* car = _NewCar();
 	car->_Deserialize(in);
 	car->team = team;
 
@@ -986,10 +1163,13 @@ Arena::~Arena() {
 		_bulletWorld.removeCollisionObject(_bulletWorld.getCollisionObjectArray()[0]);
 
 	// Remove all cars
-	if (ownsCars) {
-		for (Car* car : _cars)
-			delete car;
-	}
+	// Cars in our slots (made before ownsCars was cleared) can't outlive the slots, so they go too
+	for (Car* car : _cars)
+		if (ownsCars || _IsInCarSlot(car))
+			_FreeCar(car);
+
+	for (_CarSlotBlock* block : _carSlotBlocks)
+		delete block;
 
 	// Remove the ball
 	if (ownsBall) {
@@ -10,6 +10,7 @@
 #include "../SuspensionCollisionGrid/SuspensionCollisionGrid.h"
 #include "../MutatorConfig/MutatorConfig.h"
 #include "ArenaConfig/ArenaConfig.h"
+#include "ArenaSnapshot/ArenaSnapshot.h"
 
 #include "../../../libsrc/bullet3-3.24/BulletCollision/BroadphaseCollision/btDbvtBroadphase.h"
 #include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btStaticPlaneShape.h"
@@ -32,10 +33,39 @@ public:
 	GameMode gameMode;
 
 	uint32_t _lastCarID = 0;
-	std::unordered_set<Car*> _cars;
-	bool ownsCars = true; // If true, deleting this arena instance deletes all cars
+
+	// All cars in the order they were added
+	std::vector<Car*> _cars;
+	// If true, deleting this arena instance deletes all cars
+	// If false, each car gets its own heap allocation so you can delete it yourself (only change this before adding cars)
+	bool ownsCars = true;
 
 	std::unordered_map<uint32_t, Car*> _carIDMap;
+
+	// Cars made by an arena that owns them are constructed in blocks of contiguous slots, instead of each having its own heap allocation
+	// Slots never move, as Bullet keeps pointers to each car's rigid body
+	constexpr static int CAR_SLOTS_PER_BLOCK = 8;
+	struct _CarSlotBlock {
+		alignas(Car) byte data[sizeof(Car) * CAR_SLOTS_PER_BLOCK];
+
+		Car* GetSlot(int index) {
+			return (Car*)(data + sizeof(Car) * index);
+		}
+	};
+	std::vector<_CarSlotBlock*> _carSlotBlocks;
+	std::vector<Car*> _freeCarSlots;
+
+	// Constructs a new car in a free slot
+	Car* _AllocateCarSlot();
+
+	// Constructs a new car in a slot if we own our cars, otherwise on its own
+	Car* _NewCar() {
+		return ownsCars ? _AllocateCarSlot() : Car::_AllocateCar();
+	}
+
+	// Destroys a car, returning its slot if it has one
+	void _FreeCar(Car* car);
+	bool _IsInCarSlot(const Car* car) const;
 	
 	Ball* ball;
 	bool ownsBall = true; // If true, deleting this arena instance deletes the ball
@@ -63,7 +93,7 @@ public:
 	// Total ticks this arena instance has been simulated for, never resets
 	uint64_t tickCount = 0;
 
-	const std::unordered_set<Car*>& GetCars() { return _cars; }
+	const std::vector<Car*>& GetCars() { return _cars; }
 	const std::vector<BoostPad*>& GetBoostPads() { return _boostPads; }
 
 	// Returns true if added, false if car was already added
@@ -125,6 +155,24 @@ public:
 	// Get a deep copy of the arena
 	RSAPI Arena* Clone(bool copyCallbacks);
 
+	// Copy everything that changes while simulating (cars, ball, boost pads, tick count, and contact caches) into a snapshot
+	// Saving into the same snapshot again doesn't allocate once it's big enough
+	RSAPI void SaveSnapshot(ArenaSnapshot& snapshot);
+
+	// Restore a snapshot of this arena, or of an arena with the same cars (same IDs, teams, and configs)
+	// Unlike Clone() or DeserializeNew(), nothing is allocated, so this is cheap enough for rollbacks
+	// Callbacks, mutators, and car IDs are not changed
+	// Restoring into the arena the snapshot came from continues exactly like the original did
+	// In another arena, touching bodies can end up slightly different, as Bullet's collision pair order depends on its history
+	RSAPI void RestoreSnapshot(const ArenaSnapshot& snapshot);
+
+	// Index of a collision object that is the same across arenas with the same cars, -1 if not snapshotted
+	// Ball is 0, then cars by ID, then world collision bodies
+	int _GetSnapshotBodyIndex(const btCollisionObject* obj);
+
+	// Index of the car among all cars, sorted by ID
+	int _GetCarSnapshotIndex(const Car* car);
+
 	// NOTE: Car ID will not be restored
 	RSAPI Car* DeserializeNewCar(DataStreamIn& in, Team team);
 
@@ -0,0 +1,46 @@
+#include "ArenaSnapshot.h"
+
+RS_NS_START
+
+void RigidBodySnapshot::Save(const btRigidBody& rb) {
+	worldTransform = rb.getWorldTransform();
+	interpolationWorldTransform = rb.m_interpolationWorldTransform;
+	interpolationLinearVelocity = rb.m_interpolationLinearVelocity;
+	interpolationAngularVelocity = rb.m_interpolationAngularVelocity;
+	linearVelocity = rb.m_linearVelocity;
+	angularVelocity = rb.m_angularVelocity;
+	invInertiaTensorWorld = rb.m_invInertiaTensorWorld;
+	totalForce = rb.m_totalForce;
+	totalTorque = rb.m_totalTorque;
+	deltaLinearVelocity = rb.m_deltaLinearVelocity;
+	deltaAngularVelocity = rb.m_deltaAngularVelocity;
+	pushVelocity = rb.m_pushVelocity;
+	turnVelocity = rb.m_turnVelocity;
+	collisionFlags = rb.m_collisionFlags;
+	activationState = rb.m_activationState1;
+	deactivationTime = rb.m_deactivationTime;
+	hitFraction = rb.m_hitFraction;
+}
+
+void RigidBodySnapshot::Restore(btRigidBody& rb) const {
+	rb.getWorldTransform() = worldTransform;
+	rb.m_interpolationWorldTransform = interpolationWorldTransform;
+	rb.m_interpolationLinearVelocity = interpolationLinearVelocity;
+	rb.m_interpolationAngularVelocity = interpolationAngularVelocity;
+	rb.m_linearVelocity = linearVelocity;
+	rb.m_angularVelocity = angularVelocity;
+	rb.m_invInertiaTensorWorld = invInertiaTensorWorld;
+	rb.m_totalForce = totalForce;
+	rb.m_totalTorque = totalTorque;
+	rb.m_deltaLinearVelocity = deltaLinearVelocity;
+	rb.m_deltaAngularVelocity = deltaAngularVelocity;
+	rb.m_pushVelocity = pushVelocity;
+	rb.m_turnVelocity = turnVelocity;
+	rb.m_collisionFlags = collisionFlags;
+	rb.m_activationState1 = activationState;
+	rb.m_deactivationTime = deactivationTime;
+	rb.m_hitFraction = hitFraction;
+	rb.m_updateRevision++;
+}
+
+RS_NS_END
@@ -0,0 +1,65 @@
+#pragma once
+#include "../../Car/Car.h"
+#include "../../Ball/Ball.h"
+#include "../../BoostPad/BoostPad.h"
+
+#include "../../../../libsrc/bullet3-3.24/BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+
+RS_NS_START
+
+// Dynamic state of a rigid body (everything that changes while simulating)
+struct RigidBodySnapshot {
+	btTransform worldTransform, interpolationWorldTransform;
+	btVector3 interpolationLinearVelocity, interpolationAngularVelocity;
+	btVector3 linearVelocity, angularVelocity;
+	btMatrix3x3 invInertiaTensorWorld;
+	btVector3 totalForce, totalTorque;
+	btVector3 deltaLinearVelocity, deltaAngularVelocity, pushVelocity, turnVelocity;
+	int collisionFlags, activationState;
+	float deactivationTime, hitFraction;
+
+	void Save(const btRigidBody& rb);
+	void Restore(btRigidBody& rb) const;
+};
+
+struct CarSnapshot {
+	uint32_t id;
+	CarState state;
+	CarControls controls;
+	Vec velocityImpulseCache;
+	RigidBodySnapshot rb;
+
+	// Suspension, wheel spin, friction, etc. from the last tick
+	btWheelInfoRL wheels[4];
+};
+
+struct BallSnapshot {
+	BallState state;
+	Vec velocityImpulseCache;
+	bool groundStickApplied;
+	RigidBodySnapshot rb;
+};
+
+// Contact points between two bodies, kept by Bullet between ticks for warm starting
+struct ContactManifoldSnapshot {
+	// See Arena::_GetSnapshotBodyIndex()
+	int bodyIndexA, bodyIndexB;
+
+	int pointAmount;
+	btManifoldPoint points[MANIFOLD_CACHE_SIZE];
+};
+
+// Everything that changes while simulating an arena, see Arena::SaveSnapshot()
+// Saving into the same snapshot again reuses its memory
+struct ArenaSnapshot {
+	uint64_t tickCount;
+
+	BallSnapshot ball;
+	std::vector<CarSnapshot> cars; // Sorted by ID
+	std::vector<BoostPadState> boostPads;
+	std::vector<int> boostPadLockedCarIndices; // Index into cars of each pad's curLockedCar, -1 if none
+
+	std::vector<ContactManifoldSnapshot> manifolds;
+};
+
+RS_NS_END
@@ -0,0 +1,141 @@
+#include "BallPredBatch.h"
+
+RS_NS_START
+
+BallPredBatch::BallPredBatch(Arena* templateArena, size_t numPredTicks, int threadAmount) : numPredTicks(numPredTicks) {
+	if (numPredTicks == 0)
+		RS_ERR_CLOSE("BallPredBatch::BallPredBatch(): numPredTicks must be above 0");
+
+	if (threadAmount <= 0)
+		threadAmount = RS_MAX((int)std::thread::hardware_concurrency(), 1);
+
+	_workers.resize(threadAmount);
+	for (_Worker& worker : _workers) {
+		worker.arena = Arena::Create(templateArena->gameMode, templateArena->GetArenaConfig(), templateArena->GetTickRate());
+		worker.arena->SetMutatorConfig(templateArena->GetMutatorConfig());
+		worker.arena->SaveSnapshot(worker.cleanSnapshot);
+	}
+
+	for (int i = 1; i < threadAmount; i++)
+		_threads.push_back(std::thread(&BallPredBatch::_RunThread, this, i));
+}
+
+BallPredBatch::~BallPredBatch() {
+	{
+		std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>(_mutex);
+		_stop = true;
+	}
+	_jobStartCondition.notify_all();
+
+	for (auto& thread : _threads)
+		thread.join();
+
+	for (_Worker& worker : _workers)
+		delete worker.arena;
+}
+
+void BallPredBatch::Predict(Arena* const* arenas, size_t arenaAmount, BallState* out) {
+	if (_slots.size() != arenaAmount) {
+		_slots.clear();
+		_slots.resize(arenaAmount);
+	}
+
+	_jobArenas = arenas;
+	_jobOut = out;
+	_jobArenaAmount = arenaAmount;
+	_jobNextIndex = 0;
+
+	if (_threads.empty()) {
+		_RunJob(_workers[0]);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>(_mutex);
+		_jobID++;
+		_jobRunningThreads = _threads.size();
+	}
+	_jobStartCondition.notify_all();
+
+	_RunJob(_workers[0]);
+
+	std::unique_lock<std::mutex> lock = std::unique_lock<std::mutex>(_mutex);
+	_jobDoneCondition.wait(lock, [this] { return _jobRunningThreads == 0; });
+}
+
+void BallPredBatch::Reset() {
+	_slots.clear();
+}
+
+void BallPredBatch::_RunThread(int workerIndex) {
+	uint64_t lastJobID = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock = std::unique_lock<std::mutex>(_mutex);
+			_jobStartCondition.wait(lock, [this, lastJobID] { return _stop || _jobID != lastJobID; });
+			if (_stop)
+				return;
+			lastJobID = _jobID;
+		}
+
+		_RunJob(_workers[workerIndex]);
+
+		bool lastDone;
+		{
+			std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>(_mutex);
+			lastDone = (--_jobRunningThreads == 0);
+		}
+		if (lastDone)
+			_jobDoneCondition.notify_one();
+	}
+}
+
+void BallPredBatch::_RunJob(_Worker& worker) {
+	while (true) {
+		size_t index = _jobNextIndex.fetch_add(1);
+		if (index >= _jobArenaAmount)
+			break;
+		_PredictBall(worker, index);
+	}
+}
+
+void BallPredBatch::_PredictBall(_Worker& worker, size_t index) {
+	Arena* arena = _jobArenas[index];
+	_Slot& slot = _slots[index];
+	BallState* pred = _jobOut + index * numPredTicks;
+
+	BallState curBallState = arena->ball->GetState();
+
+	// Same reuse rules as BallPredTracker::UpdatePredManual()
+	size_t predStart = 0;
+	if (slot.arena == arena && arena->tickCount >= slot.tickCount) {
+		uint64_t ticksSinceLastUpdate = arena->tickCount - slot.tickCount;
+		if (ticksSinceLastUpdate < numPredTicks && pred[ticksSinceLastUpdate].Matches(curBallState)) {
+			// Move the states that are still in the future to the front
+			std::move(pred + ticksSinceLastUpdate, pred + numPredTicks, pred);
+			predStart = numPredTicks - ticksSinceLastUpdate;
+		}
+	}
+
+	slot.arena = arena;
+	slot.tickCount = arena->tickCount;
+
+	if (predStart == 0) {
+		pred[0] = curBallState;
+		predStart = 1;
+	}
+
+	if (predStart == numPredTicks)
+		return;
+
+	// Contacts from the last ball must not affect this one
+	Arena* predArena = worker.arena;
+	predArena->RestoreSnapshot(worker.cleanSnapshot);
+	predArena->ball->SetState(pred[predStart - 1]);
+	for (size_t i = predStart; i < numPredTicks; i++) {
+		predArena->Step();
+		pred[i] = predArena->ball->GetState();
+	}
+}
+
+RS_NS_END
@@ -0,0 +1,63 @@
+#pragma once
+#include "../Arena/Arena.h"
+
+#include <atomic>
+#include <condition_variable>
+
+RS_NS_START
+
+// Predicts the balls of many arenas at once, like a BallPredTracker for each of them
+// Instead of an extra arena per tracked arena, each thread has one ball-only arena that predicts every ball it is given
+// Prior predictions are reused when the ball is where it was predicted to be
+struct BallPredBatch {
+	size_t numPredTicks;
+
+	// templateArena: Game mode, arena config, mutators, and tick rate of the arenas to predict
+	// threadAmount: Threads to predict with (including the calling thread), 0 to use all cores
+	BallPredBatch(Arena* templateArena, size_t numPredTicks, int threadAmount = 1);
+	~BallPredBatch();
+
+	// No copying
+	BallPredBatch(const BallPredBatch& other) = delete;
+	BallPredBatch& operator=(const BallPredBatch& other) = delete;
+
+	// Predicts the ball of every arena, out[i * numPredTicks + j] is the ball of arenas[i] j ticks from now
+	// out must still have the previous prediction when called again with the same arenas, as it is reused if still valid
+	// The arenas must not be stepped while this runs
+	void Predict(Arena* const* arenas, size_t arenaAmount, BallState* out);
+
+	// Forgets all prior predictions, so the next Predict() re-predicts everything
+	void Reset();
+
+	struct _Worker {
+		Arena* arena;
+		ArenaSnapshot cleanSnapshot; // Ball-only arena without any contacts, restored before each ball
+	};
+	std::vector<_Worker> _workers; // The first one is used by the calling thread
+	std::vector<std::thread> _threads;
+
+	// What each arena looked like when it was last predicted
+	struct _Slot {
+		Arena* arena = NULL;
+		uint64_t tickCount = 0;
+	};
+	std::vector<_Slot> _slots;
+
+	// Current job
+	Arena* const* _jobArenas = NULL;
+	BallState* _jobOut = NULL;
+	size_t _jobArenaAmount = 0;
+	std::atomic<size_t> _jobNextIndex = 0;
+	uint64_t _jobID = 0;
+	int _jobRunningThreads = 0;
+
+	std::mutex _mutex;
+	std::condition_variable _jobStartCondition, _jobDoneCondition;
+	bool _stop = false;
+
+	void _RunThread(int workerIndex);
+	void _RunJob(_Worker& worker);
+	void _PredictBall(_Worker& worker, size_t index);
+};
+
+RS_NS_END
@@ -1,6 +1,7 @@
 #include "Car.h"
 #include "../../RLConst.h"
 #include "../SuspensionCollisionGrid/SuspensionCollisionGrid.h"
+#include "../../Math/Float4/Float4.h"
 
 #include "../../../libsrc/bullet3-3.24/BulletDynamics/Dynamics/btDynamicsWorld.h"
 
@@ -327,6 +328,48 @@ void Car::_Deserialize(DataStreamIn& in) {
 	_internalState = newState;
 }
 
+void Car::_CalcFrictionCurveInputsWheelLanes(float outInputs[4]) {
+	const btWheelInfoRL* wheels = &_bulletVehicle.m_wheelInfo[0];
+
+	Vec3x4
+		vel = _rigidBody.m_linearVelocity,
+		angularVel = _rigidBody.m_angularVelocity;
+
+	Vec3x4
+		latDir = Vec3x4(
+			wheels[0].m_worldTransform.getBasis().getColumn(1),
+			wheels[1].m_worldTransform.getBasis().getColumn(1),
+			wheels[2].m_worldTransform.getBasis().getColumn(1),
+			wheels[3].m_worldTransform.getBasis().getColumn(1)
+		),
+		longDir = latDir.Cross(Vec3x4(
+			wheels[0].m_raycastInfo.m_contactNormalWS,
+			wheels[1].m_raycastInfo.m_contactNormalWS,
+			wheels[2].m_raycastInfo.m_contactNormalWS,
+			wheels[3].m_raycastInfo.m_contactNormalWS
+		));
+
+	Vec3x4 wheelDelta = Vec3x4(
+		wheels[0].m_raycastInfo.m_hardPointWS,
+		wheels[1].m_raycastInfo.m_hardPointWS,
+		wheels[2].m_raycastInfo.m_hardPointWS,
+		wheels[3].m_raycastInfo.m_hardPointWS
+	) - Vec3x4(_rigidBody.getWorldTransform().m_origin);
+
+	Vec3x4 crossVec = (angularVel.Cross(wheelDelta) + vel) * Float4(BT_TO_UU);
+
+	Float4 baseFriction = Abs(crossVec.Dot(latDir));
+
+	// Significant friction results in lateral slip
+	Float4 frictionCurveInput = Select(
+		baseFriction > Float4(5),
+		baseFriction / (Abs(crossVec.Dot(longDir)) + baseFriction),
+		Float4(0)
+	);
+
+	frictionCurveInput.Store(outInputs);
+}
+
 void Car::_UpdateWheels(float tickTime, const MutatorConfig& mutatorConfig, int numWheelsInContact, float forwardSpeed_UU) {
 	using namespace RLConst;
 
@@ -407,9 +450,14 @@ void Car::_UpdateWheels(float tickTime, const MutatorConfig& mutatorConfig, int
 	}
 
 	{ // Update friction
-		for (int i = 0; i < 4; i++) {
-			auto& wheel = _bulletVehicle.m_wheelInfo[i];
-			if (wheel.m_raycastInfo.m_groundObject) {
+		float frictionCurveInputs[4];
+		if (_bulletVehicle.m_useWheelLanes) {
+			_CalcFrictionCurveInputsWheelLanes(frictionCurveInputs);
+		} else {
+			for (int i = 0; i < 4; i++) {
+				auto& wheel = _bulletVehicle.m_wheelInfo[i];
+				if (!wheel.m_raycastInfo.m_groundObject)
+					continue;
 
 				btVector3
 					vel = _rigidBody.m_linearVelocity,
@@ -431,6 +479,15 @@ void Car::_UpdateWheels(float tickTime, const MutatorConfig& mutatorConfig, int
 				if (baseFriction > 5)
 					frictionCurveInput = baseFriction / (abs(crossVec.dot(longDir)) + baseFriction);
 
+				frictionCurveInputs[i] = frictionCurveInput;
+			}
+		}
+
+		for (int i = 0; i < 4; i++) {
+			auto& wheel = _bulletVehicle.m_wheelInfo[i];
+			if (wheel.m_raycastInfo.m_groundObject) {
+				float frictionCurveInput = frictionCurveInputs[i];
+
 				float latFriction = LAT_FRICTION_CURVE.GetOutput(frictionCurveInput);
 				float longFriction = LONG_FRICTION_CURVE.GetOutput(frictionCurveInput);
 
@@ -186,6 +186,7 @@ public:
 	
 	// For construction by Arena
 	static Car* _AllocateCar() { return new Car(); }
+	static Car* _ConstructCarAt(void* memory) { return new (memory) Car(); }
 
 	RSAPI void Serialize(DataStreamOut& out);
 	void _Deserialize(DataStreamIn& in);
@@ -197,6 +198,7 @@ public:
 
 private:
 	void _UpdateWheels(float tickTime, const MutatorConfig& mutatorConfig, int numWheelsInContact, float forwardSpeed_UU);
+	void _CalcFrictionCurveInputsWheelLanes(float outInputs[4]);
 	void _UpdateBoost(float tickTime, const MutatorConfig& mutatorConfig, float forwardSpeed_UU);
 	void _UpdateJump(float tickTime, const MutatorConfig& mutatorConfig, bool jumpPressed);
 	void _UpdateAirTorque(float tickTime, const MutatorConfig& mutatorConfig, bool doAirControl);
@@ -3,12 +3,19 @@
 #define ROLLING_INFLUENCE_FIX
 
 #include "../SuspensionCollisionGrid/SuspensionCollisionGrid.h"
+#include "../../Math/Float4/Float4.h"
 
 #include "../../../libsrc/bullet3-3.24/BulletDynamics/Dynamics/btDynamicsWorld.h"
 #include "../../../libsrc/bullet3-3.24/BulletDynamics/ConstraintSolver/btContactConstraint.h"
 
 RS_NS_START
 
+// TODO: No idea where this number comes from or how it was calculated lol
+constexpr float ROLLING_FRICTION_SCALE_MAGIC = 113.73963f;
+
+// Gathers a member of each of the 4 wheels into lanes
+#define WHEEL_LANES(type, member) type(wheels[0].member, wheels[1].member, wheels[2].member, wheels[3].member)
+
 btVehicleRL::btVehicleRL(const btVehicleTuning& tuning, btRigidBody* chassis, btVehicleRaycaster* raycaster, btDynamicsWorld* world)
 	: m_vehicleRaycaster(raycaster), m_pitchControl(0),  m_dynamicsWorld(world) {
 	m_chassisBody = chassis;
@@ -224,19 +231,29 @@ void btVehicleRL::updateVehicleFirst(float step, SuspensionCollisionGrid* grid)
 	// simulate suspension
 	//
 
-	int i = 0;
-	for (i = 0; i < m_wheelInfo.size(); i++) {
-		//float depth;
-		//depth =
-		rayCast(m_wheelInfo[i], grid);
-	}
+	if (m_useWheelLanes) {
+		rayCastWheelLanes(grid);
+		calcFrictionImpulsesWheelLanes(step);
+	} else {
+		int i = 0;
+		for (i = 0; i < m_wheelInfo.size(); i++) {
+			//float depth;
+			//depth =
+			rayCast(m_wheelInfo[i], grid);
+		}
 
-	calcFrictionImpulses(step);
+		calcFrictionImpulses(step);
+	}
 }
 
 void btVehicleRL::updateVehicleSecond(float step) {
-	updateSuspension(step);
-	applyFrictionImpulses(step);
+	if (m_useWheelLanes) {
+		updateSuspensionWheelLanes(step);
+		applyFrictionImpulsesWheelLanes(step);
+	} else {
+		updateSuspension(step);
+		applyFrictionImpulses(step);
+	}
 }
 
 void btVehicleRL::setSteeringValue(float steering, int wheel) {
@@ -365,9 +382,6 @@ void btVehicleRL::calcFrictionImpulses(float timeStep) {
 							relVel = 0;
 					}
 
-					// TODO: No idea where this number comes from or how it was calculated lol
-					constexpr float ROLLING_FRICTION_SCALE_MAGIC = 113.73963f;
-
 					rollingFriction = RS_CLAMP(-relVel * ROLLING_FRICTION_SCALE_MAGIC, -wheel.m_brake, wheel.m_brake);
 				} else {
 					// Don't apply friction when driving with no brake
@@ -401,6 +415,319 @@ void btVehicleRL::applyFrictionImpulses(float timeStep) {
 	}
 }
 
+// See: I21, I22, and I23
+void btVehicleRL::rayCastWheelLanes(SuspensionCollisionGrid* grid) {
+	btAssert(getNumWheels() == 4);
+	btWheelInfoRL* wheels = &m_wheelInfo[0];
+
+	// World-space wheel transforms were just updated by updateWheelTransform()
+	for (int i = 0; i < 4; i++) {
+		wheels[i].m_raycastInfo.m_isInContact = false;
+		wheels[i].m_isInContactWithWorld = false;
+	}
+
+	Float4
+		restLength = WHEEL_LANES(Float4, m_suspensionRestLength1),
+		radius = WHEEL_LANES(Float4, m_wheelsRadius),
+		suspensionTravel = WHEEL_LANES(Float4, m_maxSuspensionTravelCm) / Float4(100),
+		realRayLength = restLength + suspensionTravel + radius - Float4(RLConst::BTVehicle::SUSPENSION_SUBTRACTION);
+
+	Vec3x4
+		source = WHEEL_LANES(Vec3x4, m_raycastInfo.m_hardPointWS),
+		target = source + WHEEL_LANES(Vec3x4, m_raycastInfo.m_wheelDirectionWS) * realRayLength;
+
+	btVector3 sources[4], targets[4];
+	source.Store(sources);
+	target.Store(targets);
+
+	// Bullet ray queries can't be done 4 at once
+	btAssert(m_vehicleRaycaster);
+	btCollisionObject* objects[4];
+	btVehicleRaycaster::btVehicleRaycasterResult rayResults[4];
+	for (int i = 0; i < 4; i++) {
+		rayResults[i].m_hitPointInWorld = rayResults[i].m_hitNormalInWorld = btVector3(0, 0, 0);
+		if (grid) {
+			objects[i] = grid->CastSuspensionRay(m_vehicleRaycaster, sources[i], targets[i], m_chassisBody, rayResults[i]);
+		} else {
+			objects[i] = (btCollisionObject*)m_vehicleRaycaster->castRay(sources[i], targets[i], m_chassisBody, rayResults[i]);
+		}
+	}
+
+	Bool4 hit = Bool4(objects[0], objects[1], objects[2], objects[3]);
+	Vec3x4
+		contactPoint = Select(hit, Vec3x4(rayResults[0].m_hitPointInWorld, rayResults[1].m_hitPointInWorld, rayResults[2].m_hitPointInWorld, rayResults[3].m_hitPointInWorld), target),
+		contactNormal = Vec3x4(rayResults[0].m_hitNormalInWorld, rayResults[1].m_hitNormalInWorld, rayResults[2].m_hitNormalInWorld, rayResults[3].m_hitNormalInWorld);
+
+	// NOTE: Lanes without a hit don't use any of the below
+	Vec3x4 upDir = getUpVector();
+	Float4 wheelTraceLenSq = (source - contactPoint).Dot(upDir);
+	Float4 hitSuspensionLength = Clamp(
+		wheelTraceLenSq - radius,
+		restLength - suspensionTravel,
+		restLength + suspensionTravel
+	);
+
+	Float4 denominator = contactNormal.Dot(upDir);
+
+	Vec3x4 relPos = contactPoint - Vec3x4(m_chassisBody->getWorldTransform().m_origin);
+	Vec3x4 velAtContactPoint = Vec3x4(m_chassisBody->getLinearVelocity()) + Vec3x4(m_chassisBody->getAngularVelocity()).Cross(relPos);
+	Float4 projVel = contactNormal.Dot(velAtContactPoint);
+
+	// rayCast() compares with the double 0.1, which for a float is the same as >= 0.1f
+	Bool4 denominatorValid = denominator >= Float4(0.1f);
+	Float4 inv = Float4(1) / denominator;
+
+	Float4
+		suspensionLength = Select(hit, hitSuspensionLength, restLength + suspensionTravel),
+		suspensionRelativeVelocity = Select(hit & denominatorValid, projVel * inv, Float4(0)),
+		clippedInvContactDotSuspension = Select(hit, Select(denominatorValid, inv, Float4(10)), Float4(1));
+
+	float wheelTraceLenSqs[4], suspensionLengths[4], suspensionRelativeVelocities[4], clippedInvContactDotSuspensions[4];
+	wheelTraceLenSq.Store(wheelTraceLenSqs);
+	suspensionLength.Store(suspensionLengths);
+	suspensionRelativeVelocity.Store(suspensionRelativeVelocities);
+	clippedInvContactDotSuspension.Store(clippedInvContactDotSuspensions);
+
+	btVector3 velsAtContactPoint[4];
+	velAtContactPoint.Store(velsAtContactPoint);
+
+	for (int i = 0; i < 4; i++) {
+		btWheelInfoRL& wheel = wheels[i];
+		btCollisionObject* object = objects[i];
+
+		wheel.m_raycastInfo.m_groundObject = object;
+		wheel.m_raycastInfo.m_suspensionLength = suspensionLengths[i];
+		wheel.m_suspensionRelativeVelocity = suspensionRelativeVelocities[i];
+		wheel.m_clippedInvContactDotSuspension = clippedInvContactDotSuspensions[i];
+
+		if (object) {
+			wheel.m_raycastInfo.m_contactPointWS = rayResults[i].m_hitPointInWorld;
+			wheel.m_raycastInfo.m_contactNormalWS = rayResults[i].m_hitNormalInWorld;
+			wheel.m_raycastInfo.m_isInContact = true;
+			wheel.m_isInContactWithWorld = object->isStaticObject();
+			wheel.m_velAtContactPoint = velsAtContactPoint[i];
+
+			if (object->isStaticObject()) { // Compute m_extraPushback when colliding with static object
+				float rayPushbackThresh = (wheel.m_suspensionRestLength1 + wheel.m_wheelsRadius) - RLConst::BTVehicle::SUSPENSION_SUBTRACTION;
+				if (wheelTraceLenSqs[i] < rayPushbackThresh) {
+					float wheelTraceDistDelta = wheelTraceLenSqs[i] - rayPushbackThresh;
+					float collisionResult = resolveSingleCollision(
+						m_chassisBody,
+						object,
+						rayResults[i].m_hitPointInWorld,
+						rayResults[i].m_hitNormalInWorld,
+						m_dynamicsWorld->getSolverInfo(),
+						wheelTraceDistDelta,
+						false
+					);
+
+					wheel.m_extraPushback = collisionResult / getNumWheels();
+				}
+			}
+		} else {
+			wheel.m_raycastInfo.m_contactPointWS = targets[i];
+			wheel.m_raycastInfo.m_contactNormalWS = -wheel.m_raycastInfo.m_wheelDirectionWS;
+			wheel.m_extraPushback = 0;
+		}
+	}
+}
+
+// Rows of the basis of each lane's body
+struct BasisLanes {
+	Vec3x4 rows[3];
+
+	// transpose(basis) * vec, which is what btJacobianEntry uses to go from world to local
+	Vec3x4 TransposedMul(const Vec3x4& vec) const {
+		return Vec3x4(
+			rows[0].x * vec.x + rows[1].x * vec.y + rows[2].x * vec.z,
+			rows[0].y * vec.x + rows[1].y * vec.y + rows[2].y * vec.z,
+			rows[0].z * vec.x + rows[1].z * vec.y + rows[2].z * vec.z
+		);
+	}
+};
+
+// See: I25
+void btVehicleRL::calcFrictionImpulsesWheelLanes(float timeStep) {
+	btAssert(getNumWheels() == 4);
+	btWheelInfoRL* wheels = &m_wheelInfo[0];
+
+	float frictionScale = m_chassisBody->getMass() / 3;
+
+	btRigidBody* groundObjects[4];
+	for (int i = 0; i < 4; i++)
+		groundObjects[i] = (btRigidBody*)wheels[i].m_raycastInfo.m_groundObject;
+
+	Bool4 onGround = Bool4(groundObjects[0], groundObjects[1], groundObjects[2], groundObjects[3]);
+	if (!onGround.Any()) {
+		for (int i = 0; i < 4; i++)
+			wheels[i].m_impulse = { 0,0,0 };
+		return;
+	}
+
+	// Lanes with no ground object use the chassis in its place, their results are thrown away
+	btRigidBody* grounds[4];
+	for (int i = 0; i < 4; i++)
+		grounds[i] = groundObjects[i] ? groundObjects[i] : m_chassisBody;
+
+#define GROUND_LANES(type, expr) type(grounds[0]->expr, grounds[1]->expr, grounds[2]->expr, grounds[3]->expr)
+	Vec3x4
+		groundPos = GROUND_LANES(Vec3x4, getCenterOfMassPosition()),
+		groundVel = GROUND_LANES(Vec3x4, getLinearVelocity()),
+		groundAngVel = GROUND_LANES(Vec3x4, getAngularVelocity()),
+		groundInvInertia = GROUND_LANES(Vec3x4, getInvInertiaDiagLocal());
+	Float4 groundInvMass = GROUND_LANES(Float4, getInvMass());
+
+	BasisLanes groundBasis;
+	for (int i = 0; i < 3; i++)
+		groundBasis.rows[i] = GROUND_LANES(Vec3x4, getCenterOfMassTransform().getBasis()[i]);
+#undef GROUND_LANES
+
+	const btMatrix3x3& chassisBasisMat = m_chassisBody->getCenterOfMassTransform().getBasis();
+	BasisLanes chassisBasis = { chassisBasisMat[0], chassisBasisMat[1], chassisBasisMat[2] };
+	Vec3x4
+		chassisPos = m_chassisBody->getCenterOfMassPosition(),
+		chassisVel = m_chassisBody->getLinearVelocity(),
+		chassisAngVel = m_chassisBody->getAngularVelocity();
+
+	// Axle direction (includes steering turn)
+	Vec3x4 axleDir = Vec3x4(
+		wheels[0].m_worldTransform.getBasis().getColumn(m_indexRightAxis),
+		wheels[1].m_worldTransform.getBasis().getColumn(m_indexRightAxis),
+		wheels[2].m_worldTransform.getBasis().getColumn(m_indexRightAxis),
+		wheels[3].m_worldTransform.getBasis().getColumn(m_indexRightAxis)
+	);
+
+	Vec3x4 surfNormal = WHEEL_LANES(Vec3x4, m_raycastInfo.m_contactNormalWS);
+	Float4 proj = axleDir.Dot(surfNormal);
+	axleDir = (axleDir - surfNormal * proj).SafeNormalized();
+
+	// Wheel forwards direction
+	Vec3x4 forwardDir = surfNormal.Cross(axleDir).SafeNormalized();
+
+	Vec3x4 contactPoint = WHEEL_LANES(Vec3x4, m_raycastInfo.m_contactPointWS);
+	Vec3x4
+		carRelContactPoint = contactPoint - chassisPos,
+		groundRelContactPoint = contactPoint - groundPos;
+
+	Vec3x4 carContactVel = chassisVel + chassisAngVel.Cross(carRelContactPoint);
+
+	Float4 sideImpulse;
+	{ // Get sideways friction force (same as resolveSingleBilateral())
+		Vec3x4 vel = carContactVel - (groundVel + groundAngVel.Cross(groundRelContactPoint));
+
+		// See btJacobianEntry
+		Vec3x4
+			aJ = chassisBasis.TransposedMul(carRelContactPoint.Cross(axleDir)),
+			bJ = groundBasis.TransposedMul(groundRelContactPoint.Cross(-axleDir)),
+			minvJtA = Vec3x4(m_chassisBody->getInvInertiaDiagLocal()) * aJ,
+			minvJtB = groundInvInertia * bJ;
+		Float4 jacDiagAB = Float4(m_chassisBody->getInvMass()) + minvJtA.Dot(aJ) + groundInvMass + minvJtB.Dot(bJ);
+		Float4 jacDiagABInv = Float4(1) / jacDiagAB;
+
+		Float4 relVel = axleDir.Dot(vel);
+
+		constexpr float CONTACT_DAMPING = 0.2f;
+		sideImpulse = Select(axleDir.Length2() > Float4(1.1f), Float4(0), Float4(-CONTACT_DAMPING) * relVel * jacDiagABInv);
+	}
+
+	Float4
+		engineForce = WHEEL_LANES(Float4, m_engineForce),
+		brake = WHEEL_LANES(Float4, m_brake);
+
+	Float4 brakeRollingFriction;
+	{ // Simplified variation of calcRollingFriction() (see calcFrictionImpulses())
+		// Uses the car's relative contact point for the ground object as well
+		Vec3x4 contactVel = carContactVel - (groundVel + groundAngVel.Cross(carRelContactPoint));
+		Float4 relVel = contactVel.Dot(forwardDir);
+
+		if (timeStep > (1 / 80.f)) {
+			float threshold = -(1 / (timeStep * 150.f)) + 0.8f;
+			relVel = Select(Abs(relVel) < Float4(threshold), Float4(0), relVel);
+		}
+
+		brakeRollingFriction = Min(Max(-relVel * Float4(ROLLING_FRICTION_SCALE_MAGIC), -brake), brake);
+	}
+
+	// Engine force already accounts for our mass, so we will cancel out the friction scale multiplication at the end
+	// Don't apply friction when driving with no brake
+	Float4 rollingFriction = Select(
+		engineForce == Float4(0),
+		Select(brake != Float4(0), brakeRollingFriction, Float4(0)),
+		-engineForce / Float4(frictionScale)
+	);
+
+	Vec3x4 totalFrictionForce =
+		(forwardDir * rollingFriction * WHEEL_LANES(Float4, m_longFriction)) + (axleDir * sideImpulse * WHEEL_LANES(Float4, m_latFriction));
+	Vec3x4 impulse = Select(onGround, totalFrictionForce * Float4(frictionScale), Vec3x4(btVector3(0, 0, 0)));
+
+	btVector3 impulses[4];
+	impulse.Store(impulses);
+	for (int i = 0; i < 4; i++)
+		wheels[i].m_impulse = impulses[i];
+}
+
+// See: I24
+void btVehicleRL::updateSuspensionWheelLanes(float deltaTime) {
+	btAssert(getNumWheels() == 4);
+	btWheelInfoRL* wheels = &m_wheelInfo[0];
+
+	Bool4 inContact = WHEEL_LANES(Bool4, m_raycastInfo.m_isInContact);
+
+	Float4
+		suspensionRelativeVelocity = WHEEL_LANES(Float4, m_suspensionRelativeVelocity),
+		force =
+			(WHEEL_LANES(Float4, m_suspensionRestLength1) - WHEEL_LANES(Float4, m_raycastInfo.m_suspensionLength))
+			* WHEEL_LANES(Float4, m_suspensionStiffness) * WHEEL_LANES(Float4, m_clippedInvContactDotSuspension),
+		dampingVelScale = Select(
+			suspensionRelativeVelocity < Float4(0),
+			WHEEL_LANES(Float4, m_wheelsDampingCompression),
+			WHEEL_LANES(Float4, m_wheelsDampingRelaxation)
+		);
+
+	Float4 suspensionForce = (force - (dampingVelScale * suspensionRelativeVelocity)) * WHEEL_LANES(Float4, m_suspensionForceScale);
+
+	// RL never uses downwards suspension forces
+	suspensionForce = Select(suspensionForce < Float4(0), Float4(0), suspensionForce);
+	suspensionForce = Select(inContact, suspensionForce, Float4(0));
+
+	Vec3x4 contactPointOffset = WHEEL_LANES(Vec3x4, m_raycastInfo.m_contactPointWS) - Vec3x4(getRigidBody()->getCenterOfMassPosition());
+	Float4 baseForceScale = (suspensionForce * Float4(deltaTime)) + WHEEL_LANES(Float4, m_extraPushback);
+	Vec3x4 impulse = WHEEL_LANES(Vec3x4, m_raycastInfo.m_contactNormalWS) * baseForceScale;
+
+	float suspensionForces[4];
+	suspensionForce.Store(suspensionForces);
+	btVector3 contactPointOffsets[4], impulses[4];
+	contactPointOffset.Store(contactPointOffsets);
+	impulse.Store(impulses);
+
+	for (int i = 0; i < 4; i++) {
+		wheels[i].m_wheelsSuspensionForce = suspensionForces[i];
+		if (suspensionForces[i] != 0)
+			m_chassisBody->applyImpulse(impulses[i], contactPointOffsets[i]);
+	}
+}
+
+// See: I25
+void btVehicleRL::applyFrictionImpulsesWheelLanes(float timeStep) {
+	btAssert(getNumWheels() == 4);
+	btWheelInfoRL* wheels = &m_wheelInfo[0];
+
+	Vec3x4 upDir = m_chassisBody->getWorldTransform().getBasis().getColumn(m_indexUpAxis);
+
+	Vec3x4 wheelContactOffset = WHEEL_LANES(Vec3x4, m_raycastInfo.m_contactPointWS) - Vec3x4(m_chassisBody->getWorldTransform().getOrigin());
+	Float4 contactUpDot = upDir.Dot(wheelContactOffset);
+	Vec3x4 wheelRelPos = wheelContactOffset - upDir * contactUpDot;
+	Vec3x4 impulse = WHEEL_LANES(Vec3x4, m_impulse) * Float4(timeStep);
+
+	btVector3 wheelRelPositions[4], impulses[4];
+	wheelRelPos.Store(wheelRelPositions);
+	impulse.Store(impulses);
+
+	for (int i = 0; i < 4; i++)
+		if (!wheels[i].m_impulse.isZero())
+			m_chassisBody->applyImpulse(impulses[i], wheelRelPositions[i]);
+}
+
 btVector3 btVehicleRL::getUpwardsDirFromWheelContacts() {
 	btVector3 sumContactDir = btVector3(0, 0, 0);
 	for (int i = 0; i < 4; i++)
@@ -88,6 +88,17 @@ public:
 
 	float rayCast(btWheelInfoRL& wheel, struct SuspensionCollisionGrid* grid);
 
+	// Same as rayCast(), calcFrictionImpulses(), updateSuspension(), and applyFrictionImpulses(),
+	// but all 4 wheels are done at once as structure-of-arrays lanes (see Float4)
+	// The Bullet ray query and the impulses themselves are still done one wheel at a time, in wheel order
+	void rayCastWheelLanes(struct SuspensionCollisionGrid* grid);
+	void calcFrictionImpulsesWheelLanes(float timeStep);
+	void updateSuspensionWheelLanes(float deltaTime);
+	void applyFrictionImpulsesWheelLanes(float timeStep);
+
+	// Use the wheel lane functions above in updateVehicleFirst() and updateVehicleSecond()
+	bool m_useWheelLanes = true;
+
 	void updateVehicleFirst(float step, struct SuspensionCollisionGrid* grid);
 	void updateVehicleSecond(float step);
 
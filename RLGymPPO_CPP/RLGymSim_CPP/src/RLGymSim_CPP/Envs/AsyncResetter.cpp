@@ -0,0 +1,86 @@
+#include "AsyncResetter.h"
+
+RLGSC::AsyncResetter::AsyncResetter() {
+	_thread = std::thread(&AsyncResetter::_Run, this);
+}
+
+int RLGSC::AsyncResetter::AddSlot(StateSetter* stateSetter, Arena* templateArena) {
+	Slot* slot = new Slot();
+	slot->stateSetter = stateSetter;
+	slot->spareArena = ArenaLayout::FromArena(templateArena).MakeArena();
+
+	int slotIndex;
+	{
+		std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>(_mutex);
+		slotIndex = (int)_slots.size();
+		_slots.push_back(slot);
+	}
+	_workerCondition.notify_one();
+	return slotIndex;
+}
+
+void RLGSC::AsyncResetter::Restore(int slotIndex, Arena* arena) {
+	constexpr const char* ERROR_PREFIX = "AsyncResetter::Restore(): ";
+
+	std::unique_lock<std::mutex> lock = std::unique_lock<std::mutex>(_mutex);
+	if (slotIndex < 0 || slotIndex >= (int)_slots.size())
+		RG_ERR_CLOSE(ERROR_PREFIX << "Invalid slot index " << slotIndex << " (" << _slots.size() << " slots)");
+
+	Slot* slot = _slots[slotIndex];
+	_readyCondition.wait(lock, [slot] { return slot->ready; });
+
+	// The worker never touches a ready slot, so we can apply without holding the lock
+	lock.unlock();
+	slot->states.Apply(arena);
+
+	lock.lock();
+	slot->ready = false;
+	lock.unlock();
+	_workerCondition.notify_one();
+}
+
+void RLGSC::AsyncResetter::_Run() {
+	std::unique_lock<std::mutex> lock = std::unique_lock<std::mutex>(_mutex);
+	while (true) {
+		Slot* slot = NULL;
+		_workerCondition.wait(lock,
+			[this, &slot] {
+				if (_stop)
+					return true;
+
+				for (Slot* otherSlot : _slots) {
+					if (!otherSlot->ready) {
+						slot = otherSlot;
+						return true;
+					}
+				}
+				return false;
+			}
+		);
+
+		if (_stop)
+			break;
+
+		lock.unlock();
+		slot->stateSetter->ResetState(slot->spareArena);
+		slot->states.Capture(slot->spareArena);
+		lock.lock();
+
+		slot->ready = true;
+		_readyCondition.notify_all();
+	}
+}
+
+RLGSC::AsyncResetter::~AsyncResetter() {
+	{
+		std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>(_mutex);
+		_stop = true;
+	}
+	_workerCondition.notify_one();
+	_thread.join();
+
+	for (Slot* slot : _slots) {
+		delete slot->spareArena;
+		delete slot;
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "../Utils/StateSetters/StateSetter.h"
+#include "../Utils/StateSetters/ArenaObjectStates.h"
+#include <condition_variable>
+
+namespace RLGSC {
+	// Runs the state setters of many gyms on a background thread, so a reset state is ready before a gym needs it
+	// Each gym gets a spare arena with the same cars, the next reset state is generated there and captured
+	// A reset then only has to apply the captured states to the gym's arena, and the next one is generated in the background
+	class AsyncResetter {
+	public:
+		struct Slot {
+			StateSetter* stateSetter;
+			Arena* spareArena;
+			ArenaObjectStates states;
+			bool ready = false; // States are generated and not yet applied
+		};
+
+		AsyncResetter();
+
+		RG_NO_COPY(AsyncResetter);
+
+		// The state setter must only be used by this resetter from now on
+		// Returns the slot index to pass to Restore()
+		int AddSlot(StateSetter* stateSetter, Arena* templateArena);
+
+		// Applies the prepared states of a slot to the arena, waiting for them if needed
+		void Restore(int slotIndex, Arena* arena);
+
+		~AsyncResetter();
+
+		// Pointers so the worker can keep using a slot while new ones are added
+		std::vector<Slot*> _slots;
+
+		std::thread _thread;
+		bool _stop = false;
+		std::mutex _mutex;
+		std::condition_variable _workerCondition, _readyCondition;
+
+		void _Run();
+	};
+}
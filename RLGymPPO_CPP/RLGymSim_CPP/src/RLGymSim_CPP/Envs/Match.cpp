@@ -10,25 +10,31 @@ namespace RLGSC {
 	}
 
 	FList2 Match::BuildObservations(const GameState& state) {
-		auto result = FList2(state.players.size());
+		FList2 result = {};
+		BuildObservations(state, result);
+		return result;
+	}
 
-		obsBuilder->PreStep(state);
+	void Match::BuildObservations(const GameState& state, FList2& obs) {
+		obs.resize(state.players.size());
 
-		for (int i = 0; i < state.players.size(); i++) {
-			result[i] =
-				obsBuilder->BuildOBS(state.players[i], state, prevActions[i]);
-		}
+		obsBuilder->PreStep(state);
 
-		return result;
+		for (int i = 0; i < state.players.size(); i++)
+			obsBuilder->BuildOBSInto(state.players[i], state, prevActions[i], obs[i]);
 	}
 
 	FList Match::GetRewards(const GameState& state, bool done) {
-		auto result = FList(state.players.size());
-
 		rewardFn->PreStep(state);
 		return rewardFn->GetAllRewards(state, prevActions, done);
 	}
 
+	void Match::GetRewards(const GameState& state, bool done, FList& rewards) {
+		rewardFn->PreStep(state);
+		rewards.resize(state.players.size());
+		rewardFn->GetAllRewardsInto(state, prevActions, done, rewards.data());
+	}
+
 	bool Match::IsDone(const GameState& state) {
 		for (auto& cond : terminalConditions)
 			if (cond->IsTerminal(state))
@@ -42,21 +48,33 @@ namespace RLGSC {
 	}
 
 	ActionSet Match::ParseActions(const ActionParser::Input& actionsData, const GameState& gameState) {
-		ActionSet actions = actionParser->ParseActions(actionsData, gameState);
+		ActionSet actions = {};
+		ParseActions(actionsData, gameState, actions);
+		return actions;
+	}
+
+	void Match::ParseActions(const ActionParser::Input& actionsData, const GameState& gameState, ActionSet& actions) {
+		actionParser->ParseActionsInto(actionsData, gameState, actions);
 
 		for (int i = 0; i < gameState.players.size(); i++)
 			if (gameState.players[i].carState.isDemoed)
 				actions[i] = {};
-
-		return actions;
 	}
 
 	GameState Match::ResetState(Arena* arena) {
-		GameState newState = stateSetter->ResetState(arena);
+		return _FinishResetState(arena, stateSetter->ResetState(arena));
+	}
+
+	GameState Match::ResetStateAsync(Arena* arena, AsyncResetter* asyncResetter, int asyncResetSlot) {
+		asyncResetter->Restore(asyncResetSlot, arena);
+		// The state setter's returned state was for the worker's spare arena, so build one from the arena it was restored into
+		return _FinishResetState(arena, GameState(arena));
+	}
 
+	GameState Match::_FinishResetState(Arena* arena, const GameState& newState) {
 		if (newState.players.size() != playerAmount) {
 			RG_ERR_CLOSE(
-				"Match::ResetState(): New state has a different amount of players, "
+				"Match::_FinishResetState(): New state has a different amount of players, "
 				"expected " << playerAmount << " but got " << newState.players.size() << ".\n"
 				"Changing number of players at state reset is currently not supported.\n" <<
 				"If you want variable player amounts, set a differing player amount per env."
@@ -6,6 +6,7 @@
 #include "../Utils/OBSBuilders/OBSBuilder.h"
 #include "../Utils/ActionParsers/ActionParser.h"
 #include "../Utils/StateSetters/StateSetter.h"
+#include "AsyncResetter.h"
 
 namespace RLGSC {
 
@@ -51,6 +52,16 @@ namespace RLGSC {
 		bool IsDone(const GameState& state);
 		ScoreLine GetScoreLine(const GameState& state);
 		ActionSet ParseActions(const ActionParser::Input& actionsData, const GameState& gameState);
+
+		// Versions that overwrite an existing list, reusing its capacity
+		void BuildObservations(const GameState& state, FList2& obs);
+		void GetRewards(const GameState& state, bool done, FList& rewards);
+		void ParseActions(const ActionParser::Input& actionsData, const GameState& gameState, ActionSet& actions);
 		GameState ResetState(Arena* arena);
+
+		// ResetState() with states prepared in the background by an AsyncResetter that owns our state setter
+		GameState ResetStateAsync(Arena* arena, AsyncResetter* asyncResetter, int asyncResetSlot);
+
+		GameState _FinishResetState(Arena* arena, const GameState& newState);
 	};
 }
\ No newline at end of file
@@ -8,7 +8,7 @@ namespace RLGSC {
 			return;
 
 		Gym* gym = (Gym*)userInfo;
-		for (auto& player : gym->prevState.players)
+		for (auto& player : gym->prevState->players)
 			if (player.carId == car->id)
 				(player.*DATA_VAR)++;
 	}
@@ -56,20 +56,45 @@ namespace RLGSC {
 	}
 
 	FList2 Gym::Reset() {
-		GameState resetState = match->ResetState(arena);
-		match->EpisodeReset(resetState);
-		prevState = resetState;
+		// Written to the spare buffer so the state from the last step stays valid
+		if (asyncResetter) {
+			*_spareState = match->ResetStateAsync(arena, asyncResetter, asyncResetSlot);
+		} else {
+			*_spareState = match->ResetState(arena);
+		}
+		std::swap(prevState, _spareState);
+		match->EpisodeReset(*prevState);
 		eventTracker.ResetPersistentInfo();
 
-		FList2 obs = match->BuildObservations(resetState);
+		FList2 obs = match->BuildObservations(*prevState);
 		return obs;
 	}
 
-	Gym::StepResult Gym::Step(const ActionParser::Input& actionsData) {
-		ActionSet actions = match->ParseActions(actionsData, prevState);
-		match->prevActions = actions;
+	void Gym::SetAsyncResetter(AsyncResetter* resetter) {
+		asyncResetter = resetter;
+		asyncResetSlot = resetter ? resetter->AddSlot(match->stateSetter, arena) : -1;
+	}
 
-		GameState state;
+	const Gym::StepResult& Gym::Step(const ActionParser::Input& actionsData) {
+		RG_TRACE_SCOPE("Gym::Step");
+
+		StepResult& result = StepWithoutRewards(actionsData);
+		{
+			RG_TRACE_SCOPE("Gym::Step/Rewards");
+			match->GetRewards(*result.state, result.done, result.reward);
+		}
+		return result;
+	}
+
+	Gym::StepResult& Gym::StepWithoutRewards(const ActionParser::Input& actionsData) {
+
+		ActionSet& actions = match->prevActions;
+		{
+			RG_TRACE_SCOPE("Gym::Step/ParseActions");
+			match->ParseActions(actionsData, *prevState, actions);
+		}
+
+		GameState& state = *_spareState;
 
 		{ // Step arena with actions
 			auto carItr = arena->_cars.begin();
@@ -78,26 +103,158 @@ namespace RLGSC {
 				carItr++;
 			}
 
-			arena->Step(tickSkip - actionDelay);
-			if (arena->gameMode != GameMode::HEATSEEKER)
+			{
+				RG_TRACE_SCOPE("Arena::Step");
+				arena->Step(tickSkip - actionDelay);
+			}
+			if (arena->gameMode != GameMode::HEATSEEKER) {
+				RG_TRACE_SCOPE("Gym::Step/EventTracker");
 				eventTracker.Update(arena);
-			state = prevState; // All callbacks have been hit
-			state.UpdateFromArena(arena);
-			arena->Step(actionDelay);
+			}
+			{
+				RG_TRACE_SCOPE("Gym::Step/UpdateState");
+				state.UpdateFromArena(arena, *prevState); // All callbacks have been hit
+			}
+			{
+				RG_TRACE_SCOPE("Arena::Step");
+				arena->Step(actionDelay);
+			}
 			totalTicks += tickSkip;
 			totalSteps++;
 		}
 
-		FList2 obs = match->BuildObservations(state);
-		bool done = match->IsDone(state);
-		FList rewards = match->GetRewards(state, done);
-		prevState = state;
-
-		return StepResult {
-			obs,
-			rewards,
-			done,
-			state
-		};
+		StepResult& result = _stepResult;
+		{
+			RG_TRACE_SCOPE("Gym::Step/BuildObs");
+			match->BuildObservations(state, result.obs);
+		}
+		{
+			RG_TRACE_SCOPE("Gym::Step/Terminal");
+			result.done = match->IsDone(state);
+		}
+		result.reward.clear();
+		result.state = &state;
+
+		std::swap(prevState, _spareState);
+		return result;
+	}
+
+	constexpr uint32_t EPISODE_FORMAT_VERSION = 2;
+
+	void Gym::SerializeEpisode(DataStreamOut& out) {
+		out.Write<uint32_t>(EPISODE_FORMAT_VERSION);
+
+		arena->Serialize(out);
+
+		out.WriteMultiple(prevState->scoreLine.teamGoals[0], prevState->scoreLine.teamGoals[1], prevState->lastTouchCarID);
+
+		out.Write<uint32_t>(prevState->players.size());
+		for (auto& player : prevState->players) {
+			out.WriteMultiple(
+				player.carId,
+				player.matchGoals, player.matchSaves, player.matchAssists, player.matchShots,
+				player.matchShotPasses, player.matchBumps, player.matchDemos, player.boostPickups
+			);
+		}
+
+		out.Write<uint32_t>(match->prevActions.size());
+		for (auto& action : match->prevActions)
+			out.WriteBytes(action.begin(), sizeof(float) * Action::ELEM_AMOUNT);
+
+		// Each condition's progress is size-prefixed, so a condition that reads back a different amount can't misalign the rest of the stream
+		out.Write<uint32_t>(match->terminalConditions.size());
+		for (auto cond : match->terminalConditions) {
+			DataStreamOut condOut = {};
+			cond->SerializeProgress(condOut);
+			out.Write<uint64_t>(condOut.data.size());
+			out.WriteBytes(condOut.data.data(), condOut.data.size());
+		}
+	}
+
+	bool Gym::DeserializeEpisode(DataStreamIn& in) {
+		if (in.Read<uint32_t>() != EPISODE_FORMAT_VERSION)
+			return false;
+
+		// Deserialize into a temporary arena, then copy the states over
+		// This keeps our arena, its callbacks, and its car order intact
+		Arena* savedArena = Arena::DeserializeNew(in);
+		if (in.IsOverflown() || savedArena->_cars.size() != arena->_cars.size() || savedArena->gameMode != arena->gameMode) {
+			delete savedArena;
+			return false;
+		}
+
+		for (Car* car : arena->_cars) {
+			if (!savedArena->GetCar(car->id)) {
+				delete savedArena;
+				return false;
+			}
+		}
+
+		for (Car* car : arena->_cars)
+			car->SetState(savedArena->GetCar(car->id)->GetState());
+
+		arena->ball->SetState(savedArena->ball->GetState());
+		for (int i = 0; i < arena->_boostPads.size(); i++)
+			arena->_boostPads[i]->SetState(savedArena->_boostPads[i]->GetState());
+
+		arena->tickCount = savedArena->tickCount;
+		delete savedArena;
+
+		GameState state = {};
+		state.lastTickCount = arena->tickCount;
+		state.UpdateFromArena(arena);
+		in.ReadMultiple(state.scoreLine.teamGoals[0], state.scoreLine.teamGoals[1], state.lastTouchCarID);
+
+		uint32_t playerAmount = in.Read<uint32_t>();
+		for (uint32_t i = 0; i < playerAmount; i++) {
+			uint32_t carId;
+			int counters[8];
+			in.ReadMultiple(carId, counters[0], counters[1], counters[2], counters[3], counters[4], counters[5], counters[6], counters[7]);
+
+			for (auto& player : state.players) {
+				if (player.carId != carId)
+					continue;
+
+				player.matchGoals = counters[0];
+				player.matchSaves = counters[1];
+				player.matchAssists = counters[2];
+				player.matchShots = counters[3];
+				player.matchShotPasses = counters[4];
+				player.matchBumps = counters[5];
+				player.matchDemos = counters[6];
+				player.boostPickups = counters[7];
+			}
+		}
+
+		// Give the reward function, obs builder, etc. their reset with the restored state
+		match->EpisodeReset(state);
+		*prevState = state;
+		eventTracker.ResetPersistentInfo();
+
+		uint32_t actionAmount = in.Read<uint32_t>();
+		for (uint32_t i = 0; i < actionAmount; i++) {
+			Action action;
+			in.ReadBytes(action.begin(), sizeof(float) * Action::ELEM_AMOUNT);
+			if (i < match->prevActions.size())
+				match->prevActions[i] = action;
+		}
+
+		// Different terminal conditions than when saved, their progress can't be restored
+		uint32_t condAmount = in.Read<uint32_t>();
+		if (in.IsOverflown() || condAmount != match->terminalConditions.size())
+			return false;
+
+		for (auto cond : match->terminalConditions) {
+			uint64_t size = in.Read<uint64_t>();
+			if (in.IsOverflown() || in.GetNumBytesLeft() < size)
+				return false;
+
+			size_t endPos = in.pos + size;
+			cond->DeserializeProgress(in);
+			if (in.pos != endPos)
+				return false;
+		}
+
+		return !in.IsOverflown();
 	}
-}
\ No newline at end of file
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "Envs/Match.h"
+#include "Utils/Tracing.h"
 
 namespace RLGSC {
 	class Gym {
@@ -9,9 +10,18 @@ namespace RLGSC {
 		Match* match;
 		int tickSkip;
 		int actionDelay;
-		GameState prevState;
 		std::vector<uint32_t> carIds;
 
+		// The state is double-buffered: Step() and Reset() write the new state into the spare buffer, then swap
+		// This way the previous state is never copied, and the last state stays valid until the next step
+		GameState _stateBuffers[2] = {};
+		GameState* prevState = &_stateBuffers[0];
+		GameState* _spareState = &_stateBuffers[1];
+
+		// If set, reset states are generated in the background by this resetter (see SetAsyncResetter())
+		AsyncResetter* asyncResetter = NULL;
+		int asyncResetSlot = -1;
+
 		int totalTicks = 0;
 		int totalSteps = 0;
 
@@ -21,13 +31,32 @@ namespace RLGSC {
 
 		virtual FList2 Reset();
 
+		// Hands our match's state setter to the resetter, which then prepares every reset state ahead of time
+		// Remove it with SetAsyncResetter(NULL) before deleting the resetter
+		void SetAsyncResetter(AsyncResetter* resetter);
+
+		// Owned by the gym and reused every step, only valid until the next Step() or Reset()
 		struct StepResult {
 			FList2 obs;
 			FList reward;
 			bool done;
-			GameState state;
+			const GameState* state;
 		};
-		virtual StepResult Step(const ActionParser::Input& actionsData);
+		StepResult _stepResult = {};
+
+		virtual const StepResult& Step(const ActionParser::Input& actionsData);
+
+		// Step() without computing rewards, the reward of the result is left empty
+		// Used to compute the rewards of many gyms at once (see RewardBatch)
+		virtual StepResult& StepWithoutRewards(const ActionParser::Input& actionsData);
+
+		// Writes everything needed to continue the current episode later:
+		//	the arena, match stats, previous actions, and terminal condition progress
+		virtual void SerializeEpisode(DataStreamOut& out);
+
+		// Continues an episode written by SerializeEpisode()
+		// Returns false if the episode couldn't be restored (e.g. it has different cars or terminal conditions), the gym should then be reset
+		virtual bool DeserializeEpisode(DataStreamIn& in);
 
 		virtual ~Gym() {
 			delete arena;
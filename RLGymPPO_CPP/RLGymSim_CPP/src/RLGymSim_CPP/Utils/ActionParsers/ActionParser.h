@@ -11,6 +11,11 @@ namespace RLGSC {
 		typedef IList Input;
 
 		virtual ActionSet ParseActions(const Input& actionsData, const GameState& gameState) = 0;
+
+		// Same as ParseActions(), but overwrites actions so its capacity is reused between steps
+		virtual void ParseActionsInto(const Input& actionsData, const GameState& gameState, ActionSet& actions) {
+			actions = ParseActions(actionsData, gameState);
+		}
 		virtual int GetActionAmount() = 0;
 	};
 }
\ No newline at end of file
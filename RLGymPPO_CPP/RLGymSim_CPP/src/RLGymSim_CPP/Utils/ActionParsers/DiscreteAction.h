@@ -18,6 +18,12 @@ namespace RLGSC {
 			return result;
 		}
 
+		virtual void ParseActionsInto(const Input& actionsData, const GameState& gameState, ActionSet& result) {
+			result.resize(actionsData.size());
+			for (int i = 0; i < actionsData.size(); i++)
+				result[i] = actions[actionsData[i]];
+		}
+
 		virtual int GetActionAmount() {
 			return actions.size();
 		}
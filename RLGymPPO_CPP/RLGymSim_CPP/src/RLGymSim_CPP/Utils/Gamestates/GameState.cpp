@@ -49,22 +49,65 @@ void _BuildBoostPadIndexMap(Arena* arena) {
 	boostPadIndexMapBuilt = true;
 }
 
-void RLGSC::GameState::UpdateFromArena(Arena* arena) {
+uint64_t RLGSC::GameState::MakeVersion() {
+	static std::atomic<uint64_t> nextVersion = 1;
+	return nextVersion.fetch_add(1, std::memory_order_relaxed);
+}
+
+int RLGSC::GameState::GetPlayerIndex(const PlayerData& player) const {
+	// Players are almost always passed from this state, so try that first
+	if (&player >= players.data() && &player < players.data() + players.size())
+		return &player - players.data();
+
+	for (int i = 0; i < players.size(); i++)
+		if (players[i].carId == player.carId)
+			return i;
+
+	return -1;
+}
+
+const RLGSC::PlayerFeatures& RLGSC::GameState::GetPlayerFeatures(const PlayerData& player) const {
+	int index = GetPlayerIndex(player);
+	if (index == -1)
+		RG_ERR_CLOSE("GameState::GetPlayerFeatures(): Player with car ID " << player.carId << " is not in this state");
+
+	return GetFeatures().players[index];
+}
+
+void RLGSC::GameState::_UpdateInverted() const {
+	_ballInv = ball.Invert();
+
+	// boostPads[i] is from the pad at BOOST_LOCATIONS[i], which is mirrored by BOOST_LOCATIONS[AMOUNT - i - 1]
+	for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++) {
+		int invIdx = CommonValues::BOOST_LOCATIONS_AMOUNT - i - 1;
+		_boostPadsInv[i] = boostPads[invIdx];
+		_boostPadTimersInv[i] = boostPadTimers[invIdx];
+	}
+
+	_invertedVersion = _version;
+}
+
+void RLGSC::GameState::UpdateFromArena(Arena* arena, const GameState& prevState) {
 	lastArena = arena;
-	int tickSkip = RS_MAX(arena->tickCount - lastTickCount, 0);
+	_version = MakeVersion();
+	int tickSkip = RS_MAX(arena->tickCount - prevState.lastTickCount, 0);
+
+	if (&prevState != this) {
+		scoreLine = prevState.scoreLine;
+		lastTouchCarID = prevState.lastTouchCarID;
+	}
 
 	deltaTime = tickSkip * (1 / 120.f);
 
 	ballState = arena->ball->GetState();
 	ball = PhysObj(ballState);
-	ballInv = ball.Invert();
 
 	players.resize(arena->_cars.size());
 
 	auto carItr = arena->_cars.begin();
 	for (int i = 0; i < players.size(); i++) {
 		auto& player = players[i];
-		player.UpdateFromCar(*carItr, arena->tickCount, tickSkip);
+		player.UpdateFromCar(*carItr, arena->tickCount, tickSkip, (i < prevState.players.size()) ? prevState.players[i] : player);
 		if (player.ballTouchedStep)
 			lastTouchCarID = player.carId;
 
@@ -82,17 +125,9 @@ void RLGSC::GameState::UpdateFromArena(Arena* arena) {
 	}
 
 	for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++) {
-		int idx = boostPadIndexMap[i];
-		int invIdx = boostPadIndexMap[CommonValues::BOOST_LOCATIONS_AMOUNT - i - 1];
-
-		auto state = arena->_boostPads[idx]->GetState();
-		auto stateInv = arena->_boostPads[invIdx]->GetState();
-
+		auto state = arena->_boostPads[boostPadIndexMap[i]]->GetState();
 		boostPads[i] = state.isActive;
-		boostPadsInv[i] = stateInv.isActive;
-
 		boostPadTimers[i] = state.cooldown;
-		boostPadTimersInv[i] = stateInv.cooldown;
 	}
 
 	// Update goal scoring
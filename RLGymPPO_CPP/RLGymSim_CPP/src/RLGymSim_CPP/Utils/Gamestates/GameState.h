@@ -1,5 +1,6 @@
 #pragma once
 #include "PlayerData.h"
+#include "StateFeatures.h"
 #include "../CommonValues.h"
 
 namespace RLGSC {
@@ -24,13 +25,17 @@ namespace RLGSC {
 		std::vector<PlayerData> players;
 
 		BallState ballState;
-		PhysObj ball, ballInv;
+		PhysObj ball;
 
 		std::array<bool, CommonValues::BOOST_LOCATIONS_AMOUNT> boostPads;
-		std::array<bool, CommonValues::BOOST_LOCATIONS_AMOUNT> boostPadsInv;
-
 		std::array<float, CommonValues::BOOST_LOCATIONS_AMOUNT> boostPadTimers;
-		std::array<float, CommonValues::BOOST_LOCATIONS_AMOUNT> boostPadTimersInv;
+
+		// Inverted versions of the above, only computed once something asks for them after each update
+		// Use GetBallPhys(), GetBoostPads(), and GetBoostPadTimers() instead of reading these
+		mutable PhysObj _ballInv;
+		mutable std::array<bool, CommonValues::BOOST_LOCATIONS_AMOUNT> _boostPadsInv;
+		mutable std::array<float, CommonValues::BOOST_LOCATIONS_AMOUNT> _boostPadTimersInv;
+		mutable uint64_t _invertedVersion = 0;
 
 		// Last arena we updated with
 		// Can be used to determine current arena from within reward function, for example
@@ -40,19 +45,101 @@ namespace RLGSC {
 		// Last tick count when updated
 		uint64_t lastTickCount = 0;
 
+		// Gets a new version whenever it is copied, so a copy never shares caches with its source
+		struct _Version {
+			uint64_t val = MakeVersion();
+
+			_Version() = default;
+			_Version(const _Version& other) : val(MakeVersion()) {}
+			_Version& operator=(const _Version& other) {
+				val = MakeVersion();
+				return *this;
+			}
+			_Version& operator=(uint64_t newVal) {
+				val = newVal;
+				return *this;
+			}
+
+			operator uint64_t() const { return val; }
+		};
+
+		// Unique to each update or copy of a state
+		// Caches derived from a state (e.g. features) are only valid while its version stays the same
+		_Version _version = {};
+
+		mutable StateFeatures _features = {};
+		mutable uint64_t _featuresVersion = 0;
+
 		GameState() = default;
 		explicit GameState(Arena* arena) {
 			UpdateFromArena(arena);
 		}
 
 		const PhysObj& GetBallPhys(bool inverted) const {
-			return inverted ? ballInv : ball;
+			if (!inverted)
+				return ball;
+
+			UpdateInverted();
+			return _ballInv;
 		}
 
 		const auto& GetBoostPads(bool inverted) const {
-			return inverted ? boostPadsInv : boostPads;
+			if (!inverted)
+				return boostPads;
+
+			UpdateInverted();
+			return _boostPadsInv;
+		}
+
+		const auto& GetBoostPadTimers(bool inverted) const {
+			if (!inverted)
+				return boostPadTimers;
+
+			UpdateInverted();
+			return _boostPadTimersInv;
+		}
+
+		// Replacements for the old public ballInv, boostPadsInv, and boostPadTimersInv members
+		// Code that read "state.ballInv" should now call "state.GetBallInv()" (or "state.GetBallPhys(true)")
+		const PhysObj& GetBallInv() const { return GetBallPhys(true); }
+		const auto& GetBoostPadsInv() const { return GetBoostPads(true); }
+		const auto& GetBoostPadTimersInv() const { return GetBoostPadTimers(true); }
+
+		void UpdateInverted() const {
+			if (_invertedVersion != _version)
+				_UpdateInverted();
+		}
+		void _UpdateInverted() const;
+
+		// Computed on first use after each update, so this isn't thread-safe until it has been called once
+		// NOTE: If you change a state by hand, call Invalidate() afterwards
+		const StateFeatures& GetFeatures() const {
+			if (_featuresVersion != _version) {
+				_features.Update(*this);
+				_featuresVersion = _version;
+			}
+			return _features;
+		}
+
+		// Returns -1 if the player isn't in this state
+		int GetPlayerIndex(const PlayerData& player) const;
+
+		const PlayerFeatures& GetPlayerFeatures(const PlayerData& player) const;
+
+		void Invalidate() {
+			_version = MakeVersion();
+			for (auto& player : players)
+				player._physInvValid = false;
+		}
+
+		static uint64_t MakeVersion();
+
+		void UpdateFromArena(Arena* arena) {
+			UpdateFromArena(arena, *this);
 		}
 
-		void UpdateFromArena(Arena* arena);
+		// Persistent info (score, last touch, match stats) is carried over from prevState (which can be this)
+		// Lets a spare state be updated without copying the whole previous state into it first
+		void UpdateFromArena(Arena* arena, const GameState& prevState);
 	};
 }
\ No newline at end of file
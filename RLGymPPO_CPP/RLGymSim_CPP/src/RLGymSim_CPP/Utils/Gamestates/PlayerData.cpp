@@ -1,21 +1,34 @@
 #include "PlayerData.h"
 
 namespace RLGSC {
-	void PlayerData::UpdateFromCar(Car* car, uint64_t tickCount, int tickSkip) {
+	void PlayerData::UpdateFromCar(Car* car, uint64_t tickCount, int tickSkip, const PlayerData& prevData) {
 		carId = car->id;
 		team = car->team;
-		CarState newState = car->GetState();
 
-		if (newState.isDemoed && newState.pos.z == -50000) {
-			newState.pos = carState.pos;
-			newState.vel = carState.vel;
-			newState.angVel = carState.angVel;
+		if (&prevData != this) {
+			matchGoals = prevData.matchGoals;
+			matchSaves = prevData.matchSaves;
+			matchAssists = prevData.matchAssists;
+			matchShots = prevData.matchShots;
+			matchShotPasses = prevData.matchShotPasses;
+			matchBumps = prevData.matchBumps;
+			matchDemos = prevData.matchDemos;
+			boostPickups = prevData.boostPickups;
 		}
 
-		carState = newState;
+		// Saved before overwriting, as prevData can be us
+		Vec prevPos = prevData.carState.pos, prevVel = prevData.carState.vel, prevAngVel = prevData.carState.angVel;
+
+		carState = car->GetState();
+
+		if (carState.isDemoed && carState.pos.z == -50000) {
+			carState.pos = prevPos;
+			carState.vel = prevVel;
+			carState.angVel = prevAngVel;
+		}
 
 		phys = PhysObj(carState);
-		physInv = PhysObj(phys.Invert());
+		_physInvValid = false;
 
 		if (carState.ballHitInfo.isValid) {
 			ballTouchedStep = carState.ballHitInfo.tickCountWhenHit >= (tickCount - tickSkip);
@@ -8,9 +8,13 @@ namespace RLGSC {
 		uint32_t carId;
 		Team team;
 
-		PhysObj phys, physInv;
+		PhysObj phys;
 		CarState carState;
 
+		// Only computed once something asks for it after each update, use GetPhys() instead of reading this
+		mutable PhysObj _physInv;
+		mutable bool _physInvValid = false;
+
 		// matchAssists: being the passer to a teammate who shot and scored
 		// matchBumps: any bump against an opponent, including demos
 		int
@@ -30,10 +34,25 @@ namespace RLGSC {
 		bool ballTouchedStep; // True if the player touched the ball during any of tick of the step
 		bool ballTouchedTick; // True if the player is touching the ball on the final tick of the step
 
-		void UpdateFromCar(Car* car, uint64_t tickCount, int tickSkip);
+		void UpdateFromCar(Car* car, uint64_t tickCount, int tickSkip) {
+			UpdateFromCar(car, tickCount, tickSkip, *this);
+		}
+
+		// Match stats and the last non-demoed position are carried over from prevData (which can be this)
+		void UpdateFromCar(Car* car, uint64_t tickCount, int tickSkip, const PlayerData& prevData);
 
 		const PhysObj& GetPhys(bool inverted) const {
-			return inverted ? physInv : phys;
+			if (!inverted)
+				return phys;
+
+			if (!_physInvValid) {
+				_physInv = phys.Invert();
+				_physInvValid = true;
+			}
+			return _physInv;
 		}
+
+		// Replacement for the old public physInv member, code that read "player.physInv" should now call "player.GetPhysInv()"
+		const PhysObj& GetPhysInv() const { return GetPhys(true); }
 	};
 }
\ No newline at end of file
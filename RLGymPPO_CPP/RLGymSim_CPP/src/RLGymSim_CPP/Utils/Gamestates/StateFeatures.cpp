@@ -0,0 +1,31 @@
+#include "StateFeatures.h"
+#include "GameState.h"
+
+void RLGSC::StateFeatures::Update(const GameState& state) {
+	using namespace CommonValues;
+
+	players.resize(state.players.size());
+	for (auto& team : teams)
+		team.playerIndices.clear();
+
+	for (int i = 0; i < state.players.size(); i++) {
+		auto& player = state.players[i];
+		auto& features = players[i];
+
+		Vec ballRelPos = state.ball.pos - player.phys.pos;
+		features.ballDist = ballRelPos.Length();
+		features.dirToBall = ballRelPos.Normalized();
+		features.normVel = player.phys.vel / CAR_MAX_SPEED;
+
+		teams[(int)player.team].playerIndices.push_back(i);
+	}
+
+	Vec blueDirToGoal = (ORANGE_GOAL_BACK - state.ball.pos).Normalized();
+	Vec orangeDirToGoal = (BLUE_GOAL_BACK - state.ball.pos).Normalized();
+	teams[(int)Team::BLUE].ballDirToOppGoal = blueDirToGoal;
+	teams[(int)Team::BLUE].ballDirToOwnGoal = orangeDirToGoal;
+	teams[(int)Team::ORANGE].ballDirToOppGoal = orangeDirToGoal;
+	teams[(int)Team::ORANGE].ballDirToOwnGoal = blueDirToGoal;
+
+	ballNormVel = state.ball.vel / BALL_MAX_SPEED;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "PlayerData.h"
+
+namespace RLGSC {
+	struct GameState;
+
+	// Values derived from a game state that many obs builders and rewards need for each player
+	// Computed once per state on first use, see GameState::GetFeatures()
+	struct PlayerFeatures {
+		float ballDist;
+		Vec dirToBall; // Normalized direction from the player to the ball
+		Vec normVel; // Velocity / CAR_MAX_SPEED
+	};
+
+	struct TeamFeatures {
+		// Indices of this team's players in GameState::players, in order
+		std::vector<int> playerIndices;
+
+		// Normalized directions from the ball to the back of each goal
+		Vec ballDirToOppGoal, ballDirToOwnGoal;
+	};
+
+	struct StateFeatures {
+		std::vector<PlayerFeatures> players;
+		TeamFeatures teams[2];
+
+		Vec ballNormVel; // Ball velocity / BALL_MAX_SPEED
+
+		// Keeps capacity, so features of a reused state don't allocate
+		void Update(const GameState& state);
+	};
+}
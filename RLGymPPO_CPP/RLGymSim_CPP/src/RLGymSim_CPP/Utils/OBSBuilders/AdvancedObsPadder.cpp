@@ -11,9 +11,89 @@ void AdvancedObsPadder::Reset(const GameState& initialState) {
 	// No-op for this OBS builder
 }
 
+void AdvancedObsPadder::PreStep(const GameState& state) {
+	auto& teams = state.GetFeatures().teams;
+	for (int inv = 0; inv < 2; inv++) {
+		// Only build the sides that have players, see DefaultOBS::PreStep()
+		if (teams[inv].playerIndices.empty())
+			continue;
+
+		const PhysObj& ball = state.GetBallPhys(inv);
+		const auto& pads = state.GetBoostPads(inv);
+
+		FList& ballSegment = _ballSegments[inv];
+		ballSegment.clear();
+		ballSegment += ball.pos / POS_STD;
+		ballSegment += ball.vel / POS_STD;
+		ballSegment += ball.angVel / ANG_STD;
+
+		FList& padSegment = _padSegments[inv];
+		padSegment.clear();
+		for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++)
+			padSegment += (float)pads[i];
+
+		_playerSegments[inv].resize(state.players.size());
+		for (int i = 0; i < state.players.size(); i++) {
+			_playerSegments[inv][i].clear();
+			AddPlayerToOBS(_playerSegments[inv][i], state.players[i], ball, inv);
+		}
+	}
+
+	_segmentsVersion = state._version;
+}
+
+void AdvancedObsPadder::BuildOBSFromSegments(int playerIdx, const PlayerData& player, const GameState& state, const Action& prevAction, FList& obs) {
+	bool inverted = (player.team == Team::ORANGE);
+	auto& teams = state.GetFeatures().teams;
+	auto& playerSegments = _playerSegments[inverted];
+	const PhysObj& playerCar = player.GetPhys(inverted);
+
+	obs += _ballSegments[inverted];
+	for (int i = 0; i < 8; i++)
+		obs += prevAction[i];
+	obs += _padSegments[inverted];
+	obs += playerSegments[playerIdx];
+
+	// Allies (up to teamSize-1), then enemies (up to teamSize), padding missing slots
+	for (int i = 0; i < 2; i++) {
+		bool allies = (i == 0);
+		int maxCount = allies ? (teamSize - 1) : teamSize;
+		int count = 0;
+		for (int otherIdx : teams[allies ? (int)player.team : 1 - (int)player.team].playerIndices) {
+			if (otherIdx == playerIdx) continue;
+			if (count >= maxCount) break;
+
+			const PhysObj& otherCar = state.players[otherIdx].GetPhys(inverted);
+			obs += playerSegments[otherIdx];
+			obs += (otherCar.pos - playerCar.pos) / POS_STD;
+			obs += (otherCar.vel - playerCar.vel) / POS_STD;
+			count++;
+		}
+
+		while (count < maxCount) {
+			AddDummy(obs);
+			count++;
+		}
+	}
+}
+
 FList AdvancedObsPadder::BuildOBS(const PlayerData& player, const GameState& state, const Action& prevAction) {
 	FList obs;
 	obs.reserve(237); // Pre-allocate memory for efficiency
+	BuildOBSInto(player, state, prevAction, obs);
+	return obs;
+}
+
+void AdvancedObsPadder::BuildOBSInto(const PlayerData& player, const GameState& state, const Action& prevAction, FList& obs) {
+	obs.clear();
+
+	if (state._version == _segmentsVersion) {
+		int playerIdx = state.GetPlayerIndex(player);
+		if (playerIdx != -1) {
+			BuildOBSFromSegments(playerIdx, player, state, prevAction, obs);
+			return;
+		}
+	}
 
 	// Determine if we need inverted coordinates (Orange team)
 	bool inverted = (player.team == Team::ORANGE);
@@ -42,26 +122,13 @@ FList AdvancedObsPadder::BuildOBS(const PlayerData& player, const GameState& sta
 	// 6. Add player car data and get reference for relative calculations
 	const PhysObj& playerCar = AddPlayerToOBS(obs, player, ball, inverted);
 
-	// 7. Process allies and enemies
-	std::vector<const PlayerData*> allies;
-	std::vector<const PlayerData*> enemies;
-	
-	for (const auto& other : state.players) {
-		if (other.carId == player.carId) continue;
-		
-		if (other.team == player.team) {
-			allies.push_back(&other);
-		} else {
-			enemies.push_back(&other);
-		}
-	}
-
-	// 8. Add allies data (up to teamSize-1)
+	// 7. Add allies data (up to teamSize-1)
 	int allyCount = 0;
-	for (const auto* ally : allies) {
+	for (const auto& ally : state.players) {
+		if (ally.carId == player.carId || ally.team != player.team) continue;
 		if (allyCount >= teamSize - 1) break;
 		
-		const PhysObj& otherCar = AddPlayerToOBS(obs, *ally, ball, inverted);
+		const PhysObj& otherCar = AddPlayerToOBS(obs, ally, ball, inverted);
 		
 		// Extra info: relative position and velocity to player
 		obs += (otherCar.pos - playerCar.pos) / POS_STD;
@@ -76,12 +143,13 @@ FList AdvancedObsPadder::BuildOBS(const PlayerData& player, const GameState& sta
 		allyCount++;
 	}
 
-	// 9. Add enemies data (up to teamSize)
+	// 8. Add enemies data (up to teamSize)
 	int enemyCount = 0;
-	for (const auto* enemy : enemies) {
+	for (const auto& enemy : state.players) {
+		if (enemy.team == player.team) continue;
 		if (enemyCount >= teamSize) break;
 		
-		const PhysObj& otherCar = AddPlayerToOBS(obs, *enemy, ball, inverted);
+		const PhysObj& otherCar = AddPlayerToOBS(obs, enemy, ball, inverted);
 		
 		// Extra info: relative position and velocity to player
 		obs += (otherCar.pos - playerCar.pos) / POS_STD;
@@ -103,24 +171,14 @@ FList AdvancedObsPadder::BuildOBS(const PlayerData& player, const GameState& sta
 		// version uses np.expand_dims(np.concatenate(obs), 0) which adds a batch dimension
 		// In C++, this is typically handled at a higher level
 	}
-
-	return obs;
 }
 
 void AdvancedObsPadder::AddDummy(FList& obs) {
-	// Add dummy player data (26 floats for player info)
-	obs += FList(3, 0.0f); // rel_pos
-	obs += FList(3, 0.0f); // rel_vel
-	obs += FList(3, 0.0f); // position
-	obs += FList(3, 0.0f); // forward
-	obs += FList(3, 0.0f); // up
-	obs += FList(3, 0.0f); // linear_velocity
-	obs += FList(3, 0.0f); // angular_velocity
-	obs += FList{0.0f, 0.0f, 0.0f, 0.0f, 0.0f}; // [boost, on_ground, has_flip, is_demoed, has_jump]
-	
-	// Add dummy relative position and velocity (6 floats)
-	obs += FList(3, 0.0f); // relative position difference
-	obs += FList(3, 0.0f); // relative velocity difference
+	// Dummy player data (26 floats for player info):
+	//	rel_pos, rel_vel, position, forward, up, linear_velocity, angular_velocity,
+	//	[boost, on_ground, has_flip, is_demoed, has_jump]
+	// Then dummy relative position and velocity (6 floats)
+	obs.insert(obs.end(), 26 + 6, 0.0f);
 }
 
 const PhysObj& AdvancedObsPadder::AddPlayerToOBS(FList& obs, const PlayerData& player, const PhysObj& ball, bool inverted) {
@@ -13,13 +13,24 @@ namespace RLGSC {
 		// Use teamSize=3 for standard 1v1, 2v2, and 3v3 matches.
 		AdvancedObsPadder(int teamSize = 3, bool expanding = false);
 
+		// Segments of the obs that are the same for every player of a team (index 1 is inverted)
+		// Built once in PreStep(), then copied by BuildOBSInto() for the state they were built from
+		uint64_t _segmentsVersion = 0;
+		FList _ballSegments[2], _padSegments[2];
+		FList2 _playerSegments[2];
+
 		virtual void Reset(const GameState& initialState) override;
+		virtual void PreStep(const GameState& state) override;
 		virtual FList BuildOBS(const PlayerData& player, const GameState& state, const Action& prevAction) override;
+		virtual void BuildOBSInto(const PlayerData& player, const GameState& state, const Action& prevAction, FList& obs) override;
 
 	private:
 		// Adds a block of 32 zeros to pad a missing player.
 		void AddDummy(FList& obs);
 
+		// Same as BuildOBSInto(), but copies the segments built in PreStep()
+		void BuildOBSFromSegments(int playerIdx, const PlayerData& player, const GameState& state, const Action& prevAction, FList& obs);
+
 		// Adds a player's information to the observation list.
 		const PhysObj& AddPlayerToOBS(FList& obs, const PlayerData& player, const PhysObj& ball, bool inv);
 	};
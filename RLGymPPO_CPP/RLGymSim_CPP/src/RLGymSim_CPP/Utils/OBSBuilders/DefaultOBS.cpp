@@ -17,11 +17,67 @@ void RLGSC::DefaultOBS::AddPlayerToOBS(FList& obs, const PlayerData& player, boo
 	};
 }
 
-RLGSC::FList RLGSC::DefaultOBS::BuildOBS(const PlayerData& player, const GameState& state, const Action& prevAction) {
-	FList result = {};
+void RLGSC::DefaultOBS::PreStep(const GameState& state) {
+	auto& teams = state.GetFeatures().teams;
+	for (int inv = 0; inv < 2; inv++) {
+		// Each side's segments are only used by that team (blue is normal, orange is inverted),
+		//	so a side without players is skipped and the state is never inverted for blue-only games
+		if (teams[inv].playerIndices.empty())
+			continue;
+
+		auto& ball = state.GetBallPhys(inv);
+		auto& pads = state.GetBoostPads(inv);
+
+		FList& ballSegment = _ballSegments[inv];
+		ballSegment.clear();
+		ballSegment += ball.pos * posCoef;
+		ballSegment += ball.vel * velCoef;
+		ballSegment += ball.angVel * angVelCoef;
+
+		FList& padSegment = _padSegments[inv];
+		padSegment.clear();
+		for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++)
+			padSegment += (float)pads[i];
+
+		_playerSegments[inv].resize(state.players.size());
+		for (int i = 0; i < state.players.size(); i++) {
+			_playerSegments[inv][i].clear();
+			AddPlayerToOBS(_playerSegments[inv][i], state.players[i], inv);
+		}
+	}
+
+	_segmentsVersion = state._version;
+}
+
+void RLGSC::DefaultOBS::BuildOBSInto(const PlayerData& player, const GameState& state, const Action& prevAction, FList& result) {
+	result.clear();
 
 	bool inv = player.team == Team::ORANGE;
 
+	int playerIdx = (state._version == _segmentsVersion) ? state.GetPlayerIndex(player) : -1;
+	if (playerIdx != -1) {
+		// Copy the segments built in PreStep()
+		auto& teams = state.GetFeatures().teams;
+
+		result += _ballSegments[inv];
+
+		for (int i = 0; i < prevAction.ELEM_AMOUNT; i++)
+			result += prevAction[i];
+
+		result += _padSegments[inv];
+		result += _playerSegments[inv][playerIdx];
+
+		// Teammates, then opponents
+		for (int otherIdx : teams[(int)player.team].playerIndices)
+			if (otherIdx != playerIdx)
+				result += _playerSegments[inv][otherIdx];
+
+		for (int otherIdx : teams[1 - (int)player.team].playerIndices)
+			result += _playerSegments[inv][otherIdx];
+
+		return;
+	}
+
 	auto& ball = state.GetBallPhys(inv);
 	auto& pads = state.GetBoostPads(inv);
 
@@ -37,20 +93,15 @@ RLGSC::FList RLGSC::DefaultOBS::BuildOBS(const PlayerData& player, const GameSta
 
 	AddPlayerToOBS(result, player, inv);
 
-	FList teammates = {}, opponents = {};
+	// Teammates, then opponents
+	for (int i = 0; i < 2; i++) {
+		bool teammates = (i == 0);
+		for (auto& otherPlayer : state.players) {
+			if (otherPlayer.carId == player.carId)
+				continue;
 
-	for (auto& otherPlayer : state.players) {
-		if (otherPlayer.carId == player.carId)
-			continue;
-
-		AddPlayerToOBS(
-			(otherPlayer.team == player.team) ? teammates : opponents,
-			otherPlayer,
-			inv
-		);
+			if ((otherPlayer.team == player.team) == teammates)
+				AddPlayerToOBS(result, otherPlayer, inv);
+		}
 	}
-
-	result += teammates;
-	result += opponents;
-	return result;
 }
\ No newline at end of file
@@ -16,8 +16,22 @@ namespace RLGSC {
 
 		}
 
+		// Segments of the obs that are the same for every player of a team (index 1 is inverted)
+		// Built once in PreStep(), then copied by BuildOBSInto() for the state they were built from
+		uint64_t _segmentsVersion = 0;
+		FList _ballSegments[2], _padSegments[2];
+		FList2 _playerSegments[2];
+
 		void AddPlayerToOBS(FList& obs, const PlayerData& player, bool inv);
 
-		virtual FList BuildOBS(const PlayerData& player, const GameState& state, const Action& prevAction);
+		virtual void PreStep(const GameState& state);
+
+		virtual FList BuildOBS(const PlayerData& player, const GameState& state, const Action& prevAction) {
+			FList result = {};
+			DefaultOBS::BuildOBSInto(player, state, prevAction, result);
+			return result;
+		}
+
+		virtual void BuildOBSInto(const PlayerData& player, const GameState& state, const Action& prevAction, FList& obs);
 	};
 }
\ No newline at end of file
@@ -19,6 +19,14 @@ namespace RLGSC {
 
 		}
 
+		// Doesn't use the shared segments of DefaultOBS
+		virtual void PreStep(const GameState& state) {}
+
 		virtual FList BuildOBS(const PlayerData& player, const GameState& state, const Action& prevAction);
+
+		// Slot shuffling still builds each player separately, so this isn't allocation-free
+		virtual void BuildOBSInto(const PlayerData& player, const GameState& state, const Action& prevAction, FList& obs) {
+			obs = BuildOBS(player, state, prevAction);
+		}
 	};
 }
\ No newline at end of file
@@ -13,5 +13,11 @@ namespace RLGSC {
 
 		// NOTE: May be called once during environment initialization to determine policy neuron size
 		virtual FList BuildOBS(const PlayerData& player, const GameState& state, const Action& prevAction) = 0;
+
+		// Same as BuildOBS(), but overwrites obs so its capacity is reused between steps
+		// Override this to build observations without allocating
+		virtual void BuildOBSInto(const PlayerData& player, const GameState& state, const Action& prevAction, FList& obs) {
+			obs = BuildOBS(player, state, prevAction);
+		}
 	};
 }
\ No newline at end of file
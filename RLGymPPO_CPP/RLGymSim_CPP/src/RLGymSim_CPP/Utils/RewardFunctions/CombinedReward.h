@@ -1,5 +1,5 @@
 #pragma once
-#include "RewardFunction.h"
+#include "RewardBatch.h"
 
 // https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/combined_reward.py
 namespace RLGSC {
@@ -9,6 +9,10 @@ namespace RLGSC {
 		std::vector<float> rewardWeights;
 		bool ownsFuncs;
 
+		// Reused between steps
+		std::vector<float> _childRewards;
+		std::vector<RewardFunction*> _batchChildFuncs;
+
 		CombinedReward(std::vector<RewardFunction*> rewardFuncs, std::vector<float> rewardWeights, bool ownsFuncs = false) :
 			rewardFuncs(rewardFuncs), rewardWeights(rewardWeights), ownsFuncs(ownsFuncs) {
 			assert(rewardFuncs.size() == rewardWeights.size());
@@ -33,16 +37,48 @@ namespace RLGSC {
 				func->PreStep(state);
 		}
 
-		virtual std::vector<float> GetAllRewards(const GameState& state, const ActionSet& prevAction, bool final) {
-			std::vector<float> allRewards(state.players.size());
+		virtual void GetAllRewardsInto(const GameState& state, const ActionSet& prevAction, bool final, float* allRewards) {
+			int playerAmount = state.players.size();
+			std::fill(allRewards, allRewards + playerAmount, 0.f);
+			_childRewards.resize(playerAmount);
 
 			for (int i = 0; i < rewardFuncs.size(); i++) {
-				auto rewards = rewardFuncs[i]->GetAllRewards(state, prevAction, final);
-				for (int j = 0; j < rewards.size(); j++)
-					allRewards[j] += rewards[j] * rewardWeights[i];
+				rewardFuncs[i]->GetAllRewardsInto(state, prevAction, final, _childRewards.data());
+				for (int j = 0; j < playerAmount; j++)
+					allRewards[j] += _childRewards[j] * rewardWeights[i];
+			}
+		}
+
+		// Each term is evaluated for all games at once, then weighted by each game's own weights
+		// Terms whose reward functions differ in type between games are evaluated per-game, see EvaluateBatch()
+		virtual void GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* allRewards) {
+			int gameAmount = batch.GetGameAmount();
+			int playerAmount = batch.GetPlayerAmount();
+
+			// Games with a different amount of terms can't be evaluated term-by-term
+			for (int j = 0; j < gameAmount; j++) {
+				if (((CombinedReward*)gameFuncs[j])->rewardFuncs.size() != rewardFuncs.size()) {
+					RewardFunction::GetBatchRewards(batch, gameFuncs, allRewards);
+					return;
+				}
 			}
 
-			return allRewards;
+			std::fill(allRewards, allRewards + playerAmount, 0.f);
+			_childRewards.resize(playerAmount);
+			_batchChildFuncs.resize(gameAmount);
+
+			for (int i = 0; i < rewardFuncs.size(); i++) {
+				for (int j = 0; j < gameAmount; j++)
+					_batchChildFuncs[j] = ((CombinedReward*)gameFuncs[j])->rewardFuncs[i];
+
+				EvaluateBatch(batch, _batchChildFuncs.data(), _childRewards.data());
+
+				for (int j = 0; j < gameAmount; j++) {
+					float weight = ((CombinedReward*)gameFuncs[j])->rewardWeights[i];
+					for (int k = batch.playerStarts[j]; k < batch.playerStarts[j + 1]; k++)
+						allRewards[k] += _childRewards[k] * weight;
+				}
+			}
 		}
 
 		virtual ~CombinedReward() {
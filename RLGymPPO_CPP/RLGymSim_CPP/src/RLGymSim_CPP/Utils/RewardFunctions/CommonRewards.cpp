@@ -1,5 +1,6 @@
 #pragma once
 #include "CommonRewards.h"
+#include "RewardBatch.h"
 
 RLGSC::EventReward::EventReward(WeightScales weightScales) {
 	for (int i = 0; i < ValSet::VAL_AMOUNT; i++)
@@ -39,4 +40,56 @@ float RLGSC::EventReward::GetReward(const PlayerData& player, const GameState& s
 
 	oldValues = newValues;
 	return reward;
-}
\ No newline at end of file
+}
+
+// Batched versions of the stateless rewards below use the same math as GetReward(), but read from the batch columns
+// Parameters are read from each game's own instance, as they can differ between games
+
+void RLGSC::VelocityReward::GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards) {
+	for (int j = 0; j < batch.GetGameAmount(); j++) {
+		bool gameIsNegative = ((VelocityReward*)gameFuncs[j])->isNegative;
+		for (int i = batch.playerStarts[j]; i < batch.playerStarts[j + 1]; i++)
+			rewards[i] = batch.carVel[i].Length() / CommonValues::CAR_MAX_SPEED * (1 - 2 * gameIsNegative);
+	}
+}
+
+void RLGSC::SaveBoostReward::GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards) {
+	for (int j = 0; j < batch.GetGameAmount(); j++) {
+		float gameExponent = ((SaveBoostReward*)gameFuncs[j])->exponent;
+		for (int i = batch.playerStarts[j]; i < batch.playerStarts[j + 1]; i++)
+			rewards[i] = RS_CLAMP(powf(batch.boostFractions[i], gameExponent), 0, 1);
+	}
+}
+
+void RLGSC::VelocityBallToGoalReward::GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards) {
+	for (int j = 0; j < batch.GetGameAmount(); j++) {
+		auto& ballDirToGoal = ((VelocityBallToGoalReward*)gameFuncs[j])->ownGoal ? batch.ballDirToOwnGoal : batch.ballDirToOppGoal;
+		for (int i = batch.playerStarts[j]; i < batch.playerStarts[j + 1]; i++)
+			rewards[i] = ballDirToGoal[i].Dot(batch.ballNormVel[i]);
+	}
+}
+
+void RLGSC::VelocityPlayerToBallReward::GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards) {
+	for (int i = 0; i < batch.GetPlayerAmount(); i++)
+		rewards[i] = batch.dirToBall[i].Dot(batch.carNormVel[i]);
+}
+
+void RLGSC::FaceBallReward::GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards) {
+	for (int i = 0; i < batch.GetPlayerAmount(); i++)
+		rewards[i] = batch.carForward[i].Dot(batch.dirToBall[i]);
+}
+
+void RLGSC::TouchBallReward::GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards) {
+	using namespace CommonValues;
+
+	for (int j = 0; j < batch.GetGameAmount(); j++) {
+		float gameAerialWeight = ((TouchBallReward*)gameFuncs[j])->aerialWeight;
+		for (int i = batch.playerStarts[j]; i < batch.playerStarts[j + 1]; i++) {
+			if (batch.ballTouched[i]) {
+				rewards[i] = powf((batch.ballPos[i].z + BALL_RADIUS) / (BALL_RADIUS * 2), gameAerialWeight);
+			} else {
+				rewards[i] = 0;
+			}
+		}
+	}
+}
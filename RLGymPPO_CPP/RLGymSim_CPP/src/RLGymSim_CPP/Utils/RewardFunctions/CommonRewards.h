@@ -56,6 +56,8 @@ namespace RLGSC {
 		virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction) {
 			return player.phys.vel.Length() / CommonValues::CAR_MAX_SPEED * (1 - 2 * isNegative);
 		}
+
+		virtual void GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards);
 	};
 
 	// https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/common_rewards/misc_rewards.py
@@ -67,6 +69,8 @@ namespace RLGSC {
 		virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction) {
 			return RS_CLAMP(powf(player.boostFraction, exponent), 0, 1);
 		}
+
+		virtual void GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards);
 	};
 
 	// https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/common_rewards/ball_goal_rewards.py
@@ -76,34 +80,35 @@ namespace RLGSC {
 		VelocityBallToGoalReward(bool ownGoal = false) : ownGoal(ownGoal) {}
 
 		virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction) {
-			bool targetOrangeGoal = player.team == Team::BLUE;
-			if (ownGoal)
-				targetOrangeGoal = !targetOrangeGoal;
-
-			Vec targetPos = targetOrangeGoal ? CommonValues::ORANGE_GOAL_BACK : CommonValues::BLUE_GOAL_BACK;
-			
-			Vec ballDirToGoal = (targetPos - state.ball.pos).Normalized();
-			return ballDirToGoal.Dot(state.ball.vel / CommonValues::BALL_MAX_SPEED);
+			auto& features = state.GetFeatures();
+			auto& teamFeatures = features.teams[(int)player.team];
+
+			Vec ballDirToGoal = ownGoal ? teamFeatures.ballDirToOwnGoal : teamFeatures.ballDirToOppGoal;
+			return ballDirToGoal.Dot(features.ballNormVel);
 		}
+
+		virtual void GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards);
 	};
 
 	// https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/common_rewards/player_ball_rewards.py
 	class VelocityPlayerToBallReward : public RewardFunction {
 	public:
 		virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction) {
-			Vec dirToBall = (state.ball.pos - player.phys.pos).Normalized();
-			Vec normVel = player.phys.vel / CommonValues::CAR_MAX_SPEED;
-			return dirToBall.Dot(normVel);
+			auto& features = state.GetPlayerFeatures(player);
+			return features.dirToBall.Dot(features.normVel);
 		}
+
+		virtual void GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards);
 	};
 
 	// https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/common_rewards/player_ball_rewards.py
 	class FaceBallReward : public RewardFunction {
 	public:
 		virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction) {
-			Vec dirToBall = (state.ball.pos - player.phys.pos).Normalized();
-			return player.carState.rotMat.forward.Dot(dirToBall);
+			return player.carState.rotMat.forward.Dot(state.GetPlayerFeatures(player).dirToBall);
 		}
+
+		virtual void GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards);
 	};
 
 	// https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/common_rewards/player_ball_rewards.py
@@ -121,5 +126,7 @@ namespace RLGSC {
 				return 0;
 			}
 		}
+
+		virtual void GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "RewardBatch.h"
+
+void RLGSC::RewardBatch::Clear() {
+	states.clear();
+	prevActions.clear();
+	finals.clear();
+	rewardFuncs.clear();
+	playerStarts.clear();
+
+	players.clear();
+	gameIndices.clear();
+	teams.clear();
+	carPos.clear();
+	carVel.clear();
+	carForward.clear();
+	boostFractions.clear();
+	ballTouched.clear();
+	ballPos.clear();
+	ballVel.clear();
+	dirToBall.clear();
+	carNormVel.clear();
+	ballDirToOppGoal.clear();
+	ballDirToOwnGoal.clear();
+	ballNormVel.clear();
+
+	rewards.clear();
+}
+
+void RLGSC::RewardBatch::AddGame(const GameState& state, const ActionSet& prevActions, bool final, RewardFunction* rewardFn) {
+	int gameIdx = states.size();
+
+	states.push_back(&state);
+	this->prevActions.push_back(&prevActions);
+	finals.push_back(final);
+	rewardFuncs.push_back(rewardFn);
+
+	if (playerStarts.empty())
+		playerStarts.push_back(0);
+
+	auto& features = state.GetFeatures();
+	for (int i = 0; i < state.players.size(); i++) {
+		auto& player = state.players[i];
+		auto& playerFeatures = features.players[i];
+		auto& teamFeatures = features.teams[(int)player.team];
+
+		players.push_back(&player);
+		gameIndices.push_back(gameIdx);
+		teams.push_back(player.team);
+		carPos.push_back(player.phys.pos);
+		carVel.push_back(player.phys.vel);
+		carForward.push_back(player.phys.rotMat.forward);
+		boostFractions.push_back(player.boostFraction);
+		ballTouched.push_back(player.ballTouchedStep);
+		ballPos.push_back(state.ball.pos);
+		ballVel.push_back(state.ball.vel);
+		dirToBall.push_back(playerFeatures.dirToBall);
+		carNormVel.push_back(playerFeatures.normVel);
+		ballDirToOppGoal.push_back(teamFeatures.ballDirToOppGoal);
+		ballDirToOwnGoal.push_back(teamFeatures.ballDirToOwnGoal);
+		ballNormVel.push_back(features.ballNormVel);
+	}
+
+	playerStarts.push_back(players.size());
+}
+
+void RLGSC::RewardBatch::Evaluate() {
+	rewards.resize(players.size());
+	if (states.empty())
+		return;
+
+	for (int i = 0; i < states.size(); i++)
+		rewardFuncs[i]->PreStep(*states[i]);
+
+	RewardFunction::EvaluateBatch(*this, rewardFuncs.data(), rewards.data());
+}
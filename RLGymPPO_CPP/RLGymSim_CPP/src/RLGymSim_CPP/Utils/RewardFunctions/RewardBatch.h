@@ -0,0 +1,56 @@
+#pragma once
+#include "RewardFunction.h"
+#include "../BasicTypes/Lists.h"
+
+namespace RLGSC {
+	// Structure-of-arrays view of every player in a set of games (e.g. all of the games stepped by one thread)
+	// Lets each reward term be evaluated once for all games, instead of once per game with a virtual call per player
+	// Fastest when the reward functions of all games have the same structure (as they do when made by the same env create func),
+	//	terms that differ in type between games are evaluated per-game instead
+	struct RewardBatch {
+		// Per game
+		std::vector<const GameState*> states;
+		std::vector<const ActionSet*> prevActions;
+		std::vector<uint8_t> finals;
+		std::vector<RewardFunction*> rewardFuncs;
+		std::vector<int> playerStarts; // Index of each game's first player, followed by the total player amount
+
+		// Per player, across all games
+		std::vector<const PlayerData*> players;
+		std::vector<int> gameIndices;
+		std::vector<Team> teams;
+		std::vector<Vec> carPos, carVel, carForward;
+		std::vector<float> boostFractions;
+		std::vector<uint8_t> ballTouched;
+		std::vector<Vec> ballPos, ballVel; // Of each player's game
+
+		// From each game's GameState::GetFeatures()
+		std::vector<Vec> dirToBall, carNormVel;
+		std::vector<Vec> ballDirToOppGoal, ballDirToOwnGoal, ballNormVel;
+
+		// Reward of each player, written by Evaluate()
+		FList rewards;
+
+		int GetGameAmount() const { return states.size(); }
+		int GetPlayerAmount() const { return players.size(); }
+
+		const GameState& GetState(int playerIdx) const { return *states[gameIndices[playerIdx]]; }
+		const Action& GetPrevAction(int playerIdx) const {
+			int gameIdx = gameIndices[playerIdx];
+			return (*prevActions[gameIdx])[playerIdx - playerStarts[gameIdx]];
+		}
+		bool IsFinal(int playerIdx) const { return finals[gameIndices[playerIdx]]; }
+
+		// Keeps capacity, so a batch reused every step doesn't allocate
+		void Clear();
+
+		void AddGame(const GameState& state, const ActionSet& prevActions, bool final, RewardFunction* rewardFn);
+
+		// Calls PreStep() on each game's reward function, then computes all rewards
+		void Evaluate();
+
+		const float* GetGameRewards(int gameIdx) const {
+			return rewards.data() + playerStarts[gameIdx];
+		}
+	};
+}
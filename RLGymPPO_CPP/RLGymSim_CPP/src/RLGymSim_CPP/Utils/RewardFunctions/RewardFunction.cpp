@@ -0,0 +1,22 @@
+#include "RewardFunction.h"
+#include "RewardBatch.h"
+
+void RLGSC::RewardFunction::GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards) {
+	for (int i = 0; i < batch.GetGameAmount(); i++) {
+		int start = batch.playerStarts[i];
+		gameFuncs[i]->GetAllRewardsInto(*batch.states[i], *batch.prevActions[i], batch.finals[i], rewards + start);
+	}
+}
+
+void RLGSC::RewardFunction::EvaluateBatch(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards) {
+	// Overrides of GetBatchRewards() cast every game's instance to their own type
+	const std::type_info& type = typeid(*gameFuncs[0]);
+	for (int i = 1; i < batch.GetGameAmount(); i++) {
+		if (typeid(*gameFuncs[i]) != type) {
+			gameFuncs[0]->RewardFunction::GetBatchRewards(batch, gameFuncs, rewards);
+			return;
+		}
+	}
+
+	gameFuncs[0]->GetBatchRewards(batch, gameFuncs, rewards);
+}
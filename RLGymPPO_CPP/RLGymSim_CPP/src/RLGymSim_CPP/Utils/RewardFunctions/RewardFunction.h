@@ -4,6 +4,8 @@
 
 // https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/reward_function.py
 namespace RLGSC {
+	struct RewardBatch;
+
 	class RewardFunction {
 	public:
 		virtual void Reset(const GameState& initialState) {}
@@ -20,9 +22,15 @@ namespace RLGSC {
 		}
 
 		// Get all rewards for all players
-		virtual std::vector<float> GetAllRewards(const GameState& state, const ActionSet& prevActions, bool final) {
-
+		// To change how all rewards are computed, override GetAllRewardsInto() instead
+		std::vector<float> GetAllRewards(const GameState& state, const ActionSet& prevActions, bool final) {
 			std::vector<float> rewards = std::vector<float>(state.players.size());
+			GetAllRewardsInto(state, prevActions, final, rewards.data());
+			return rewards;
+		}
+
+		// Writes the rewards of all players to rewards, which has room for state.players.size()
+		virtual void GetAllRewardsInto(const GameState& state, const ActionSet& prevActions, bool final, float* rewards) {
 			for (int i = 0; i < state.players.size(); i++) {
 				if (final) {
 					rewards[i] = GetFinalReward(state.players[i], state, prevActions[i]);
@@ -30,10 +38,19 @@ namespace RLGSC {
 					rewards[i] = GetReward(state.players[i], state, prevActions[i]);
 				}
 			}
-
-			return rewards;
 		}
 
+		// Writes the rewards of every player of every game in the batch to rewards
+		// gameFuncs[i] is game i's own instance of this reward function (gameFuncs[0] is this), all of the same type
+		// The default runs GetAllRewardsInto() on each game's instance
+		// Rewards that don't keep any per-game state can override this to compute all games at once from the batch columns
+		// Don't call this directly, use EvaluateBatch()
+		virtual void GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards);
+
+		// Calls GetBatchRewards() if every game's reward function is the same type,
+		//	otherwise runs GetAllRewardsInto() on each game's instance
+		static void EvaluateBatch(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards);
+
 		virtual ~RewardFunction() {};
 	};
-}
\ No newline at end of file
+}
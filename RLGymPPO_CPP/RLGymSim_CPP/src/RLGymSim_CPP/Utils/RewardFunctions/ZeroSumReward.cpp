@@ -1,8 +1,7 @@
 #include "ZeroSumReward.h"
+#include "RewardBatch.h"
 
-std::vector<float> RLGSC::ZeroSumReward::GetAllRewards(const GameState& state, const ActionSet& prevActions, bool final) {
-	std::vector<float> rewards = childFunc->GetAllRewards(state, prevActions, final);
-
+void RLGSC::ZeroSumReward::ApplyZeroSum(const GameState& state, float* rewards) {
 	int teamCounts[2] = {};
 	float avgTeamRewards[2] = {};
 
@@ -18,13 +17,28 @@ std::vector<float> RLGSC::ZeroSumReward::GetAllRewards(const GameState& state, c
 	for (int i = 0; i < state.players.size(); i++) {
 		auto& player = state.players[i];
 		int teamIdx = (int)player.team;
-		int teamCount = teamCounts[teamIdx];
 
 		rewards[i] =
 			rewards[i] * (1 - teamSpirit)
 			+ (avgTeamRewards[teamIdx] * teamSpirit)
 			- (avgTeamRewards[1 - teamIdx] * opponentScale);
 	}
+}
+
+void RLGSC::ZeroSumReward::GetAllRewardsInto(const GameState& state, const ActionSet& prevActions, bool final, float* rewards) {
+	childFunc->GetAllRewardsInto(state, prevActions, final, rewards);
+	ApplyZeroSum(state, rewards);
+}
+
+void RLGSC::ZeroSumReward::GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards) {
+	int gameAmount = batch.GetGameAmount();
+
+	_batchChildFuncs.resize(gameAmount);
+	for (int i = 0; i < gameAmount; i++)
+		_batchChildFuncs[i] = ((ZeroSumReward*)gameFuncs[i])->childFunc;
+
+	EvaluateBatch(batch, _batchChildFuncs.data(), rewards);
 
-	return rewards;
-}
\ No newline at end of file
+	for (int i = 0; i < gameAmount; i++)
+		((ZeroSumReward*)gameFuncs[i])->ApplyZeroSum(*batch.states[i], rewards + batch.playerStarts[i]);
+}
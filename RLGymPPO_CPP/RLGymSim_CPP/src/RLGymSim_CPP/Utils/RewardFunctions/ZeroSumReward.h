@@ -34,6 +34,14 @@ namespace RLGSC {
 		}
 
 		// Get all rewards for all players
-		virtual std::vector<float> GetAllRewards(const GameState& state, const ActionSet& prevActions, bool final);
+		virtual void GetAllRewardsInto(const GameState& state, const ActionSet& prevActions, bool final, float* rewards);
+
+		virtual void GetBatchRewards(const RewardBatch& batch, RewardFunction* const* gameFuncs, float* rewards);
+
+		// Reused between steps
+		std::vector<RewardFunction*> _batchChildFuncs;
+
+		// Makes the child rewards of one game zero-sum, in place
+		void ApplyZeroSum(const GameState& state, float* rewards);
 	};
 }
\ No newline at end of file
@@ -6,8 +6,8 @@
 constexpr float DEG_TO_RAD = 3.14159265f / 180.0f;
 
 RLGSC::GameState RLGSC::AerialState::ResetState(Arena* arena) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    // Thread-local engine, constructing and seeding one for every reset is slow
+    std::default_random_engine& gen = ::Math::GetRandEngine();
     std::uniform_real_distribution<float> rand_x_dist(-CommonValues::SIDE_WALL_X + CommonValues::BALL_RADIUS, CommonValues::SIDE_WALL_X - CommonValues::BALL_RADIUS);
     std::uniform_real_distribution<float> rand_y_dist(-CommonValues::BACK_WALL_Y + 1300, CommonValues::BACK_WALL_Y - 1300);
     std::uniform_real_distribution<float> rand_z_dist(100.0f, m_rand_z_max);
@@ -0,0 +1,65 @@
+#include "ArenaObjectStates.h"
+
+RLGSC::ArenaLayout RLGSC::ArenaLayout::FromArena(Arena* arena) {
+	ArenaLayout layout = {};
+	layout.gameMode = arena->gameMode;
+	layout.mutatorConfig = arena->GetMutatorConfig();
+
+	layout.carTeams.resize(arena->_cars.size());
+	layout.carConfigs.resize(arena->_cars.size());
+	for (Car* car : arena->_cars) {
+		int slot = ArenaObjectStates::GetCarSlot(arena, car);
+		layout.carTeams[slot] = car->team;
+		layout.carConfigs[slot] = car->config;
+	}
+
+	return layout;
+}
+
+Arena* RLGSC::ArenaLayout::MakeArena() const {
+	Arena* arena = Arena::Create(gameMode);
+	arena->SetMutatorConfig(mutatorConfig);
+	for (int i = 0; i < carTeams.size(); i++)
+		arena->AddCar(carTeams[i], carConfigs[i]);
+	return arena;
+}
+
+int RLGSC::ArenaObjectStates::GetCarSlot(Arena* arena, Car* car) {
+	// Car sets are tiny, so this is faster than sorting them into a list
+	int slot = 0;
+	for (Car* otherCar : arena->_cars)
+		if (otherCar->id < car->id)
+			slot++;
+	return slot;
+}
+
+void RLGSC::ArenaObjectStates::Capture(Arena* arena) {
+	ball = arena->ball->GetState();
+
+	cars.resize(arena->_cars.size());
+	for (Car* car : arena->_cars)
+		cars[GetCarSlot(arena, car)] = car->GetState();
+
+	boostPads.resize(arena->_boostPads.size());
+	for (int i = 0; i < arena->_boostPads.size(); i++)
+		boostPads[i] = arena->_boostPads[i]->GetState();
+}
+
+void RLGSC::ArenaObjectStates::Apply(Arena* arena) const {
+	constexpr const char* ERROR_PREFIX = "ArenaObjectStates::Apply(): ";
+
+	if (arena->_cars.size() != cars.size() || arena->_boostPads.size() != boostPads.size()) {
+		RG_ERR_CLOSE(
+			ERROR_PREFIX << "Arena has different objects than the states " <<
+			"(cars: " << arena->_cars.size() << "/" << cars.size() << ", boost pads: " << arena->_boostPads.size() << "/" << boostPads.size() << ")"
+		);
+	}
+
+	arena->ball->SetState(ball);
+
+	for (Car* car : arena->_cars)
+		car->SetState(cars[GetCarSlot(arena, car)]);
+
+	for (int i = 0; i < arena->_boostPads.size(); i++)
+		arena->_boostPads[i]->SetState(boostPads[i]);
+}
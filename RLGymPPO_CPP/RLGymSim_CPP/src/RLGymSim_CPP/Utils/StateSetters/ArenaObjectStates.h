@@ -0,0 +1,31 @@
+#pragma once
+#include "../../Framework.h"
+
+namespace RLGSC {
+	// Game mode, mutators, and cars of an arena, so an empty arena with the same cars can be made (e.g. on another thread)
+	struct ArenaLayout {
+		GameMode gameMode = GameMode::SOCCAR;
+		MutatorConfig mutatorConfig = MutatorConfig(GameMode::SOCCAR);
+		std::vector<Team> carTeams; // In car ID order
+		std::vector<CarConfig> carConfigs;
+
+		static ArenaLayout FromArena(Arena* arena);
+
+		// Cars are added in the same order, so they get the same IDs
+		Arena* MakeArena() const;
+	};
+
+	// Everything a state setter changes in an arena, in a form that can be applied to another arena with the same cars
+	struct ArenaObjectStates {
+		BallState ball;
+		std::vector<CarState> cars; // In car ID order
+		std::vector<BoostPadState> boostPads;
+
+		// Keeps capacity, so capturing into the same states again doesn't allocate
+		void Capture(Arena* arena);
+		void Apply(Arena* arena) const;
+
+		// Index of the car among all cars of its arena, sorted by ID
+		static int GetCarSlot(Arena* arena, Car* car);
+	};
+}
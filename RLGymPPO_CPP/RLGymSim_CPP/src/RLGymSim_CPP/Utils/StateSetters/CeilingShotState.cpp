@@ -8,8 +8,8 @@ constexpr float DEG_TO_RAD = 3.14159265f / 180.0f;
 constexpr float CEILING_HEIGHT = 2044.0f; // Rocket League ceiling height
 
 RLGSC::GameState RLGSC::CeilingShotState::ResetState(Arena* arena) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    // Thread-local engine, constructing and seeding one for every reset is slow
+    std::default_random_engine& gen = ::Math::GetRandEngine();
     
     // Position ranges for ceiling shots - avoid corners and walls
     std::uniform_real_distribution<float> rand_x_dist(-2500.0f, 2500.0f);
@@ -0,0 +1,120 @@
+#include "StateLibrary.h"
+
+using namespace RLGSC;
+
+RLGSC::StateLibrary::StateLibrary(StateSetterCreateFn setterCreateFn, int size, int threadAmount, float refreshDelay) :
+	setterCreateFn(setterCreateFn), size(size), threadAmount(threadAmount), refreshDelay(refreshDelay) {
+
+	constexpr const char* ERROR_PREFIX = "StateLibrary::StateLibrary(): ";
+
+	if (size <= 0)
+		RG_ERR_CLOSE(ERROR_PREFIX << "Size must be above 0 (got " << size << ")");
+}
+
+void RLGSC::StateLibrary::Fill(Arena* templateArena) {
+	if (_filled)
+		return;
+
+	std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>(_fillMutex);
+	if (_filled)
+		return;
+
+	_layout = ArenaLayout::FromArena(templateArena);
+
+	int numThreads = (threadAmount > 0) ? threadAmount : RS_MAX((int)std::thread::hardware_concurrency(), 1);
+	numThreads = RS_MIN(numThreads, size);
+
+	RG_LOG("StateLibrary: Generating " << size << " states with " << numThreads << " thread(s)...");
+	auto startTime = std::chrono::steady_clock::now();
+
+	_entries.resize(size);
+
+	std::vector<std::thread> threads = {};
+	for (int i = 0; i < numThreads; i++) {
+		threads.push_back(std::thread(
+			[this, i, numThreads] {
+				Arena* arena = _layout.MakeArena();
+				StateSetter* stateSetter = setterCreateFn();
+
+				for (int j = i; j < size; j += numThreads) {
+					stateSetter->ResetState(arena);
+					_entries[j].Capture(arena);
+				}
+
+				delete stateSetter;
+				delete arena;
+			}
+		));
+	}
+
+	for (auto& thread : threads)
+		thread.join();
+
+	float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+	RG_LOG(" > Done in " << elapsed << "s");
+
+	if (refreshDelay > 0)
+		_refreshThread = std::thread(&StateLibrary::_RunRefresh, this);
+
+	_filled = true;
+}
+
+void RLGSC::StateLibrary::Restore(Arena* arena) {
+	constexpr const char* ERROR_PREFIX = "StateLibrary::Restore(): ";
+
+	Fill(arena);
+
+	if (arena->_cars.size() != _layout.carTeams.size())
+		RG_ERR_CLOSE(ERROR_PREFIX << "Arena has a different amount of cars than the library (" << arena->_cars.size() << "/" << _layout.carTeams.size() << ")");
+
+	for (Car* car : arena->_cars)
+		if (car->team != _layout.carTeams[ArenaObjectStates::GetCarSlot(arena, car)])
+			RG_ERR_CLOSE(ERROR_PREFIX << "Car with ID " << car->id << " is on a different team than in the library");
+
+	int index = std::uniform_int_distribution<int>(0, size - 1)(::Math::GetRandEngine());
+
+	std::shared_lock<std::shared_mutex> lock;
+	if (refreshDelay > 0)
+		lock = std::shared_lock<std::shared_mutex>(_entriesMutex);
+
+	_entries[index].Apply(arena);
+}
+
+void RLGSC::StateLibrary::_RunRefresh() {
+	Arena* arena = _layout.MakeArena();
+	StateSetter* stateSetter = setterCreateFn();
+	ArenaObjectStates newEntry = {};
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock = std::unique_lock<std::mutex>(_refreshMutex);
+			_refreshCondition.wait_for(lock, std::chrono::duration<float>(refreshDelay), [this] { return _stopRefresh; });
+			if (_stopRefresh)
+				break;
+		}
+
+		// Generated before locking, so resets only wait for the swap
+		stateSetter->ResetState(arena);
+		newEntry.Capture(arena);
+
+		int index = std::uniform_int_distribution<int>(0, size - 1)(::Math::GetRandEngine());
+		{
+			std::unique_lock<std::shared_mutex> lock = std::unique_lock<std::shared_mutex>(_entriesMutex);
+			std::swap(_entries[index], newEntry);
+		}
+	}
+
+	delete stateSetter;
+	delete arena;
+}
+
+RLGSC::StateLibrary::~StateLibrary() {
+	if (_refreshThread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>(_refreshMutex);
+			_stopRefresh = true;
+		}
+		_refreshCondition.notify_all();
+		_refreshThread.join();
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "StateSetter.h"
+#include "ArenaObjectStates.h"
+#include <shared_mutex>
+#include <condition_variable>
+
+namespace RLGSC {
+	typedef std::function<StateSetter*()> StateSetterCreateFn;
+
+	// Library of pre-generated reset states, meant to be shared between all games (see LibraryStateSetter)
+	// Filled once in parallel by running a state setter on worker arenas, so a reset is just applying a random entry
+	class StateLibrary {
+	public:
+		// Called once for each worker thread, the state setters are deleted when done
+		StateSetterCreateFn setterCreateFn;
+
+		int size;
+		int threadAmount; // Threads used to fill the library, 0 to use all cores
+
+		// If above 0, a background thread replaces a random entry with a new one this often
+		// Keeps a small library from repeating the same states for the whole run
+		float refreshDelay;
+
+		StateLibrary(StateSetterCreateFn setterCreateFn, int size = 10'000, int threadAmount = 0, float refreshDelay = 0);
+
+		RG_NO_COPY(StateLibrary);
+
+		// Fills the library on the first call, with worker arenas that have the layout (game mode, mutators, cars) of templateArena
+		// Every arena restored from this library must have the same cars
+		void Fill(Arena* templateArena);
+
+		// Applies a random entry to the arena, filling the library first if needed
+		void Restore(Arena* arena);
+
+		~StateLibrary();
+
+		std::vector<ArenaObjectStates> _entries;
+		std::atomic<bool> _filled = false;
+		std::mutex _fillMutex;
+
+		// Only locked if the library is refreshed
+		std::shared_mutex _entriesMutex;
+
+		ArenaLayout _layout;
+
+		std::thread _refreshThread;
+		bool _stopRefresh = false;
+		std::mutex _refreshMutex;
+		std::condition_variable _refreshCondition;
+
+		void _RunRefresh();
+	};
+
+	class LibraryStateSetter : public StateSetter {
+	public:
+		std::shared_ptr<StateLibrary> library;
+
+		LibraryStateSetter(std::shared_ptr<StateLibrary> library) : library(library) {}
+
+		virtual GameState ResetState(Arena* arena) {
+			library->Restore(arena);
+			return GameState(arena);
+		}
+	};
+}
@@ -7,5 +7,7 @@ namespace RLGSC {
 
 		// NOTE: Applies reset state to arena
 		virtual GameState ResetState(Arena* arena) = 0;
+
+		virtual ~StateSetter() {}
 	};
 }
\ No newline at end of file
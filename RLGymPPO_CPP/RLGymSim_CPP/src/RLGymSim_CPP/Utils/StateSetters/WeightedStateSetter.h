@@ -53,12 +53,12 @@ public:
     }
 
     virtual GameState ResetState(Arena* arena) override {
-        // This logic is now restored: it randomly selects a state setter
-        // from the list based on the probabilities (weights) provided.
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::discrete_distribution<int> distribution(weights.begin(), weights.end());
-        int selectedIndex = distribution(gen);
+        // Randomly selects a state setter based on the probabilities (weights) provided
+        // Uses the thread-local engine, and the weights are summed once in initializeWeights()
+        double roll = std::uniform_real_distribution<double>(0, cumulativeWeights.back())(::Math::GetRandEngine());
+        int selectedIndex = 0;
+        while (selectedIndex < cumulativeWeights.size() - 1 && roll >= cumulativeWeights[selectedIndex])
+            selectedIndex++;
 
         // Call the ResetState function of the randomly selected state setter
         return stateSetters[selectedIndex].first->ResetState(arena);
@@ -66,12 +66,16 @@ public:
 
 private:
     std::vector<std::pair<std::unique_ptr<StateSetter>, double>> stateSetters;
-    std::vector<double> weights;
+    std::vector<double> weights, cumulativeWeights;
 
     void initializeWeights() {
         weights.clear();
+        cumulativeWeights.clear();
+        double total = 0;
         for (const auto& pair : stateSetters) {
             weights.push_back(pair.second);
+            total += pair.second;
+            cumulativeWeights.push_back(total);
         }
     }
 };
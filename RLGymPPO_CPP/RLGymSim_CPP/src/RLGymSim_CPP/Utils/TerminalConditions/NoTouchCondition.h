@@ -26,5 +26,13 @@ namespace RLGSC {
 			stepsSinceTouch++;
 			return stepsSinceTouch >= maxSteps;
 		}
+
+		virtual void SerializeProgress(DataStreamOut& out) const {
+			out.Write<int32_t>(stepsSinceTouch);
+		}
+
+		virtual void DeserializeProgress(DataStreamIn& in) {
+			stepsSinceTouch = in.Read<int32_t>();
+		}
 	};
 }
\ No newline at end of file
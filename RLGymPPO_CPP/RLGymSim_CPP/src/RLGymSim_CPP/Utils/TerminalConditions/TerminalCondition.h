@@ -6,5 +6,10 @@ namespace RLGSC {
 	public:
 		virtual void Reset(const GameState& initialState) {};
 		virtual bool IsTerminal(const GameState& currentState) = 0;
+
+		// Save/restore progress through the current episode, so a restored episode ends at the same time
+		// Only needed if the condition has state that isn't reset by Reset()
+		virtual void SerializeProgress(DataStreamOut& out) const {}
+		virtual void DeserializeProgress(DataStreamIn& in) {}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "Tracing.h"
+
+using namespace RLGSC;
+using namespace RLGSC::Tracing;
+
+std::atomic<bool> RLGSC::Tracing::g_Enabled = false;
+
+static std::mutex g_BuffersMutex = {};
+static std::vector<ThreadBuffer*> g_Buffers = {}; // Never freed, threads may exit before their events are dumped
+static thread_local ThreadBuffer* g_ThreadBuffer = NULL;
+
+static const auto g_StartTime = std::chrono::steady_clock::now();
+
+uint64_t RLGSC::Tracing::NowNs() {
+	// Never 0, so 0 can mean "not recording"
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_StartTime).count() + 1;
+}
+
+ThreadBuffer* RLGSC::Tracing::GetThreadBuffer() {
+	if (!g_ThreadBuffer) {
+		std::lock_guard<std::mutex> lock(g_BuffersMutex);
+		g_ThreadBuffer = new ThreadBuffer();
+		g_ThreadBuffer->threadID = g_Buffers.size();
+		g_ThreadBuffer->threadName = "Thread " + std::to_string(g_ThreadBuffer->threadID);
+		g_Buffers.push_back(g_ThreadBuffer);
+	}
+
+	return g_ThreadBuffer;
+}
+
+void RLGSC::Tracing::SetThreadName(const std::string& name) {
+	ThreadBuffer* buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(g_BuffersMutex);
+	buffer->threadName = name;
+}
+
+static std::string EscapeJSONString(const std::string& str) {
+	std::string result = {};
+	for (char c : str) {
+		if (c == '"' || c == '\\')
+			result += '\\';
+		result += c;
+	}
+	return result;
+}
+
+bool RLGSC::Tracing::DumpChromeTrace(std::filesystem::path path) {
+	std::lock_guard<std::mutex> lock(g_BuffersMutex);
+
+	std::ofstream out = std::ofstream(path);
+	if (!out.good())
+		return false;
+
+	out << "{\"traceEvents\":[\n";
+	bool first = true;
+	for (ThreadBuffer* buffer : g_Buffers) {
+		if (!first)
+			out << ",\n";
+		first = false;
+
+		out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadID
+			<< ",\"args\":{\"name\":\"" << EscapeJSONString(buffer->threadName) << "\"}}";
+
+		// Events older than the buffer capacity have been overwritten
+		uint64_t endIdx = buffer->writeIdx.load(std::memory_order_acquire);
+		uint64_t startIdx = RS_MAX(buffer->dumpedIdx, (endIdx > BUFFER_CAPACITY) ? (endIdx - BUFFER_CAPACITY) : 0);
+
+		char line[256];
+		for (uint64_t i = startIdx; i < endIdx; i++) {
+			const Slot& slot = buffer->slots[i % BUFFER_CAPACITY];
+			uint64_t seqBefore = slot.seq.load(std::memory_order_acquire);
+			Event event = slot.event;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			uint64_t seqAfter = slot.seq.load(std::memory_order_relaxed);
+
+			// Overwritten by a newer event, either before or while we copied it
+			if (seqBefore != i * 2 + 2 || seqAfter != seqBefore)
+				continue;
+
+			snprintf(
+				line, sizeof(line),
+				",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				event.name, buffer->threadID, event.startNs / 1000.0, event.durNs / 1000.0
+			);
+			out << line;
+		}
+
+		buffer->dumpedIdx = endIdx;
+	}
+	out << "\n]}\n";
+
+	return out.good();
+}
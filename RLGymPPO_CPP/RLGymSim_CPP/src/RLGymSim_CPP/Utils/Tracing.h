@@ -0,0 +1,84 @@
+#pragma once
+#include "../Framework.h"
+
+// Low-overhead scoped timers, dumped as Chrome trace JSON (viewable in chrome://tracing or Perfetto)
+// Only compiled in with RG_TRACING, otherwise RG_TRACE_SCOPE() does nothing
+// Each thread records into its own ring buffer, so recording never takes a lock
+namespace RLGSC {
+	namespace Tracing {
+		struct Event {
+			const char* name; // Must be a string literal (or otherwise outlive the trace)
+			uint64_t startNs, durNs;
+		};
+
+		constexpr size_t BUFFER_CAPACITY = 1 << 16;
+
+		// The dump reads slots while their thread may be overwriting them,
+		//	so each slot has a sequence number to detect events that were overwritten or are mid-write
+		// The sequence is (idx * 2 + 1) while event idx is being written, then (idx * 2 + 2) once it is done
+		struct Slot {
+			std::atomic<uint64_t> seq = 0;
+			Event event;
+		};
+
+		struct ThreadBuffer {
+			Slot slots[BUFFER_CAPACITY];
+			std::atomic<uint64_t> writeIdx = 0;
+			uint64_t dumpedIdx = 0; // Only accessed when dumping
+			uint32_t threadID;
+			std::string threadName;
+		};
+
+		// Spans are only recorded while enabled
+		extern std::atomic<bool> g_Enabled;
+
+		uint64_t NowNs();
+
+		// Lazily creates the calling thread's buffer
+		ThreadBuffer* GetThreadBuffer();
+
+		// Name shown for the calling thread in the trace
+		void SetThreadName(const std::string& name);
+
+		inline void Record(const char* name, uint64_t startNs, uint64_t endNs) {
+			ThreadBuffer* buffer = GetThreadBuffer();
+			uint64_t idx = buffer->writeIdx.load(std::memory_order_relaxed);
+			Slot& slot = buffer->slots[idx % BUFFER_CAPACITY];
+			slot.seq.store(idx * 2 + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			slot.event = { name, startNs, endNs - startNs };
+			slot.seq.store(idx * 2 + 2, std::memory_order_release);
+			buffer->writeIdx.store(idx + 1, std::memory_order_release);
+		}
+
+		// Writes all events recorded since the last dump (up to BUFFER_CAPACITY per thread)
+		// Threads can keep recording during the dump, events they overwrite before they are read are skipped
+		// Returns false if the file couldn't be written
+		bool DumpChromeTrace(std::filesystem::path path);
+
+		struct ScopedSpan {
+			const char* name;
+			uint64_t startNs;
+
+			ScopedSpan(const char* name) : name(name) {
+				startNs = g_Enabled.load(std::memory_order_relaxed) ? NowNs() : 0;
+			}
+
+			~ScopedSpan() {
+				if (startNs)
+					Record(name, startNs, NowNs());
+			}
+		};
+	}
+}
+
+#define _RG_TRACE_CONCAT_INNER(a, b) a##b
+#define _RG_TRACE_CONCAT(a, b) _RG_TRACE_CONCAT_INNER(a, b)
+
+#ifdef RG_TRACING
+#define RG_TRACE_SCOPE(name) RLGSC::Tracing::ScopedSpan _RG_TRACE_CONCAT(_traceSpan, __LINE__) = RLGSC::Tracing::ScopedSpan(name)
+#define RG_TRACE_THREAD_NAME(name) RLGSC::Tracing::SetThreadName(name)
+#else
+#define RG_TRACE_SCOPE(name) {}
+#define RG_TRACE_THREAD_NAME(name) {}
+#endif
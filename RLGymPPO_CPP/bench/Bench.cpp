@@ -0,0 +1,169 @@
+#include "Bench.h"
+
+#include <RLGymPPO_CPP/FrameworkTorch.h>
+#include "../libsrc/json/nlohmann/json.hpp"
+
+using namespace RLGPC;
+using namespace RLGPC::Bench;
+
+typedef std::chrono::steady_clock BenchClock;
+
+std::mt19937_64 RLGPC::Bench::Context::Reseed() const {
+	::Math::GetRandEngine().seed(seed);
+	torch::manual_seed(seed);
+	return std::mt19937_64(seed);
+}
+
+std::vector<BenchDef>& RLGPC::Bench::GetRegistry() {
+	static std::vector<BenchDef> registry = {};
+	return registry;
+}
+
+void RLGPC::Bench::Register(std::string name, SetupFn setup, bool needsSim, int samples) {
+	GetRegistry().push_back(BenchDef{ name, setup, needsSim, samples });
+}
+
+static double TimeOps(const OpFn& op, uint64_t amount) {
+	auto start = BenchClock::now();
+	for (uint64_t i = 0; i < amount; i++)
+		op();
+	return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+Result RLGPC::Bench::Run(const BenchDef& def, const Context& ctx, const RunConfig& config) {
+	Result result = {};
+	result.name = def.name;
+
+	if (def.needsSim && !ctx.simAvailable) {
+		result.skipped = true;
+		return result;
+	}
+
+	ctx.Reseed();
+	OpFn op = def.setup(ctx);
+
+	// Warm up, also gives us a rough time per op
+	uint64_t warmupOps = 0;
+	double warmupTime = 0;
+	while (warmupTime < config.warmupTime || warmupOps < 2) {
+		warmupTime += TimeOps(op, 1);
+		warmupOps++;
+	}
+	double estTimePerOp = warmupTime / warmupOps;
+
+	result.opsPerSample = RS_MAX((uint64_t)ceil(config.minSampleTime / estTimePerOp), 1);
+	result.samples = def.samples > 0 ? def.samples : config.samples;
+
+	// Counters are read around each sample rather than each op, so reading them isn't counted
+	std::unique_ptr<PerfCounters::ThreadGroup> perfGroup = NULL;
+	if (config.perfCounters)
+		perfGroup = std::make_unique<PerfCounters::ThreadGroup>();
+	PerfCounters::Values perfTotal = {};
+
+	std::vector<double> timesPerOp = {};
+	for (int i = 0; i < result.samples; i++) {
+		PerfCounters::ScopedSample perfSample = PerfCounters::ScopedSample(perfGroup.get(), &perfTotal);
+		timesPerOp.push_back(TimeOps(op, result.opsPerSample) * 1e9 / result.opsPerSample);
+	}
+
+	if (perfGroup && perfGroup->IsAvailable()) {
+		result.hasPerf = true;
+		uint64_t totalOps = result.opsPerSample * result.samples;
+		for (int i = 0; i < PerfCounters::COUNTER_AMOUNT; i++)
+			result.perfPerOp[i] = (double)perfTotal[i] / totalOps;
+		result.ipc = perfTotal.GetIPC();
+	}
+
+	std::sort(timesPerOp.begin(), timesPerOp.end());
+	size_t mid = timesPerOp.size() / 2;
+	result.medianNs = (timesPerOp.size() % 2) ? timesPerOp[mid] : (timesPerOp[mid - 1] + timesPerOp[mid]) / 2;
+	result.minNs = timesPerOp.front();
+
+	for (double time : timesPerOp)
+		result.meanNs += time;
+	result.meanNs /= timesPerOp.size();
+
+	for (double time : timesPerOp)
+		result.stdDevNs += (time - result.meanNs) * (time - result.meanNs);
+	result.stdDevNs = sqrt(result.stdDevNs / timesPerOp.size());
+
+	return result;
+}
+
+std::string RLGPC::Bench::ResultsToJSON(const std::vector<Result>& results, const Context& ctx) {
+	nlohmann::json j = {};
+	j["seed"] = ctx.seed;
+	j["results"] = nlohmann::json::array();
+	for (auto& result : results) {
+		nlohmann::json resultJSON = {};
+		resultJSON["name"] = result.name;
+		resultJSON["skipped"] = result.skipped;
+		if (!result.skipped) {
+			resultJSON["samples"] = result.samples;
+			resultJSON["ops_per_sample"] = result.opsPerSample;
+			resultJSON["median_ns"] = result.medianNs;
+			resultJSON["mean_ns"] = result.meanNs;
+			resultJSON["min_ns"] = result.minNs;
+			resultJSON["stddev_ns"] = result.stdDevNs;
+
+			if (result.hasPerf) {
+				nlohmann::json perfJSON = {};
+				for (int i = 0; i < PerfCounters::COUNTER_AMOUNT; i++)
+					perfJSON[PerfCounters::COUNTER_NAMES[i]] = result.perfPerOp[i];
+				perfJSON["IPC"] = result.ipc;
+				resultJSON["perf_per_op"] = perfJSON;
+			}
+		}
+		j["results"].push_back(resultJSON);
+	}
+	return j.dump(4);
+}
+
+int RLGPC::Bench::CompareToBaseline(const std::vector<Result>& results, std::filesystem::path baselinePath, double tolerance) {
+	std::ifstream in = std::ifstream(baselinePath);
+	if (!in.good())
+		RG_ERR_CLOSE("Bench: Failed to open baseline " << baselinePath);
+
+	nlohmann::json baselineJSON;
+	try {
+		baselineJSON = nlohmann::json::parse(in);
+	} catch (std::exception& e) {
+		RG_ERR_CLOSE("Bench: Failed to parse baseline " << baselinePath << ", exception: " << e.what());
+	}
+
+	std::map<std::string, double> baselineMedians = {};
+	for (auto& resultJSON : baselineJSON["results"])
+		if (!resultJSON["skipped"].get<bool>())
+			baselineMedians[resultJSON["name"]] = resultJSON["median_ns"];
+
+	int numRegressions = 0;
+	RG_LOG("Comparing to " << baselinePath << " (tolerance: " << (tolerance * 100) << "%):");
+	for (auto& result : results) {
+		if (result.skipped)
+			continue;
+
+		auto itr = baselineMedians.find(result.name);
+		if (itr == baselineMedians.end()) {
+			RG_LOG(" > [NEW]        " << result.name);
+			continue;
+		}
+
+		double ratio = result.medianNs / itr->second;
+		const char* status;
+		if (ratio > 1 + tolerance) {
+			status = "[REGRESSION] ";
+			numRegressions++;
+		} else if (ratio < 1 - tolerance) {
+			status = "[IMPROVED]   ";
+		} else {
+			status = "[OK]         ";
+		}
+
+		RG_LOG(
+			" > " << status << result.name << ": " << std::fixed << std::setprecision(1)
+			<< itr->second << "ns -> " << result.medianNs << "ns (" << std::showpos << ((ratio - 1) * 100) << std::noshowpos << "%)"
+		);
+	}
+
+	return numRegressions;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <RLGymPPO_CPP/Framework.h>
+#include <RLGymPPO_CPP/Util/PerfCounters.h>
+#include <functional>
+
+// Microbenchmark harness for RLGymPPO_CPP_Bench
+// Every benchmark is seeded from the same seed, so runs with the same seed time the same work
+namespace RLGPC {
+	namespace Bench {
+		struct Context {
+			uint64_t seed;
+			bool simAvailable; // False if RocketSim couldn't be initialized (e.g. no collision meshes)
+
+			// Reseeds RocketSim, torch, and returns a fresh engine for the benchmark's own randomness
+			std::mt19937_64 Reseed() const;
+		};
+
+		// Runs one operation of the benchmark, this is what gets timed
+		typedef std::function<void()> OpFn;
+
+		// Builds everything the benchmark needs (not timed), then returns the operation to time
+		typedef std::function<OpFn(const Context& ctx)> SetupFn;
+
+		struct BenchDef {
+			std::string name;
+			SetupFn setup;
+			bool needsSim;
+			int samples; // 0 to use the default amount, set lower for very slow operations
+		};
+
+		std::vector<BenchDef>& GetRegistry();
+
+		void Register(std::string name, SetupFn setup, bool needsSim = false, int samples = 0);
+
+		struct RunConfig {
+			int samples = 15;
+			double minSampleTime = 0.01; // Seconds, operations are repeated until a sample takes at least this long
+			double warmupTime = 0.1;
+			bool perfCounters = false; // Also measure hardware counters over the timed samples
+		};
+
+		struct Result {
+			std::string name;
+			bool skipped = false;
+			int samples = 0;
+			uint64_t opsPerSample = 0;
+			double medianNs = 0, meanNs = 0, minNs = 0, stdDevNs = 0; // Per operation
+
+			bool hasPerf = false;
+			double perfPerOp[PerfCounters::COUNTER_AMOUNT] = {};
+			double ipc = 0;
+		};
+
+		Result Run(const BenchDef& def, const Context& ctx, const RunConfig& config);
+
+		std::string ResultsToJSON(const std::vector<Result>& results, const Context& ctx);
+
+		// Compares the median of each result to a baseline written by ResultsToJSON()
+		// Prints a table and returns the amount of benchmarks slower than (1 + tolerance) * baseline
+		int CompareToBaseline(const std::vector<Result>& results, std::filesystem::path baselinePath, double tolerance);
+
+		// Keeps the compiler from optimizing away results
+		template <typename T>
+		inline void DoNotOptimize(const T& val) {
+#ifdef _MSC_VER
+			static volatile const void* sink;
+			sink = &val;
+			_ReadWriteBarrier();
+#else
+			asm volatile("" : : "g"(&val) : "memory");
+#endif
+		}
+
+		// Each group of benchmarks adds itself through one of these
+		void RegisterSimBenches();
+		void RegisterPPOBenches();
+	}
+}
@@ -0,0 +1,123 @@
+#include "Bench.h"
+
+using namespace RLGPC;
+using namespace RLGPC::Bench;
+
+constexpr const char* USAGE =
+	"Usage: RLGymPPO_CPP_Bench [options]\n"
+	"  --seed <n>             Seed for all benchmarks (default: 123)\n"
+	"  --filter <text>        Only run benchmarks with names containing this text\n"
+	"  --out <path>           Where to write the JSON results (default: bench_results.json)\n"
+	"  --compare <path>       Compare against a baseline JSON written by --out, exits with code 2 on regressions\n"
+	"  --tolerance <frac>     Allowed slowdown before a benchmark counts as a regression (default: 0.1)\n"
+	"  --samples <n>          Samples per benchmark (default: 15)\n"
+	"  --min-sample-time <s>  Minimum time per sample in seconds (default: 0.01)\n"
+	"  --meshes <path>        RocketSim collision meshes folder (default: ./collision_meshes)\n"
+	"  --perf                 Also measure hardware counters per op (Linux perf_event_open)\n"
+	"  --list                 List all benchmarks and exit\n";
+
+int main(int argc, char* argv[]) {
+	Context ctx = {};
+	ctx.seed = 123;
+	RunConfig runConfig = {};
+	std::string filter = {};
+	std::filesystem::path outPath = "bench_results.json";
+	std::filesystem::path comparePath = {};
+	double tolerance = 0.1;
+	std::filesystem::path meshesPath = "./collision_meshes";
+	bool listOnly = false;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+
+		auto fnNextArg = [&]() -> std::string {
+			if (i + 1 >= argc)
+				RG_ERR_CLOSE("Missing value for argument " << arg << "\n" << USAGE);
+			return argv[++i];
+		};
+
+		if (arg == "--seed") {
+			ctx.seed = std::stoull(fnNextArg());
+		} else if (arg == "--filter") {
+			filter = fnNextArg();
+		} else if (arg == "--out") {
+			outPath = fnNextArg();
+		} else if (arg == "--compare") {
+			comparePath = fnNextArg();
+		} else if (arg == "--tolerance") {
+			tolerance = std::stod(fnNextArg());
+		} else if (arg == "--samples") {
+			runConfig.samples = std::stoi(fnNextArg());
+		} else if (arg == "--min-sample-time") {
+			runConfig.minSampleTime = std::stod(fnNextArg());
+		} else if (arg == "--meshes") {
+			meshesPath = fnNextArg();
+		} else if (arg == "--perf") {
+			runConfig.perfCounters = true;
+		} else if (arg == "--list") {
+			listOnly = true;
+		} else {
+			RG_ERR_CLOSE("Unknown argument " << arg << "\n" << USAGE);
+		}
+	}
+
+	RegisterSimBenches();
+	RegisterPPOBenches();
+
+	if (listOnly) {
+		for (auto& def : GetRegistry())
+			RG_LOG(def.name);
+		return EXIT_SUCCESS;
+	}
+
+	ctx.simAvailable = std::filesystem::exists(meshesPath);
+	if (ctx.simAvailable) {
+		RocketSim::Init(meshesPath, true);
+	} else {
+		RG_LOG("WARNING: Collision meshes not found at " << meshesPath << ", skipping benchmarks that need RocketSim");
+	}
+
+	std::vector<Result> results = {};
+	for (auto& def : GetRegistry()) {
+		if (!filter.empty() && def.name.find(filter) == std::string::npos)
+			continue;
+
+		Result result = Run(def, ctx, runConfig);
+		if (result.skipped) {
+			RG_LOG(def.name << ": skipped");
+		} else {
+			RG_LOG(
+				def.name << ": " << std::fixed << std::setprecision(1) << result.medianNs << "ns/op"
+				<< " (min: " << result.minNs << ", stddev: " << result.stdDevNs << ")"
+			);
+
+			if (result.hasPerf) {
+				std::stringstream perfStream;
+				perfStream << std::fixed << std::setprecision(1);
+				for (int i = 0; i < PerfCounters::COUNTER_AMOUNT; i++)
+					perfStream << PerfCounters::COUNTER_NAMES[i] << ": " << result.perfPerOp[i] << ", ";
+				perfStream << "IPC: " << std::setprecision(2) << result.ipc;
+				RG_LOG("\t" << perfStream.str());
+			}
+		}
+		results.push_back(result);
+	}
+
+	{
+		std::ofstream out = std::ofstream(outPath);
+		if (!out.good())
+			RG_ERR_CLOSE("Failed to write results to " << outPath);
+		out << ResultsToJSON(results, ctx);
+		RG_LOG("Wrote results to " << outPath);
+	}
+
+	if (!comparePath.empty()) {
+		int numRegressions = CompareToBaseline(results, comparePath, tolerance);
+		if (numRegressions > 0) {
+			RG_LOG(numRegressions << " benchmark(s) regressed");
+			return 2;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,199 @@
+#include "Bench.h"
+
+#include <RLGymPPO_CPP/PPO/PPOLearner.h>
+#include <RLGymPPO_CPP/Threading/GameTrajectory.h>
+#include <RLGymPPO_CPP/Util/TorchFuncs.h>
+
+using namespace RLGPC;
+using namespace RLGPC::Bench;
+
+// Roughly a 1v1 AdvancedObs with DiscreteAction
+constexpr int OBS_SIZE = 109;
+constexpr int ACTION_AMOUNT = 90;
+constexpr int64_t BATCH_SIZE = 50 * 1000;
+
+static const torch::Device CPU_DEVICE = torch::Device(torch::kCPU);
+
+// Random experience with the same shapes and types the learner collects
+static ExperienceTensors MakeExperience(int64_t size) {
+	ExperienceTensors result = {};
+	result.states = torch::randn({ size, OBS_SIZE });
+	result.actions = torch::randint(ACTION_AMOUNT, { size }, torch::kInt64);
+	result.logProbs = torch::rand({ size }).log();
+	result.rewards = torch::randn({ size });
+#ifdef RG_PARANOID_MODE
+	result.debugCounters = torch::arange(size);
+#endif
+	result.nextStates = torch::randn({ size, OBS_SIZE });
+	result.dones = (torch::rand({ size }) < 0.01f).to(torch::kFloat);
+	result.truncated = torch::zeros({ size });
+	result.policyVersions = torch::zeros({ size });
+	result.values = torch::randn({ size });
+	result.advantages = torch::randn({ size });
+	return result;
+}
+
+static TrajectoryTensors MakeSingleStep() {
+	return TrajectoryTensors{
+		torch::randn({ OBS_SIZE }),
+		torch::tensor((int64_t)0),
+		torch::tensor(-1.f),
+		torch::tensor(0.5f),
+#ifdef RG_PARANOID_MODE
+		torch::Tensor(),
+#endif
+		torch::randn({ OBS_SIZE }),
+		torch::tensor(0.f),
+		torch::tensor(0.f),
+		torch::tensor(0.f)
+	};
+}
+
+static void RegisterPolicyInfer() {
+	for (int batchSize : { 1, 16, 256, 4096 }) {
+		Register(RS_STR("DiscretePolicy::GetAction/batch=" << batchSize),
+			[=](const Context& ctx) -> OpFn {
+				ctx.Reseed();
+				auto policy = std::make_shared<DiscretePolicy>(OBS_SIZE, ACTION_AMOUNT, IList{ 256, 256, 256 }, CPU_DEVICE);
+				auto obs = torch::randn({ batchSize, OBS_SIZE });
+				return [policy, obs] {
+					RG_NOGRAD;
+					auto result = policy->GetAction(obs, false);
+					DoNotOptimize(result);
+				};
+			}
+		);
+	}
+}
+
+static void RegisterTrajectory() {
+	Register("GameTrajectory::AppendSingleStep",
+		[](const Context& ctx) -> OpFn {
+			ctx.Reseed();
+			auto traj = std::make_shared<GameTrajectory>();
+			auto step = MakeSingleStep();
+			return [traj, step] {
+				// Keep the trajectory around the size of a real one
+				if (traj->size >= 4096)
+					traj->Clear();
+				traj->AppendSingleStep(step);
+			};
+		}
+	);
+
+	constexpr int NUM_TRAJS = 64, TRAJ_SIZE = 512;
+	Register(RS_STR("GameTrajectory::MultiAppend/" << NUM_TRAJS << "x" << TRAJ_SIZE),
+		[=](const Context& ctx) -> OpFn {
+			ctx.Reseed();
+			auto trajs = std::make_shared<std::vector<GameTrajectory>>(NUM_TRAJS);
+			for (auto& traj : *trajs) {
+				auto exp = MakeExperience(TRAJ_SIZE);
+				traj.data = TrajectoryTensors{
+					exp.states, exp.actions, exp.logProbs, exp.rewards,
+#ifdef RG_PARANOID_MODE
+					exp.debugCounters,
+#endif
+					exp.nextStates, exp.dones, exp.truncated, exp.policyVersions
+				};
+				traj.size = traj.capacity = TRAJ_SIZE;
+			}
+
+			return [trajs] {
+				GameTrajectory result = {};
+				result.MultiAppend(*trajs);
+				DoNotOptimize(result);
+			};
+		}
+	);
+}
+
+static void RegisterGAE() {
+	Register(RS_STR("TorchFuncs::ComputeGAE/" << BATCH_SIZE),
+		[](const Context& ctx) -> OpFn {
+			auto rng = ctx.Reseed();
+			std::uniform_real_distribution<float> valDist = std::uniform_real_distribution<float>(-1, 1);
+
+			auto rews = std::make_shared<FList>(), dones = std::make_shared<FList>(), truncs = std::make_shared<FList>(), vals = std::make_shared<FList>();
+			for (int64_t i = 0; i < BATCH_SIZE; i++) {
+				rews->push_back(valDist(rng));
+				dones->push_back((rng() % 100) == 0);
+				truncs->push_back(0);
+				vals->push_back(valDist(rng));
+			}
+			vals->push_back(0); // Final next state
+
+			return [rews, dones, truncs, vals] {
+				torch::Tensor advantages, valueTargets;
+				FList returns;
+				TorchFuncs::ComputeGAE(*rews, *dones, *truncs, *vals, advantages, valueTargets, returns);
+				DoNotOptimize(returns);
+			};
+		}
+	);
+}
+
+static void RegisterExperienceBuffer() {
+	Register(RS_STR("ExperienceBuffer::SubmitExperience/" << BATCH_SIZE),
+		[](const Context& ctx) -> OpFn {
+			ctx.Reseed();
+			auto expBuffer = std::make_shared<ExperienceBuffer>(BATCH_SIZE * 3, ctx.seed, CPU_DEVICE);
+			auto exp = std::make_shared<ExperienceTensors>(MakeExperience(BATCH_SIZE));
+			return [expBuffer, exp] {
+				ExperienceTensors expCopy = *exp; // SubmitExperience() may slice what it's given
+				expBuffer->SubmitExperience(expCopy);
+			};
+		}
+	);
+
+	Register(RS_STR("ExperienceBuffer::GetAllBatchesShuffled/" << BATCH_SIZE),
+		[](const Context& ctx) -> OpFn {
+			ctx.Reseed();
+			auto expBuffer = std::make_shared<ExperienceBuffer>(BATCH_SIZE * 3, ctx.seed, CPU_DEVICE);
+			for (int i = 0; i < 3; i++) {
+				auto exp = MakeExperience(BATCH_SIZE);
+				expBuffer->SubmitExperience(exp);
+			}
+
+			return [expBuffer] {
+				auto batches = expBuffer->GetAllBatchesShuffled(BATCH_SIZE);
+				DoNotOptimize(batches);
+			};
+		}
+	);
+}
+
+// fp32 vs bf16 autocast (bf16 falls back to fp32 with a warning on CPUs without native bf16)
+static void RegisterLearn() {
+	for (bool autocast : { false, true }) {
+		Register(RS_STR("PPOLearner::Learn/batch=" << BATCH_SIZE << (autocast ? "/bf16" : "/fp32")),
+			[=](const Context& ctx) -> OpFn {
+				ctx.Reseed();
+
+				PPOLearnerConfig config = {};
+				config.batchSize = BATCH_SIZE;
+				config.miniBatchSize = BATCH_SIZE;
+				config.epochs = 1;
+				config.autocastLearn = autocast;
+
+				auto ppo = std::make_shared<PPOLearner>(OBS_SIZE, ACTION_AMOUNT, config, CPU_DEVICE);
+				auto expBuffer = std::make_shared<ExperienceBuffer>(BATCH_SIZE, ctx.seed, CPU_DEVICE);
+				auto exp = MakeExperience(BATCH_SIZE);
+				expBuffer->SubmitExperience(exp);
+
+				return [ppo, expBuffer] {
+					Report report = {};
+					ppo->Learn(expBuffer.get(), report);
+				};
+			},
+			false, 3
+		);
+	}
+}
+
+void RLGPC::Bench::RegisterPPOBenches() {
+	RegisterPolicyInfer();
+	RegisterTrajectory();
+	RegisterGAE();
+	RegisterExperienceBuffer();
+	RegisterLearn();
+}
@@ -0,0 +1,519 @@
+#include "Bench.h"
+
+#include <RLGymSim_CPP/Utils/RewardFunctions/CommonRewards.h>
+#include <RLGymSim_CPP/Utils/RewardFunctions/CombinedReward.h>
+#include <RLGymSim_CPP/Utils/RewardFunctions/RewardBatch.h>
+#include <RLGymSim_CPP/Utils/TerminalConditions/NoTouchCondition.h>
+#include <RLGymSim_CPP/Utils/TerminalConditions/GoalScoreCondition.h>
+#include <RLGymSim_CPP/Utils/OBSBuilders/DefaultOBS.h>
+#include <RLGymSim_CPP/Utils/OBSBuilders/AdvancedObsPadder.h>
+#include <RLGymSim_CPP/Utils/StateSetters/RandomState.h>
+#include <RLGymSim_CPP/Utils/StateSetters/KickoffState.h>
+#include <RLGymSim_CPP/Utils/ActionParsers/DiscreteAction.h>
+#include "../RLGymSim_CPP/RocketSim/src/Sim/BallPredTracker/BallPredTracker.h"
+#include "../RLGymSim_CPP/RocketSim/src/Sim/BallPredTracker/BallPredBatch.h"
+
+using namespace RLGPC;
+using namespace RLGPC::Bench;
+using namespace RLGSC;
+
+constexpr int TICK_SKIP = 8;
+
+// Random controls that stay the same for the whole benchmark, so cars actually move around
+static void RandomizeControls(Arena* arena, std::mt19937_64& rng) {
+	std::uniform_real_distribution<float> axisDist = std::uniform_real_distribution<float>(-1, 1);
+	for (Car* car : arena->GetCars()) {
+		CarControls controls = {};
+		controls.throttle = axisDist(rng);
+		controls.steer = axisDist(rng);
+		controls.pitch = axisDist(rng);
+		controls.yaw = axisDist(rng);
+		controls.roll = axisDist(rng);
+		controls.boost = rng() % 2;
+		controls.jump = (rng() % 4) == 0;
+		car->controls = controls;
+	}
+}
+
+static std::shared_ptr<Arena> MakeArena(int teamSize, bool randomState, std::mt19937_64& rng) {
+	auto arena = std::shared_ptr<Arena>(Arena::Create(GameMode::SOCCAR));
+	for (int i = 0; i < teamSize * 2; i++)
+		arena->AddCar(i < teamSize ? Team::BLUE : Team::ORANGE);
+
+	if (randomState) {
+		RandomState(true, true, false).ResetState(arena.get());
+	} else {
+		arena->ResetToRandomKickoff(rng() % INT_MAX);
+	}
+
+	RandomizeControls(arena.get(), rng);
+	return arena;
+}
+
+// Owns a gym and everything in its match
+struct BenchEnv {
+	Gym* gym;
+	Match* match;
+
+	~BenchEnv() {
+		delete gym;
+		delete match->rewardFn;
+		for (auto cond : match->terminalConditions)
+			delete cond;
+		delete match->obsBuilder;
+		delete match->actionParser;
+		delete match->stateSetter;
+		delete match;
+	}
+};
+
+static std::shared_ptr<BenchEnv> MakeEnv(int teamSize, bool advancedObs) {
+	auto rewardFn = new CombinedReward(
+		{
+			{ new FaceBallReward(), 0.1f },
+			{ new VelocityPlayerToBallReward(), 0.5f },
+			{ new VelocityBallToGoalReward(), 1.0f },
+			{ new EventReward({.teamGoal = 1.f, .concede = -1.f}), 50.f },
+		},
+		true
+	);
+
+	std::vector<TerminalCondition*> terminalConditions = {
+		new NoTouchCondition(10 * 120 / TICK_SKIP),
+		new GoalScoreCondition()
+	};
+
+	OBSBuilder* obsBuilder;
+	if (advancedObs) {
+		obsBuilder = new AdvancedObsPadder(3);
+	} else {
+		obsBuilder = new DefaultOBS();
+	}
+
+	auto match = new Match(
+		rewardFn, terminalConditions, obsBuilder,
+		new DiscreteAction(), new RandomState(true, true, false),
+		teamSize
+	);
+
+	auto env = std::make_shared<BenchEnv>();
+	env->match = match;
+	env->gym = new Gym(match, TICK_SKIP);
+	env->gym->Reset();
+	return env;
+}
+
+static void RegisterArenaStep() {
+	for (int teamSize = 1; teamSize <= 3; teamSize++) {
+		for (bool randomState : { false, true }) {
+			std::string name = RS_STR("Arena::Step/" << teamSize << "v" << teamSize << "/" << (randomState ? "random" : "kickoff"));
+			Register(name,
+				[=](const Context& ctx) -> OpFn {
+					auto rng = ctx.Reseed();
+					auto arena = MakeArena(teamSize, randomState, rng);
+					return [arena] {
+						arena->Step(TICK_SKIP);
+					};
+				},
+				true
+			);
+		}
+	}
+}
+
+// Ways to roll an arena back to an earlier state
+static void RegisterArenaRollback() {
+	for (int teamSize = 1; teamSize <= 3; teamSize++) {
+		Register(RS_STR("Arena::Clone/" << teamSize << "v" << teamSize),
+			[=](const Context& ctx) -> OpFn {
+				auto rng = ctx.Reseed();
+				auto arena = MakeArena(teamSize, true, rng);
+				return [arena] {
+					Arena* clone = arena->Clone(false);
+					DoNotOptimize(clone);
+					delete clone;
+				};
+			},
+			true
+		);
+
+		Register(RS_STR("Arena::RestoreSnapshot/" << teamSize << "v" << teamSize),
+			[=](const Context& ctx) -> OpFn {
+				auto rng = ctx.Reseed();
+				auto arena = MakeArena(teamSize, true, rng);
+				arena->Step(TICK_SKIP);
+				auto snapshot = std::make_shared<ArenaSnapshot>();
+				arena->SaveSnapshot(*snapshot);
+				arena->Step(TICK_SKIP);
+				return [arena, snapshot] {
+					arena->RestoreSnapshot(*snapshot);
+				};
+			},
+			true
+		);
+	}
+}
+
+// Cars driving on the ground from kickoff, with the per-wheel and 4-wide wheel lane suspension/friction paths
+// Each op rolls back to the same state first, so the cars never leave the ground
+static void RegisterGroundDrive() {
+	for (bool wheelLanes : { false, true }) {
+		Register(RS_STR("Arena::Step/GroundDrive/3v3/" << (wheelLanes ? "WheelLanes" : "PerWheel")),
+			[=](const Context& ctx) -> OpFn {
+				auto rng = ctx.Reseed();
+				auto arena = MakeArena(3, false, rng);
+				std::uniform_real_distribution<float> steerDist = std::uniform_real_distribution<float>(-0.5f, 0.5f);
+				for (Car* car : arena->GetCars()) {
+					car->controls = {};
+					car->controls.throttle = 1;
+					car->controls.steer = steerDist(rng);
+					car->controls.handbrake = (rng() % 3) == 0;
+					car->_bulletVehicle.m_useWheelLanes = wheelLanes;
+				}
+
+				// Let the cars get going
+				arena->Step(30);
+
+				auto snapshot = std::make_shared<ArenaSnapshot>();
+				arena->SaveSnapshot(*snapshot);
+				return [arena, snapshot] {
+					arena->RestoreSnapshot(*snapshot);
+					arena->Step(TICK_SKIP);
+				};
+			},
+			true
+		);
+	}
+}
+
+constexpr int BALL_PRED_ARENA_AMOUNT = 16;
+constexpr int BALL_PRED_TICKS = 120;
+
+// Predictions must be bit-identical no matter which thread predicted each ball
+// The balls are thrown at the floor and walls, so the predictions include contacts with the arena mesh
+static void CheckBallPredBatchDeterminism(int threadAmount, std::mt19937_64& rng) {
+	constexpr const char* ERROR_PREFIX = "CheckBallPredBatchDeterminism(): ";
+
+	std::vector<std::shared_ptr<Arena>> arenas = {};
+	std::vector<Arena*> arenaPtrs = {};
+	std::uniform_real_distribution<float> angleDist = std::uniform_real_distribution<float>(0, 2 * M_PI);
+	for (int i = 0; i < BALL_PRED_ARENA_AMOUNT; i++) {
+		arenas.push_back(MakeArena(1, true, rng));
+		arenaPtrs.push_back(arenas.back().get());
+
+		float angle = angleDist(rng);
+		BallState ballState = arenas.back()->ball->GetState();
+		ballState.vel = Vec(cosf(angle) * 4000, sinf(angle) * 4000, -2000);
+		arenas.back()->ball->SetState(ballState);
+	}
+
+	BallPredBatch singleBatch = BallPredBatch(arenaPtrs.front(), BALL_PRED_TICKS, 1);
+	BallPredBatch multiBatch = BallPredBatch(arenaPtrs.front(), BALL_PRED_TICKS, threadAmount);
+	std::vector<BallState> singleData = std::vector<BallState>(BALL_PRED_ARENA_AMOUNT * BALL_PRED_TICKS);
+	std::vector<BallState> multiData = std::vector<BallState>(BALL_PRED_ARENA_AMOUNT * BALL_PRED_TICKS);
+
+	auto fnSameVec = [](const Vec& a, const Vec& b) {
+		return a.x == b.x && a.y == b.y && a.z == b.z;
+	};
+
+	// Steps in between, so reused predictions are checked too
+	int bounceAmount = 0;
+	for (int step = 0; step < 8; step++) {
+		singleBatch.Predict(arenaPtrs.data(), arenaPtrs.size(), singleData.data());
+		multiBatch.Predict(arenaPtrs.data(), arenaPtrs.size(), multiData.data());
+
+		for (size_t i = 0; i < singleData.size(); i++) {
+			const BallState& a = singleData[i];
+			const BallState& b = multiData[i];
+			if (!fnSameVec(a.pos, b.pos) || !fnSameVec(a.vel, b.vel) || !fnSameVec(a.angVel, b.angVel))
+				RG_ERR_CLOSE(ERROR_PREFIX << "Ball " << (i / BALL_PRED_TICKS) << " differs at tick " << (i % BALL_PRED_TICKS) << " with " << threadAmount << " threads");
+
+			// Only a contact can make the ball go up, or reverse horizontally
+			if (i % BALL_PRED_TICKS > 0) {
+				const Vec& prevVel = singleData[i - 1].vel;
+				if ((prevVel.z < 0 && a.vel.z > 0) || (prevVel.x * a.vel.x < 0) || (prevVel.y * a.vel.y < 0))
+					bounceAmount++;
+			}
+		}
+
+		for (Arena* arena : arenaPtrs)
+			arena->Step(TICK_SKIP);
+	}
+
+	if (bounceAmount == 0)
+		RG_ERR_CLOSE(ERROR_PREFIX << "No predicted ball touched the arena, nothing was checked");
+}
+
+// Steps every arena, then updates the ball prediction of each one
+static void RegisterBallPred() {
+	Register(RS_STR("BallPred/Tracker/" << BALL_PRED_ARENA_AMOUNT << "x1v1"),
+		[=](const Context& ctx) -> OpFn {
+			auto rng = ctx.Reseed();
+			auto arenas = std::make_shared<std::vector<std::shared_ptr<Arena>>>();
+			auto trackers = std::make_shared<std::vector<std::shared_ptr<BallPredTracker>>>();
+			for (int i = 0; i < BALL_PRED_ARENA_AMOUNT; i++) {
+				arenas->push_back(MakeArena(1, true, rng));
+				trackers->push_back(std::make_shared<BallPredTracker>(arenas->back().get(), BALL_PRED_TICKS));
+			}
+			return [arenas, trackers] {
+				for (int i = 0; i < BALL_PRED_ARENA_AMOUNT; i++) {
+					(*arenas)[i]->Step(TICK_SKIP);
+					(*trackers)[i]->UpdatePredFromArena((*arenas)[i].get());
+				}
+			};
+		},
+		true
+	);
+
+	for (int threadAmount : { 1, 4 }) {
+		Register(RS_STR("BallPred/Batch/" << BALL_PRED_ARENA_AMOUNT << "x1v1/threads=" << threadAmount),
+			[=](const Context& ctx) -> OpFn {
+				auto rng = ctx.Reseed();
+				if (threadAmount > 1)
+					CheckBallPredBatchDeterminism(threadAmount, rng);
+
+				auto arenas = std::make_shared<std::vector<std::shared_ptr<Arena>>>();
+				auto arenaPtrs = std::make_shared<std::vector<Arena*>>();
+				for (int i = 0; i < BALL_PRED_ARENA_AMOUNT; i++) {
+					arenas->push_back(MakeArena(1, true, rng));
+					arenaPtrs->push_back(arenas->back().get());
+				}
+				auto predBatch = std::make_shared<BallPredBatch>(arenaPtrs->front(), BALL_PRED_TICKS, threadAmount);
+				auto predData = std::make_shared<std::vector<BallState>>(BALL_PRED_ARENA_AMOUNT * BALL_PRED_TICKS);
+				return [arenas, arenaPtrs, predBatch, predData] {
+					for (Arena* arena : *arenaPtrs)
+						arena->Step(TICK_SKIP);
+					predBatch->Predict(arenaPtrs->data(), arenaPtrs->size(), predData->data());
+				};
+			},
+			true
+		);
+	}
+}
+
+constexpr int CURVE_INPUT_AMOUNT = 1024;
+
+// Evaluates the curves used for every wheel each tick, over car speeds from 0 to max speed
+// "Mappings" is the old std::map walk, kept for comparison
+static void RegisterCurves() {
+	for (bool compiled : { false, true }) {
+		Register(std::string("LinearPieceCurve/") + (compiled ? "Compiled" : "Mappings"),
+			[=](const Context& ctx) -> OpFn {
+				auto rng = ctx.Reseed();
+				auto inputs = std::make_shared<std::vector<float>>(CURVE_INPUT_AMOUNT);
+				std::uniform_real_distribution<float> speedDist(0, RLConst::CAR_MAX_SPEED);
+				for (float& input : *inputs)
+					input = speedDist(rng);
+
+				return [=] {
+					float total = 0;
+					for (float input : *inputs) {
+						if (compiled) {
+							total += RLConst::STEER_ANGLE_FROM_SPEED_CURVE.GetOutput(input);
+							total += RLConst::DRIVE_SPEED_TORQUE_FACTOR_CURVE.GetOutput(input);
+							total += RLConst::LAT_FRICTION_CURVE.GetOutput(input / RLConst::CAR_MAX_SPEED);
+						} else {
+							total += RLConst::STEER_ANGLE_FROM_SPEED_CURVE._GetOutputFromMappings(input);
+							total += RLConst::DRIVE_SPEED_TORQUE_FACTOR_CURVE._GetOutputFromMappings(input);
+							total += RLConst::LAT_FRICTION_CURVE._GetOutputFromMappings(input / RLConst::CAR_MAX_SPEED);
+						}
+					}
+					DoNotOptimize(total);
+				};
+			}
+		);
+	}
+}
+
+static void RegisterGymStep() {
+	for (bool advancedObs : { false, true }) {
+		for (int teamSize = 1; teamSize <= 3; teamSize++) {
+			std::string name = RS_STR("Gym::Step/" << (advancedObs ? "AdvancedObsPadder" : "DefaultOBS") << "/" << teamSize << "v" << teamSize);
+			Register(name,
+				[=](const Context& ctx) -> OpFn {
+					auto rng = ctx.Reseed();
+					auto env = MakeEnv(teamSize, advancedObs);
+
+					// Pre-generate actions so the RNG isn't timed
+					constexpr int ACTION_SETS = 1024;
+					int actionAmount = env->match->actionParser->GetActionAmount();
+					auto actionSets = std::make_shared<std::vector<IList>>(ACTION_SETS);
+					for (auto& actions : *actionSets)
+						for (int i = 0; i < env->match->playerAmount; i++)
+							actions.push_back(rng() % actionAmount);
+
+					auto stepIdx = std::make_shared<uint64_t>(0);
+					return [env, actionSets, stepIdx] {
+						auto& result = env->gym->Step((*actionSets)[(*stepIdx)++ % ACTION_SETS]);
+						if (result.done)
+							env->gym->Reset();
+						DoNotOptimize(result);
+					};
+				},
+				true
+			);
+		}
+	}
+}
+
+static void RegisterGameStateUpdate() {
+	for (int teamSize = 1; teamSize <= 3; teamSize++) {
+		Register(RS_STR("GameState::UpdateFromArena/" << teamSize << "v" << teamSize),
+			[=](const Context& ctx) -> OpFn {
+				auto rng = ctx.Reseed();
+				auto arena = MakeArena(teamSize, true, rng);
+				auto state = std::make_shared<GameState>();
+				return [arena, state] {
+					state->UpdateFromArena(arena.get());
+					DoNotOptimize(*state);
+				};
+			},
+			true
+		);
+
+		// Also reads every inverted view, like an obs builder with orange players does
+		// The difference from the above is what is saved when nothing reads them
+		Register(RS_STR("GameState::UpdateFromArena+Inverted/" << teamSize << "v" << teamSize),
+			[=](const Context& ctx) -> OpFn {
+				auto rng = ctx.Reseed();
+				auto arena = MakeArena(teamSize, true, rng);
+				auto state = std::make_shared<GameState>();
+				return [arena, state] {
+					state->UpdateFromArena(arena.get());
+					DoNotOptimize(state->GetBallPhys(true));
+					DoNotOptimize(state->GetBoostPads(true));
+					for (auto& player : state->players)
+						DoNotOptimize(player.GetPhys(true));
+				};
+			},
+			true
+		);
+	}
+}
+
+static void RegisterRewards() {
+	typedef std::function<RewardFunction*()> RewardMakeFn;
+	std::vector<std::pair<std::string, RewardMakeFn>> rewards = {
+		{ "FaceBallReward", [] { return new FaceBallReward(); } },
+		{ "VelocityReward", [] { return new VelocityReward(); } },
+		{ "VelocityPlayerToBallReward", [] { return new VelocityPlayerToBallReward(); } },
+		{ "VelocityBallToGoalReward", [] { return new VelocityBallToGoalReward(); } },
+		{ "SaveBoostReward", [] { return new SaveBoostReward(); } },
+		{ "TouchBallReward", [] { return new TouchBallReward(0.5f); } },
+		{ "EventReward", [] { return new EventReward({ .teamGoal = 1.f, .concede = -1.f, .touch = 0.1f }); } },
+	};
+
+	for (auto& pair : rewards) {
+		RewardMakeFn makeFn = pair.second;
+		Register("Reward/" + pair.first + "/3v3",
+			[=](const Context& ctx) -> OpFn {
+				auto rng = ctx.Reseed();
+				auto arena = MakeArena(3, true, rng);
+				auto state = std::make_shared<GameState>(arena.get());
+				auto prevActions = std::make_shared<ActionSet>(state->players.size());
+				auto rewardFn = std::shared_ptr<RewardFunction>(makeFn());
+				rewardFn->Reset(*state);
+
+				// Same calls as Match::GetRewards()
+				auto rewards = std::make_shared<FList>(state->players.size());
+				return [state, prevActions, rewardFn, rewards] {
+					rewardFn->PreStep(*state);
+					rewardFn->GetAllRewardsInto(*state, *prevActions, false, rewards->data());
+					DoNotOptimize(*rewards);
+				};
+			},
+			true
+		);
+	}
+}
+
+// The games of one ThreadAgent, each with its own combined reward
+struct BenchRewardGames {
+	std::vector<std::shared_ptr<Arena>> arenas;
+	std::vector<GameState> states;
+	std::vector<ActionSet> prevActions;
+	std::vector<RewardFunction*> rewardFuncs;
+
+	~BenchRewardGames() {
+		for (auto rewardFn : rewardFuncs)
+			delete rewardFn;
+	}
+};
+
+static std::shared_ptr<BenchRewardGames> MakeRewardGames(int gameAmount, std::mt19937_64& rng) {
+	auto games = std::make_shared<BenchRewardGames>();
+	for (int i = 0; i < gameAmount; i++) {
+		auto arena = MakeArena(3, true, rng);
+		games->states.push_back(GameState(arena.get()));
+		games->prevActions.push_back(ActionSet(games->states.back().players.size()));
+		games->arenas.push_back(arena);
+
+		RewardFunction* rewardFn = new CombinedReward(
+			{
+				{ new VelocityPlayerToBallReward(), 4.f },
+				{ new VelocityBallToGoalReward(), 2.f },
+				{ new FaceBallReward(), 0.25f },
+				{ new TouchBallReward(0.5f), 10.f },
+				{ new SaveBoostReward(), 0.2f },
+				{ new EventReward({ .teamGoal = 1.f, .concede = -1.f, .touch = 0.1f }), 20.f },
+			},
+			true
+		);
+		rewardFn->Reset(games->states.back());
+		games->rewardFuncs.push_back(rewardFn);
+	}
+	return games;
+}
+
+// Games stepped by one ThreadAgent
+constexpr int REWARD_BATCH_GAME_AMOUNT = 16;
+
+static void RegisterRewardBatch() {
+	// Same calls as GameInst::Step() for each game
+	Register(RS_STR("Reward/Combined/PerGame/" << REWARD_BATCH_GAME_AMOUNT << "x3v3"),
+		[=](const Context& ctx) -> OpFn {
+			auto rng = ctx.Reseed();
+			auto games = MakeRewardGames(REWARD_BATCH_GAME_AMOUNT, rng);
+			auto rewards = std::make_shared<FList>();
+			return [games, rewards] {
+				for (int i = 0; i < REWARD_BATCH_GAME_AMOUNT; i++) {
+					auto& state = games->states[i];
+					rewards->resize(state.players.size());
+					games->rewardFuncs[i]->PreStep(state);
+					games->rewardFuncs[i]->GetAllRewardsInto(state, games->prevActions[i], false, rewards->data());
+					DoNotOptimize(*rewards);
+				}
+			};
+		},
+		true
+	);
+
+	// Same calls as ThreadAgent
+	Register(RS_STR("Reward/Combined/Batch/" << REWARD_BATCH_GAME_AMOUNT << "x3v3"),
+		[=](const Context& ctx) -> OpFn {
+			auto rng = ctx.Reseed();
+			auto games = MakeRewardGames(REWARD_BATCH_GAME_AMOUNT, rng);
+			auto batch = std::make_shared<RewardBatch>();
+			return [games, batch] {
+				batch->Clear();
+				for (int i = 0; i < REWARD_BATCH_GAME_AMOUNT; i++)
+					batch->AddGame(games->states[i], games->prevActions[i], false, games->rewardFuncs[i]);
+				batch->Evaluate();
+				DoNotOptimize(batch->rewards);
+			};
+		},
+		true
+	);
+}
+
+void RLGPC::Bench::RegisterSimBenches() {
+	RegisterArenaStep();
+	RegisterArenaRollback();
+	RegisterGroundDrive();
+	RegisterBallPred();
+	RegisterCurves();
+	RegisterGymStep();
+	RegisterGameStateUpdate();
+	RegisterRewards();
+	RegisterRewardBatch();
+}
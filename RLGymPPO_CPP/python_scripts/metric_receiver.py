@@ -36,4 +36,55 @@ def init(py_exec_path, project, group, name, id = None):
 
 def add_metrics(metrics):
 	global wandb_run
-	wandb_run.log(metrics)
\ No newline at end of file
+	wandb_run.log(metrics)
+# Out-of-process mode, for when RLGymPPO_CPP uses the NDJSON_FILE or UNIX_SOCKET metrics sink
+# Each line is a JSON object, either {"type": "init", ...} or {"type": "metrics", "metrics": {...}}
+def handle_line(line):
+	msg = json.loads(line)
+	if msg["type"] == "init":
+		init(sys.executable, msg["project"], msg["group"], msg["name"], msg["run_id"])
+	elif msg["type"] == "metrics":
+		if wandb_run is None:
+			print("Got metrics before init, ignoring")
+		else:
+			add_metrics(msg["metrics"])
+
+def follow_file(path):
+	import time
+	with open(path, "rb") as f:
+		while True:
+			line = f.readline()
+			if not line or not line.endswith(b"\n"):
+				# Wait for the rest of the line to be written
+				if line:
+					f.seek(f.tell() - len(line))
+				time.sleep(0.5)
+				continue
+			handle_line(line.decode())
+
+def listen_socket(path):
+	import socket
+	if os.path.exists(path):
+		os.remove(path)
+	server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+	server.bind(path)
+	server.listen(1)
+	print(f"Listening for metrics on {path}...")
+	while True:
+		conn, _ = server.accept()
+		with conn, conn.makefile("r") as stream:
+			for line in stream:
+				handle_line(line)
+
+if __name__ == "__main__":
+	import argparse
+	parser = argparse.ArgumentParser(description = "Forwards metrics from RLGymPPO_CPP to wandb")
+	group = parser.add_mutually_exclusive_group(required = True)
+	group.add_argument("--file", help = "Path of the NDJSON metrics file to follow")
+	group.add_argument("--socket", help = "Path of the Unix socket to listen on")
+	args = parser.parse_args()
+
+	if args.file:
+		follow_file(args.file)
+	else:
+		listen_socket(args.socket)
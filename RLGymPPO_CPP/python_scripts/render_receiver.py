@@ -1,12 +1,17 @@
 import sys
 import json
+import time
+import struct
 import traceback
 
 import socket
-import struct
+from multiprocessing import shared_memory
 
 # =======================
 # Example implementation of render receiver, using RocketSimVis
+# Run this as its own process while RLGymPPO_CPP is rendering:
+#	python render_receiver.py [shm name]
+# Frames are read from the shared-memory ring written by RenderSender (see RenderFrame.h for the layout)
 # =======================
 
 # Send to RocketSimVis
@@ -15,27 +20,147 @@ UDP_PORT = 9273
 
 sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM) # UDP
 
-def send_data_to_rsvis(j, gamemode):
-    json_out = {}
-    json_out["gamemode"] = gamemode
-    json_out["ball_phys"] = j['ball']
-    json_out["ball_phys"].pop('forward')
-    json_out["ball_phys"].pop('right')
-    json_out["ball_phys"].pop('up')
-    json_out["cars"] = []
-    for player in j['players']:
-        json_out["cars"].append(player)
-    json_out["boost_pad_states"] = j['boost_pads']
-
-    sock.sendto(json.dumps(json_out).encode(), (UDP_IP, UDP_PORT))
-
-def render_state(state_json_str):
-    j = json.loads(state_json_str)
-    try:
-        if 'state' in j:
-            send_data_to_rsvis(j['state'], j['gamemode'])
-        else:
-            send_data_to_rsvis(j)
-    except Exception as err:
-        print("Exception while sending data:")
-        traceback.print_exc()
+RENDER_RING_MAGIC = 0x46524752
+RENDER_RING_VERSION = 1
+
+GAMEMODE_STRS = ["soccar", "hoops", "heatseeker", "snowday", "dropshot", "theVoid"]
+
+MAX_BOOST_PADS = 34
+MAX_PLAYERS = 8
+
+# Must match RenderFrame.h
+HEADER_FMT = struct.Struct("<4I3Q")
+SEQ_FMT = struct.Struct("<Q")
+PHYS_FMT = struct.Struct("<18f")
+FRAME_START_FMT = struct.Struct("<Q3I2iI")
+PLAYER_START_FMT = struct.Struct("<I8Bf")
+
+HEADER_SIZE = 64
+PHYS_SIZE = 72
+PLAYER_SIZE = 120
+BOOST_PADS_OFFSET = FRAME_START_FMT.size + PHYS_SIZE
+PLAYERS_OFFSET = BOOST_PADS_OFFSET + MAX_BOOST_PADS + 6
+FRAME_SIZE = PLAYERS_OFFSET + PLAYER_SIZE * MAX_PLAYERS
+NEXT_FRAME_OFFSET, LATEST_FRAME_OFFSET = 16, 24
+
+def parse_phys(buf, offset):
+	vals = PHYS_FMT.unpack_from(buf, offset)
+	return {
+		"pos": list(vals[0:3]),
+		"forward": list(vals[3:6]),
+		"right": list(vals[6:9]),
+		"up": list(vals[9:12]),
+		"vel": list(vals[12:15]),
+		"ang_vel": list(vals[15:18])
+	}
+
+def parse_frame(buf):
+	frame_index, gamemode, player_amount, pad_amount, goals_0, goals_1, _ = FRAME_START_FMT.unpack_from(buf, 0)
+
+	players = []
+	for i in range(player_amount):
+		offset = PLAYERS_OFFSET + i * PLAYER_SIZE
+		car_id, team, is_demoed, on_ground, ball_touched, has_flip, _, _, _, boost_amount = PLAYER_START_FMT.unpack_from(buf, offset)
+		players.append({
+			"car_id": car_id,
+			"team_num": team,
+			"phys": parse_phys(buf, offset + PLAYER_START_FMT.size),
+			"is_demoed": bool(is_demoed),
+			"on_ground": bool(on_ground),
+			"ball_touched": bool(ball_touched),
+			"has_flip": bool(has_flip),
+			"boost_amount": boost_amount
+		})
+
+	return {
+		"frame_index": frame_index,
+		"gamemode": GAMEMODE_STRS[gamemode] if gamemode < len(GAMEMODE_STRS) else "soccar",
+		"ball": parse_phys(buf, FRAME_START_FMT.size),
+		"boost_pads": [bool(b) for b in buf[BOOST_PADS_OFFSET:BOOST_PADS_OFFSET + pad_amount]],
+		"players": players,
+		"team_goals": [goals_0, goals_1]
+	}
+
+def send_data_to_rsvis(state, gamemode):
+	json_out = {}
+	json_out["gamemode"] = gamemode
+	json_out["ball_phys"] = state['ball']
+	json_out["ball_phys"].pop('forward')
+	json_out["ball_phys"].pop('right')
+	json_out["ball_phys"].pop('up')
+	json_out["cars"] = []
+	for player in state['players']:
+		json_out["cars"].append(player)
+	json_out["boost_pad_states"] = state['boost_pads']
+
+	sock.sendto(json.dumps(json_out).encode(), (UDP_IP, UDP_PORT))
+
+def open_ring(name):
+	while True:
+		try:
+			shm = shared_memory.SharedMemory(name = name)
+		except FileNotFoundError:
+			time.sleep(0.5)
+			continue
+
+		# Only the writer should unlink the shared memory (Python < 3.13 always tracks it)
+		try:
+			from multiprocessing import resource_tracker
+			resource_tracker.unregister(shm._name, "shared_memory")
+		except Exception:
+			pass
+
+		magic, version, slot_amount, slot_size = HEADER_FMT.unpack_from(shm.buf, 0)[:4]
+		if magic != RENDER_RING_MAGIC:
+			# Not initialized yet
+			shm.close()
+			time.sleep(0.1)
+			continue
+
+		if version != RENDER_RING_VERSION:
+			raise Exception(f"Render ring version mismatch (got {version}, expected {RENDER_RING_VERSION})")
+		return shm, slot_amount, slot_size
+
+def read_latest_frame(shm, slot_amount, slot_size, last_frame):
+	latest = SEQ_FMT.unpack_from(shm.buf, LATEST_FRAME_OFFSET)[0]
+	if latest == 0 or latest - 1 == last_frame:
+		return None
+
+	slot_offset = HEADER_SIZE + ((latest - 1) % slot_amount) * slot_size
+	seq_before = SEQ_FMT.unpack_from(shm.buf, slot_offset)[0]
+	if seq_before & 1:
+		return None # Being written
+	frame_buf = bytes(shm.buf[slot_offset + 8:slot_offset + 8 + FRAME_SIZE])
+	seq_after = SEQ_FMT.unpack_from(shm.buf, slot_offset)[0]
+	if seq_before != seq_after:
+		return None # Overwritten while copying, try again
+
+	return parse_frame(frame_buf)
+
+def main():
+	name = sys.argv[1] if len(sys.argv) > 1 else "rlgymppo_render"
+	print(f"Waiting for render shared memory \"{name}\"...")
+	shm, slot_amount, slot_size = open_ring(name)
+	print("Connected, sending frames to RocketSimVis...")
+
+	last_frame = None
+	while True:
+		try:
+			frame = read_latest_frame(shm, slot_amount, slot_size, last_frame)
+		except Exception:
+			traceback.print_exc()
+			frame = None
+
+		if frame is None:
+			time.sleep(1 / 240)
+			continue
+
+		last_frame = frame["frame_index"]
+		try:
+			send_data_to_rsvis(frame, frame["gamemode"])
+		except Exception as err:
+			print("Exception while sending data:")
+			traceback.print_exc()
+
+if __name__ == "__main__":
+	main()
@@ -9,15 +9,22 @@
 
 #define RG_NOGRAD torch::NoGradGuard _noGradGuard
 
-#define RG_AUTOCAST_ON() { \
+// Autocast state is thread-local, so this must be called on the thread doing the math
+// Only enables autocast for the device the math runs on, both use bf16, parameters stay fp32
+#define RG_AUTOCAST_ON(device) { \
+if ((device).is_cuda()) { \
 at::autocast::set_enabled(true); \
 at::autocast::set_autocast_gpu_dtype(torch::kBFloat16); \
-at::autocast::set_autocast_cpu_dtype(torch::kFloat); \
+} else { \
+at::autocast::set_cpu_enabled(true); \
+at::autocast::set_autocast_cpu_dtype(torch::kBFloat16); \
+} \
 }
 
 #define RG_AUTOCAST_OFF() { \
 at::autocast::clear_cache(); \
 at::autocast::set_enabled(false); \
+at::autocast::set_cpu_enabled(false); \
 }
 
 #define RG_HALFPERC_TYPE torch::ScalarType::BFloat16
@@ -92,5 +92,6 @@ RLGPC::DiscretePolicy::BackpropResult RLGPC::DiscretePolicy::GetBackpropData(tor
 
 	entropy = entropy.sum(-1);
 
-	return BackpropResult{ actionLogProbs.to(device, true), entropy.to(device).mean() };
+	// Mean in fp32, so it doesn't lose precision under bf16 autocast
+	return BackpropResult{ actionLogProbs.to(device, true), entropy.to(device, torch::kFloat).mean() };
 }
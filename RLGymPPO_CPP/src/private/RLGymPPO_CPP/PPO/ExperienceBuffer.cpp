@@ -100,6 +100,9 @@ RLGPC::ExperienceBuffer::SampleSet RLGPC::ExperienceBuffer::_GetSamples(const in
 	result.states = torch::index_select(data.states, 0, tIndices);
 	result.values = torch::index_select(data.values, 0, tIndices);
 	result.advantages = torch::index_select(data.advantages, 0, tIndices);
+	result.policyVersions = torch::index_select(data.policyVersions, 0, tIndices);
+	if (proxLogProbs.defined())
+		result.proxLogProbs = torch::index_select(proxLogProbs, 0, tIndices);
 	return result;
 }
 
@@ -12,10 +12,12 @@ namespace RLGPC {
 			debugCounters,
 #endif
 
-			nextStates, dones, truncated, values, advantages;
+			nextStates, dones, truncated, policyVersions, values, advantages;
 
 		torch::Tensor* begin() { return &states; }
+		const torch::Tensor* begin() const { return &states; }
 		torch::Tensor* end() { return &advantages + 1; }
+		const torch::Tensor* end() const { return &advantages + 1; }
 	};
 
 	// https://github.com/AechPro/rlgym-ppo/blob/main/rlgym_ppo/ppo/experience_buffer.py
@@ -27,6 +29,10 @@ namespace RLGPC {
 
 		ExperienceTensors data;
 
+		// Log probs of the current policy for all of our data, before any learning happens
+		// Only used for off-policy correction, not a part of the submitted experience
+		torch::Tensor proxLogProbs;
+
 		int64_t curSize = 0;
 		int64_t maxSize;
 
@@ -37,7 +43,7 @@ namespace RLGPC {
 		void SubmitExperience(ExperienceTensors& data);
 
 		struct SampleSet {
-			torch::Tensor actions, logProbs, states, values, advantages;
+			torch::Tensor actions, logProbs, states, values, advantages, policyVersions, proxLogProbs;
 		};
 		SampleSet _GetSamples(const int64_t* indices, size_t size) const;
 
@@ -1,6 +1,9 @@
 #include "PPOLearner.h"
 
 #include "../Util/TorchFuncs.h"
+#include "../Util/CPUFeatures.h"
+#include "../Util/FlatModel.h"
+#include "../Util/MemoryTracker.h"
 
 #include <torch/nn/utils/convert_parameters.h>
 #include <torch/nn/utils/clip_grad.h>
@@ -35,6 +38,19 @@ RLGPC::PPOLearner::PPOLearner(int obsSpaceSize, int actSpaceSize, PPOLearnerConf
 	if (config.batchSize % config.miniBatchSize != 0)
 		RG_ERR_CLOSE("PPOLearner: config.batchSize must be a multiple of config.miniBatchSize");
 
+	if (config.autocastLearn && device.is_cpu()) {
+		// Without native bf16 instructions, oneDNN emulates bf16 and it ends up slower than fp32
+		if (CPUFeatures::HasNativeBF16()) {
+			RG_LOG("PPOLearner: Using CPU bf16 autocast (supported features: " << CPUFeatures::GetBF16FeatureStr() << ")");
+		} else {
+			RG_LOG(
+				"WARNING: PPOLearner: config.autocastLearn is enabled, but this CPU has no native bf16 support (AVX512-BF16 or AMX-BF16), or the OS hasn't enabled it.\n" <<
+				"Autocast will be disabled and learning will use fp32."
+			);
+			config.autocastLearn = false;
+		}
+	}
+
 	policy = new DiscretePolicy(obsSpaceSize, actSpaceSize, config.policyLayerSizes, device, config.policyTemperature);
 	valueNet = new ValueEstimator(obsSpaceSize, config.criticLayerSizes, device);
 
@@ -68,15 +84,13 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 	
 	bool autocast = config.autocastLearn;
 
-	if (autocast) {
-#ifndef RG_CUDA_SUPPORT
-		RG_ERR_CLOSE("Autocast not supported on non-CUDA!")
-#endif
-	}
+	// The grad scaler is only used for CUDA
+	// On CPU we autocast to bf16, which has the same exponent range as fp32, so loss scaling isn't needed
+	bool useGradScaler = autocast && device.is_cuda();
 
 	static amp::GradScaler* gradScaler = NULL;
 #ifdef RG_CUDA_SUPPORT
-	if (autocast && !gradScaler) {
+	if (useGradScaler && !gradScaler) {
 		RG_LOG("Creating grad scaler...");
 		gradScaler = new amp::GradScaler();
 	}
@@ -89,7 +103,9 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 		meanEntropy = 0,
 		meanDivergence = 0,
 		meanValLoss = 0,
-		meanRatio = 0;
+		meanRatio = 0,
+		meanISWeight = 0,
+		meanStaleFrac = 0;
 	FList clipFractions = {};
 
 	// Save parameters first
@@ -99,18 +115,47 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 	bool trainPolicy = config.policyLR != 0;
 	bool trainCritic = config.criticLR != 0;
 
+	bool offPolicy = config.offPolicyCorrection && trainPolicy;
+	bool limitLag = config.maxPolicyLag >= 0 && trainPolicy;
+
+	if (offPolicy) {
+		// Get log probs from the proximal policy (our policy before this learn step) for all experience
+		// These are the center of the PPO clip, instead of the log probs of whatever policy collected the step
+		RG_NOGRAD;
+		RG_TRACE_SCOPE("PPO/ProxLogProbs");
+		int64_t expSize = expBuffer->curSize;
+		auto proxLogProbs = torch::zeros({ expSize });
+		for (int64_t i = 0; i < expSize; i += config.miniBatchSize) {
+			int64_t end = RS_MIN(i + config.miniBatchSize, expSize);
+			auto obs = expBuffer->data.states.slice(0, i, end).to(device, true, true);
+			auto acts = expBuffer->data.actions.slice(0, i, end).view({ end - i, -1 }).to(device, true, true);
+			auto logProbsPart = policy->GetBackpropData(obs, acts).actionLogProbs;
+			proxLogProbs.slice(0, i, end).copy_(logProbsPart.cpu().flatten().to(kFloat), true);
+		}
+		expBuffer->proxLogProbs = proxLogProbs;
+	}
+
 	Timer totalTimer = {};
 	for (int epoch = 0; epoch < config.epochs; epoch++) {
 
 		// Get randomly-ordered timesteps for PPO
 		auto batches = expBuffer->GetAllBatchesShuffled(config.batchSize);
 
+		if (epoch == 0) {
+			lastStagingBytes = 0;
+			for (auto& batch : batches)
+				for (auto& tensor : { batch.actions, batch.logProbs, batch.states, batch.values, batch.advantages, batch.policyVersions, batch.proxLogProbs })
+					lastStagingBytes += MemoryTracker::GetTensorBytes(tensor);
+		}
+
 		for (auto& batch : batches) {
 			auto batchActs = batch.actions;
 			auto batchOldProbs = batch.logProbs;
 			auto batchObs = batch.states;
 			auto batchTargetValues = batch.values;
 			auto batchAdvantages = batch.advantages;
+			auto batchPolicyVersions = batch.policyVersions;
+			auto batchProxProbs = batch.proxLogProbs;
 
 			batchActs = batchActs.view({ config.batchSize, -1 });
 			policyOptimizer->zero_grad();
@@ -123,6 +168,7 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 			std::atomic<int> threadCounter = 0;
 
 			auto fnRunMinibatch = [&](int start, int stop) {
+				RG_TRACE_SCOPE("PPO/Minibatch");
 
 				float batchSizeRatio = (stop - start) / (float)config.batchSize;
 
@@ -134,9 +180,40 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 				auto oldProbs = batchOldProbs.slice(0, start, stop).to(device, true, true);
 				auto targetValues = batchTargetValues.slice(0, start, stop).to(device, true, true);
 
+				// Per-step weights of the policy loss, undefined if all steps are weighted equally
+				torch::Tensor sampleWeights, sampleCount, proxProbs;
+				if (offPolicy || limitLag) {
+					RG_NOGRAD;
+					sampleWeights = torch::ones_like(oldProbs);
+					sampleCount = torch::tensor((float)oldProbs.numel(), oldProbs.options());
+
+					if (offPolicy) {
+						// Truncated importance weights (proximal policy / behavior policy)
+						proxProbs = batchProxProbs.slice(0, start, stop).to(device, true, true);
+						sampleWeights = clamp(exp(proxProbs - oldProbs), 0, config.offPolicyWeightClip);
+					}
+
+					if (limitLag) {
+						auto lag = (float)policyVersion - batchPolicyVersions.slice(0, start, stop).to(device, true, true);
+						auto notStale = (lag <= (float)config.maxPolicyLag).to(kFloat);
+						sampleWeights = sampleWeights * notStale;
+						sampleCount = notStale.sum().clamp_min(1);
+					}
+
+					threadUpdateMutex.lock();
+					meanISWeight += sampleWeights.mean().cpu().item<float>();
+					meanStaleFrac += 1 - (sampleCount.cpu().item<float>() / oldProbs.numel());
+					threadUpdateMutex.unlock();
+				}
+				auto ratioBaseProbs = offPolicy ? proxProbs : oldProbs;
+
 				Timer timer = {};
-				if (autocast) RG_AUTOCAST_ON();
-				auto vals = valueNet->Forward(obs); // 11%
+				if (autocast) RG_AUTOCAST_ON(device);
+				torch::Tensor vals;
+				{
+					RG_TRACE_SCOPE("PPO/Minibatch/ValueForward");
+					vals = valueNet->Forward(obs); // 11%
+				}
 				threadUpdateMutex.lock();
 				report.Accum("PPO Value Estimate Time", timer.Elapsed());
 				threadUpdateMutex.unlock();
@@ -145,18 +222,26 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 				torch::Tensor logProbs, entropy, ratio, clipped, policyLoss, ppoLoss;
 				if (trainPolicy) {
 					// Get policy log probs & entropy
-					DiscretePolicy::BackpropResult bpResult = policy->GetBackpropData(obs, acts); // 13%
+					DiscretePolicy::BackpropResult bpResult;
+					{
+						RG_TRACE_SCOPE("PPO/Minibatch/PolicyForward");
+						bpResult = policy->GetBackpropData(obs, acts); // 13%
+					}
 
 					logProbs = bpResult.actionLogProbs;
 					entropy = bpResult.entropy;
 
 					logProbs = logProbs.view_as(oldProbs);
+					if (autocast) {
+						// Do loss reductions in fp32 (entropy is already reduced in fp32 by GetBackpropData())
+						logProbs = logProbs.to(kFloat);
+					}
 					threadUpdateMutex.lock();
 					report.Accum("PPO Backprop Data Time", timer.Elapsed());
 					threadUpdateMutex.unlock();
 
 					// Compute PPO loss
-					ratio = exp(logProbs - oldProbs);
+					ratio = exp(logProbs - ratioBaseProbs);
 					threadUpdateMutex.lock();
 					meanRatio += ratio.mean().detach().cpu().item<float>();
 					threadUpdateMutex.unlock();
@@ -165,9 +250,14 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 					);
 
 					// Compute policy loss
-					policyLoss = -min(
+					auto surrogate = min(
 						ratio * advantages, clipped * advantages
-					).mean();
+					);
+					if (sampleWeights.defined()) {
+						policyLoss = -(surrogate * sampleWeights).sum() / sampleCount;
+					} else {
+						policyLoss = -surrogate.mean();
+					}
 					ppoLoss = (policyLoss - entropy * config.entCoef) * batchSizeRatio;
 				}
 
@@ -175,6 +265,8 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 				if (trainCritic) {
 					// Compute value loss
 					vals = vals.view_as(targetValues);
+					if (autocast)
+						vals = vals.to(kFloat);
 					valueLoss = valueLossFn(vals, targetValues) * batchSizeRatio;
 				}
 
@@ -187,7 +279,7 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 					{
 						RG_NOGRAD;
 
-						auto logRatio = logProbs - oldProbs;
+						auto logRatio = logProbs - ratioBaseProbs;
 						auto klTensor = (exp(logRatio) - 1) - logRatio;
 						kl = klTensor.mean().detach().cpu().item<float>();
 
@@ -202,16 +294,19 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 				// NOTE: These gradient calls are a substantial portion of learn time
 				//	From my testing, they are around 61% of learn time
 				//	Results will probably vary heavily depending on model size and GPU strength
-				if (autocast) {
-					if (trainPolicy)
-						gradScaler->scale(ppoLoss).backward();
-					if (trainCritic)
-						gradScaler->scale(valueLoss).backward();
-				} else {
-					if (trainPolicy)
-						ppoLoss.backward(); // 29%
-					if (trainCritic)
-						valueLoss.backward(); // 24%
+				{
+					RG_TRACE_SCOPE("PPO/Minibatch/Backward");
+					if (useGradScaler) {
+						if (trainPolicy)
+							gradScaler->scale(ppoLoss).backward();
+						if (trainCritic)
+							gradScaler->scale(valueLoss).backward();
+					} else {
+						if (trainPolicy)
+							ppoLoss.backward(); // 29%
+						if (trainCritic)
+							valueLoss.backward(); // 24%
+					}
 				}
 
 				threadUpdateMutex.lock();
@@ -270,13 +365,15 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 					noiseTrackerValueNet->Update(valueNet->seq);
 			}
 
+			RG_TRACE_SCOPE("PPO/OptimizerStep");
 			if (trainPolicy)
 				nn::utils::clip_grad_norm_(policy->parameters(), 0.5f);
 			if (trainCritic)
 				nn::utils::clip_grad_norm_(valueNet->parameters(), 0.5f);
 			
+			paramMutex.lock();
 
-			if (autocast) {
+			if (useGradScaler) {
 				if (trainPolicy)
 					gradScaler->step(*policyOptimizer);
 				if (trainCritic)
@@ -292,8 +389,9 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 				_CopyModelParamsHalf(policy, policyHalf);
 			if (valueNetHalf)
 				_CopyModelParamsHalf(valueNet, valueNetHalf);
+			paramMutex.unlock();
 			
-			if (autocast)
+			if (useGradScaler)
 				gradScaler->update();
 			numIterations += 1;
 		}
@@ -307,6 +405,8 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 	meanDivergence /= numMinibatchIterations;
 	meanValLoss /= numMinibatchIterations;
 	meanRatio /= numMinibatchIterations;
+	meanISWeight /= numMinibatchIterations;
+	meanStaleFrac /= numMinibatchIterations;
 
 	float meanClip = 0;
 	if (!clipFractions.empty()) {
@@ -337,6 +437,11 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 	report["Value Function Update Magnitude"] = criticUpdateMagnitude;
 	report["PPO Learn Time"] = totalTimer.Elapsed();
 
+	if (offPolicy)
+		report["Mean IS Weight"] = meanISWeight;
+	if (limitLag)
+		report["Stale Step Fraction"] = meanStaleFrac;
+
 	if (config.measureGradientNoise) {
 		if (noiseTrackerPolicy->lastNoiseScale != 0)
 			report["Grad Noise Policy"] = noiseTrackerPolicy->lastNoiseScale;
@@ -346,6 +451,9 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 
 	policyOptimizer->zero_grad();
 	valueOptimizer->zero_grad();
+
+	expBuffer->proxLogProbs = {};
+	policyVersion++;
 }
 
 // Get sizes of all parameters in a sequence
@@ -364,6 +472,11 @@ constexpr const char* MODEL_FILE_NAMES[] = {
 		"PPO_CRITIC.lt",
 };
 
+constexpr const char* FLAT_MODEL_FILE_NAMES[] = {
+	RLGPC::FlatModel::POLICY_FILE_NAME,
+	RLGPC::FlatModel::CRITIC_FILE_NAME,
+};
+
 constexpr const char* OPTIM_FILE_NAMES[] = {
 	"PPO_POLICY_OPTIM.lt",
 	"PPO_CRITIC_OPTIM.lt",
@@ -417,14 +530,27 @@ void TorchLoadSaveSeq(torch::nn::Sequential seq, std::filesystem::path path, c10
 void TorchLoadSaveAll(RLGPC::PPOLearner* learner, std::filesystem::path folderPath, bool load) {
 
 	if (load) {
-		if (!std::filesystem::exists(folderPath / MODEL_FILE_NAMES[0]))
+		if (!std::filesystem::exists(folderPath / MODEL_FILE_NAMES[0]) && !std::filesystem::exists(folderPath / FLAT_MODEL_FILE_NAMES[0]))
 			RG_ERR_CLOSE("PPOLearner: Failed to find file \"" << MODEL_FILE_NAMES[0] << "\" in " << folderPath << ".")
 	}
 
-	TorchLoadSaveSeq(learner->policy->seq, folderPath / MODEL_FILE_NAMES[0], learner->device, load);
+	for (int i = 0; i < 2; i++) {
+		auto seq = i ? learner->valueNet->seq : learner->policy->seq;
 
-	if (!load || std::filesystem::exists(folderPath / MODEL_FILE_NAMES[1]))
-		TorchLoadSaveSeq(learner->valueNet->seq, folderPath / MODEL_FILE_NAMES[1], learner->device, load);
+		if (load) {
+			// Flat models are quicker to load and have their architecture checked from the header
+			// The training models are modified in-place, so they get their own copy of the weights (which reads the whole file anyway, so the checksum is verified)
+			if (std::filesystem::exists(folderPath / FLAT_MODEL_FILE_NAMES[i])) {
+				RLGPC::FlatModel::Load(seq, folderPath / FLAT_MODEL_FILE_NAMES[i], false, true);
+			} else if (i == 0 || std::filesystem::exists(folderPath / MODEL_FILE_NAMES[i])) {
+				TorchLoadSaveSeq(seq, folderPath / MODEL_FILE_NAMES[i], learner->device, true);
+			}
+		} else {
+			TorchLoadSaveSeq(seq, folderPath / MODEL_FILE_NAMES[i], learner->device, false);
+			std::ofstream flatOut = std::ofstream(folderPath / FLAT_MODEL_FILE_NAMES[i], std::ios::binary);
+			flatOut << RLGPC::FlatModel::Save(seq);
+		}
+	}
 
 	if (load) {
 		if (learner->policyHalf)
@@ -481,13 +607,39 @@ void RLGPC::PPOLearner::SaveTo(std::filesystem::path folderPath) {
 	TorchLoadSaveAll(this, folderPath, false);
 }
 
+void RLGPC::PPOLearner::SaveToSnapshot(CheckpointSnapshot& snapshot) {
+	try {
+		for (int i = 0; i < 2; i++) {
+			std::ostringstream modelStream;
+			torch::save(i ? valueNet->seq : policy->seq, modelStream);
+			snapshot.files[MODEL_FILE_NAMES[i]] = modelStream.str();
+			snapshot.files[FLAT_MODEL_FILE_NAMES[i]] = FlatModel::Save(i ? valueNet->seq : policy->seq);
+
+			std::ostringstream optimStream;
+			torch::serialize::OutputArchive optimArchive;
+			(i ? valueOptimizer : policyOptimizer)->save(optimArchive);
+			optimArchive.save_to(optimStream);
+			snapshot.files[OPTIM_FILE_NAMES[i]] = optimStream.str();
+		}
+	} catch (std::exception& e) {
+		RG_ERR_CLOSE("PPOLearner::SaveToSnapshot(): Failed to serialize models, exception: " << e.what());
+	}
+}
+
 RLGPC::DiscretePolicy* RLGPC::PPOLearner::LoadAdditionalPolicy(std::filesystem::path folderPath) {
 	std::filesystem::path policyPath = folderPath / MODEL_FILE_NAMES[0];
-	if (!std::filesystem::exists(policyPath))
+	std::filesystem::path flatPolicyPath = folderPath / FLAT_MODEL_FILE_NAMES[0];
+	bool hasFlat = std::filesystem::exists(flatPolicyPath);
+	if (!hasFlat && !std::filesystem::exists(policyPath))
 		return NULL;
 
 	RLGPC::DiscretePolicy* newPolicy = new RLGPC::DiscretePolicy(policy->inputAmount, policy->actionAmount, policy->layerSizes, policy->device);
-	TorchLoadSaveSeq(newPolicy->seq, policyPath, newPolicy->device, true);
+	if (hasFlat) {
+		// Additional policies are only used for inference, so they can use the mapped weights directly
+		FlatModel::Load(newPolicy->seq, flatPolicyPath, true);
+	} else {
+		TorchLoadSaveSeq(newPolicy->seq, policyPath, newPolicy->device, true);
+	}
 	return newPolicy;
 }
 
@@ -11,6 +11,7 @@
 #include "../Util/gradscaler.hpp"
 #include "../Util/GradNoiseTracker.h"
 #include "../Util/ThreadPool.h"
+#include "../Util/CheckpointWriter.h"
 
 namespace RLGPC {
 	// https://github.com/AechPro/rlgym-ppo/blob/main/rlgym_ppo/ppo/ppo_learner.py
@@ -30,6 +31,16 @@ namespace RLGPC {
 
 		int cumulativeModelUpdates = 0;
 
+		// Incremented after every call to Learn()
+		uint64_t policyVersion = 0;
+
+		// Bytes of the shuffled batch copies made for each epoch of the last Learn()
+		uint64_t lastStagingBytes = 0;
+
+		// Locked while model parameters are being updated
+		// Allows the value net to be used from another thread while learning
+		std::mutex paramMutex = {};
+
 		PPOLearner(
 			int obsSpaceSize, int actSpaceSize,
 			PPOLearnerConfig config, torch::Device device
@@ -38,6 +49,7 @@ namespace RLGPC {
 		void Learn(ExperienceBuffer* expBuffer, Report& report);
 
 		void SaveTo(std::filesystem::path folderPath);
+		void SaveToSnapshot(CheckpointSnapshot& snapshot); // Serializes models and optimizers in memory
 		void LoadFrom(std::filesystem::path folderPath);
 		RLGPC::DiscretePolicy* LoadAdditionalPolicy(std::filesystem::path folderPath);
 
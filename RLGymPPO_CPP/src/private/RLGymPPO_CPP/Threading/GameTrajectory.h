@@ -14,13 +14,14 @@ namespace RLGPC {
 #endif
 			nextStates,
 			dones,
-			truncateds;
+			truncateds,
+			policyVersions; // Version of the policy that chose the action
 
 		constexpr static size_t TENSOR_AMOUNT =
 #ifdef RG_PARANOID_MODE
-			8;
+			9;
 #else
-			7;
+			8;
 #endif
 
 		torch::Tensor* begin() { return &states; }
@@ -2,6 +2,7 @@
 
 #include "ThreadAgentManager.h"
 #include <RLGymPPO_CPP/Util/Timer.h>
+#include <RLGymSim_CPP/Utils/RewardFunctions/RewardBatch.h>
 
 using namespace RLGPC;
 
@@ -24,6 +25,7 @@ torch::Tensor MakeGamesOBSTensor(std::vector<GameInst*>& games) {
 void _RunFunc(ThreadAgent* ta) {
 	RG_NOGRAD;
 	ta->isRunning = true;
+	RG_TRACE_THREAD_NAME("Agent " + std::to_string(ta->index));
 
 	auto mgr = (ThreadAgentManager*)ta->_manager;
 	auto& games = ta->gameInsts;
@@ -40,6 +42,22 @@ void _RunFunc(ThreadAgent* ta) {
 	bool blockConcurrentInfer = mgr->blockConcurrentInfer;
 	Timer stepTimer = {};
 
+	// Counters only measure the thread that opens them, so they're opened here
+	PerfCounters::ThreadGroup* perfGroup = NULL;
+	if (mgr->perfCounters) {
+		perfGroup = new PerfCounters::ThreadGroup();
+		if (!perfGroup->IsAvailable() && ta->index == 0)
+			RG_LOG("WARNING: Failed to open any performance counters, check /proc/sys/kernel/perf_event_paranoid");
+	}
+
+	// Must be set before the games start, so their first reset is also prepared in the background
+	RLGSC::AsyncResetter* asyncResetter = NULL;
+	if (mgr->asyncEnvReset) {
+		asyncResetter = new RLGSC::AsyncResetter();
+		for (auto game : games)
+			game->gym->SetAsyncResetter(asyncResetter);
+	}
+
 	// Start games
 	for (auto game : games)
 		game->Start();
@@ -55,17 +73,27 @@ void _RunFunc(ThreadAgent* ta) {
 
 	auto policy = (halfPrec ? mgr->policyHalf : mgr->policy);
 
+	// Step results are owned by each game's gym, and stay valid until that game steps again
+	std::vector<RLGSC::Gym::StepResult*> stepResults = {};
+
+	// Rewards of all games are computed together after stepping them
+	RLGSC::RewardBatch rewardBatch = {};
+
 	while (ta->shouldRun) {
 
 		if (render)
 			stepTimer.Reset();
 
-		// Don't run if we reached our step limit
-		while (ta->stepsCollected > ta->maxCollect)
-			THREAD_WAIT();
+		{
+			RG_TRACE_SCOPE("Agent/Wait");
 
-		while (mgr->disableCollection)
-			THREAD_WAIT();
+			// Don't run if we reached our step limit
+			while (ta->stepsCollected > ta->maxCollect)
+				THREAD_WAIT();
+
+			while (mgr->disableCollection)
+				THREAD_WAIT();
+		}
 
 		// Move our current OBS tensor to the device we run the policy on
 		// This conversion time is not counted as a part of policy inference time
@@ -76,23 +104,29 @@ void _RunFunc(ThreadAgent* ta) {
 			curObsTensorDevice = curObsTensor.to(device, true);
 		}
 
+		RG_TRACE_SCOPE("Agent/Step");
+
 		// Infer the policy to get actions for all our agents in all our games
 		Timer policyInferTimer = {};
 		
-
-		if (blockConcurrentInfer)
-			mgr->inferMutex.lock();
+		auto tPolicyVersion = torch::tensor((float)mgr->policyVersion);
 		RLGPC::DiscretePolicy::ActionResult actionResults;
-		try {
-			actionResults = policy->GetAction(curObsTensorDevice, deterministic);
-		} catch (std::exception& e) {
-			RG_ERR_CLOSE("Exception during policy->GetAction(): " << e.what());
-		}
-		if (blockConcurrentInfer)
-			mgr->inferMutex.unlock();
-		if (halfPrec) {
-			actionResults.action = actionResults.action.to(torch::ScalarType::Float);
-			actionResults.logProb = actionResults.logProb.to(torch::ScalarType::Float);
+		{
+			RG_TRACE_SCOPE("Agent/Infer");
+			PerfCounters::ScopedSample perfSample = PerfCounters::ScopedSample(perfGroup, &ta->perf.policyInfer);
+			if (blockConcurrentInfer)
+				mgr->inferMutex.lock();
+			try {
+				actionResults = policy->GetAction(curObsTensorDevice, deterministic);
+			} catch (std::exception& e) {
+				RG_ERR_CLOSE("Exception during policy->GetAction(): " << e.what());
+			}
+			if (blockConcurrentInfer)
+				mgr->inferMutex.unlock();
+			if (halfPrec) {
+				actionResults.action = actionResults.action.to(torch::ScalarType::Float);
+				actionResults.logProb = actionResults.logProb.to(torch::ScalarType::Float);
+			}
 		}
 
 		float policyInferTime = policyInferTimer.Elapsed();
@@ -100,23 +134,43 @@ void _RunFunc(ThreadAgent* ta) {
 
 		// Step the gym with the actions we got
 		Timer gymStepTimer = {};
-		ta->gameStepMutex.lock();
-		float avgRew = 0;
-		auto stepResults = new RLGSC::Gym::StepResult[numGames];
+		stepResults.resize(numGames);
 		int actionsOffset = 0;
-		for (int i = 0; i < numGames; i++) {
-			auto game = games[i];
-			int numPlayers = game->match->playerAmount;
-
-			// Actions output has a dimension for each player, but not for each game
-			// So we will need to slice the section of it that is for this game
-			auto actionSlice = actionResults.action.slice(0, actionsOffset, actionsOffset + numPlayers);
+		{
+			RG_TRACE_SCOPE("Agent/EnvStep");
+			PerfCounters::ScopedSample perfSample = PerfCounters::ScopedSample(perfGroup, &ta->perf.envStep);
+			ta->gameStepMutex.lock();
+			float avgRew = 0;
+			for (int i = 0; i < numGames; i++) {
+				auto game = games[i];
+				int numPlayers = game->match->playerAmount;
+
+				// Actions output has a dimension for each player, but not for each game
+				// So we will need to slice the section of it that is for this game
+				auto actionSlice = actionResults.action.slice(0, actionsOffset, actionsOffset + numPlayers);
+
+				stepResults[i] = &game->StepWithoutRewards(TENSOR_TO_ILIST(actionSlice));
+
+				actionsOffset += numPlayers;
+			}
 
-			stepResults[i] = game->Step(TENSOR_TO_ILIST(actionSlice));
+			{
+				RG_TRACE_SCOPE("Agent/Rewards");
+				rewardBatch.Clear();
+				for (int i = 0; i < numGames; i++)
+					rewardBatch.AddGame(*stepResults[i]->state, games[i]->match->prevActions, stepResults[i]->done, games[i]->match->rewardFn);
+				rewardBatch.Evaluate();
+
+				for (int i = 0; i < numGames; i++) {
+					const float* gameRewards = rewardBatch.GetGameRewards(i);
+					stepResults[i]->reward.assign(gameRewards, gameRewards + games[i]->match->playerAmount);
+				}
+			}
 
-			actionsOffset += numPlayers;
+			for (int i = 0; i < numGames; i++)
+				games[i]->FinishStep();
+			ta->gameStepMutex.unlock();
 		}
-		ta->gameStepMutex.unlock();
 
 		// Make sure we got the end of actions
 		// Otherwise there's a wrong number of actions for whatever reason
@@ -125,16 +179,22 @@ void _RunFunc(ThreadAgent* ta) {
 		ta->times.envStepTime += envStepTime;
 
 		// Update our tensor storing the next observation after the step, from each gym
-		torch::Tensor nextObsTensor = MakeGamesOBSTensor(games);
+		torch::Tensor nextObsTensor;
+		{
+			RG_TRACE_SCOPE("Agent/MakeOBS");
+			nextObsTensor = MakeGamesOBSTensor(games);
+		}
 
 		if (!render) {
 			// Steps complete, add all timestep data to our trajectories, for each game
+			RG_TRACE_SCOPE("Agent/TrajAppend");
+			PerfCounters::ScopedSample perfSample = PerfCounters::ScopedSample(perfGroup, &ta->perf.trajAppend);
 			Timer trajAppendTimer = {};
 			ta->trajMutex.lock();
 			for (int i = 0, playerOffset = 0; i < numGames; i++) {
 				int numPlayers = games[i]->match->playerAmount;
 
-				auto& stepResult = stepResults[i];
+				auto& stepResult = *stepResults[i];
 
 				float done = (float)stepResult.done;
 				float truncated = (float)false;
@@ -156,7 +216,8 @@ void _RunFunc(ThreadAgent* ta) {
 
 							nextObsTensor[playerOffset + j],
 							tDone,
-							tTruncated
+							tTruncated,
+							tPolicyVersion
 						}
 					);
 				}
@@ -170,18 +231,12 @@ void _RunFunc(ThreadAgent* ta) {
 			// Update renderer
 			auto renderSender = mgr->renderSender;
 			auto renderGame = games[0];
-			renderSender->Send(renderGame->gym->prevState, renderGame->gym->match->prevActions);
+			renderSender->Send(*renderGame->gym->prevState, renderGame->gym->match->prevActions);
 
-			// Delay for render
-			// TODO: Somewhat dumb system using static variables
+			// Delay so the rendered game runs at renderTimeScale
+			// This only paces the render game, which never collects steps
 			{
 				namespace chr = std::chrono;
-				static auto lastRenderTime = chr::high_resolution_clock::now();
-				auto durationSince = chr::high_resolution_clock::now() - lastRenderTime;
-				lastRenderTime = chr::high_resolution_clock::now();
-
-				int64_t micsSince = chr::duration_cast<chr::microseconds>(durationSince).count();
-
 				double timeTaken = stepTimer.Elapsed();
 				double targetTime = (1 / 120.0) * renderGame->gym->tickSkip / mgr->renderTimeScale;
 				double sleepTime = RS_MAX(targetTime - timeTaken, 0);
@@ -193,10 +248,15 @@ void _RunFunc(ThreadAgent* ta) {
 
 		// Now that the step is done, our next OBS becomes our current
 		curObsTensor = nextObsTensor;
+	}
 
-		delete[] stepResults;
+	if (asyncResetter) {
+		for (auto game : games)
+			game->gym->SetAsyncResetter(NULL);
+		delete asyncResetter;
 	}
 
+	delete perfGroup;
 	ta->isRunning = false;
 }
 
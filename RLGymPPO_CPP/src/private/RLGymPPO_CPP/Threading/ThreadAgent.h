@@ -2,6 +2,7 @@
 #include "../PPO/DiscretePolicy.h"
 #include <RLGymPPO_CPP/Threading/GameInst.h>
 #include "GameTrajectory.h"
+#include "../Util/PerfCounters.h"
 
 namespace RLGPC {
 	class ThreadAgent {
@@ -33,6 +34,15 @@ namespace RLGPC {
 		};
 		Times times = {}; // TODO: Convert to use Report instead
 
+		// Hardware counters for each phase of stepping, only collected if ThreadAgentManager::perfCounters is set
+		struct PerfPhases {
+			PerfCounters::Values
+				policyInfer = {},
+				envStep = {},
+				trajAppend = {};
+		};
+		PerfPhases perf = {};
+
 		std::vector<std::vector<GameTrajectory>> trajectories = {};
 		std::atomic<uint64_t> stepsCollected = 0;
 		uint64_t maxCollect;
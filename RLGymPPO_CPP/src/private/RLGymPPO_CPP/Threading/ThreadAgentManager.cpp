@@ -1,5 +1,6 @@
 #include "ThreadAgentManager.h"
 #include <RLGymPPO_CPP/Util/Timer.h>
+#include "../Util/MemoryTracker.h"
 
 void RLGPC::ThreadAgentManager::CreateAgents(EnvCreateFn func, int amount, int gamesPerAgent) {
 	for (int i = 0; i < amount; i++) {
@@ -38,6 +39,7 @@ RLGPC::GameTrajectory RLGPC::ThreadAgentManager::CollectTimesteps(uint64_t amoun
 
 	GameTrajectory result = {};
 	size_t totalTimesteps = 0;
+	uint64_t agentTrajBytes = 0;
 
 	try {
 		// Combine all of their trajectories into one long trajectory
@@ -55,6 +57,7 @@ RLGPC::GameTrajectory RLGPC::ThreadAgentManager::CollectTimesteps(uint64_t amoun
 						traj.data.truncateds[traj.size - 1] = (traj.data.dones[traj.size - 1].item<float>() == 0);
 						trajs.push_back(traj);
 						totalTimesteps += traj.size;
+						agentTrajBytes += MemoryTracker::GetTensorsBytes(traj.data);
 						traj.Clear();
 					} else {
 						// Kinda lame but does happen
@@ -66,6 +69,9 @@ RLGPC::GameTrajectory RLGPC::ThreadAgentManager::CollectTimesteps(uint64_t amoun
 		}
 
 		result.MultiAppend(trajs);
+
+		// The agent trajectories are still alive here, so this is the peak
+		lastTrajectoryBytes = agentTrajBytes + MemoryTracker::GetTensorsBytes(result.data);
 	} catch (std::exception& e) {
 		RG_ERR_CLOSE("Exception concatenating timesteps: " << e.what());
 	}
@@ -104,14 +110,120 @@ void RLGPC::ThreadAgentManager::GetMetrics(Report& report) {
 	// NOTE: Because of non-blocking mode, a good portion of policy inference time is waited when appending trajectories
 	//	This means the trajectory append time is not correct at all, so this is a temporary solution
 	report["Policy Infer Time"] = avgTimes.policyInferTime + avgTimes.trajAppendTime;
+
+	if (perfCounters) {
+		ThreadAgent::PerfPhases totalPerf = {};
+		for (ThreadAgent* agent : agents) {
+			std::string agentPrefix = RS_STR("Perf Agent " << agent->index);
+			PerfCounters::AddToReport(report, agentPrefix + " Policy Infer", agent->perf.policyInfer);
+			PerfCounters::AddToReport(report, agentPrefix + " Env Step", agent->perf.envStep);
+			PerfCounters::AddToReport(report, agentPrefix + " Traj Append", agent->perf.trajAppend);
+
+			totalPerf.policyInfer += agent->perf.policyInfer;
+			totalPerf.envStep += agent->perf.envStep;
+			totalPerf.trajAppend += agent->perf.trajAppend;
+		}
+
+		PerfCounters::AddToReport(report, "Perf Policy Infer", totalPerf.policyInfer);
+		PerfCounters::AddToReport(report, "Perf Env Step", totalPerf.envStep);
+		PerfCounters::AddToReport(report, "Perf Traj Append", totalPerf.trajAppend);
+	}
 }
 
 void RLGPC::ThreadAgentManager::ResetMetrics() {
 	for (auto agent : agents) {
 		agent->times = {};
+		agent->perf = {};
 		agent->gameStepMutex.lock();
 		for (auto game : agent->gameInsts)
 			game->ResetMetrics();
 		agent->gameStepMutex.unlock();
 	}
-}
\ No newline at end of file
+}
+
+constexpr uint32_t EPISODES_FORMAT_VERSION = 1;
+
+std::string RLGPC::ThreadAgentManager::SerializeEpisodes() {
+	std::vector<std::vector<DataStreamOut>> agentOutputs = std::vector<std::vector<DataStreamOut>>(agents.size());
+
+	std::vector<std::thread> threads = {};
+	for (int i = 0; i < agents.size(); i++) {
+		threads.push_back(std::thread([this, i, &agentOutputs] {
+			ThreadAgent* agent = agents[i];
+			std::lock_guard<std::mutex> lock(agent->gameStepMutex);
+			for (GameInst* game : agent->gameInsts) {
+				DataStreamOut out = {};
+				game->SerializeEpisode(out);
+				agentOutputs[i].push_back(std::move(out));
+			}
+		}));
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	uint32_t gameAmount = 0;
+	for (auto& outputs : agentOutputs)
+		gameAmount += outputs.size();
+
+	DataStreamOut result = {};
+	result.WriteMultiple(EPISODES_FORMAT_VERSION, gameAmount);
+	for (auto& outputs : agentOutputs) {
+		for (auto& out : outputs) {
+			result.Write<uint64_t>(out.data.size());
+			result.WriteBytes(out.data.data(), out.data.size());
+		}
+	}
+
+	return std::string(result.data.begin(), result.data.end());
+}
+
+int RLGPC::ThreadAgentManager::DeserializeEpisodes(const std::string& data) {
+	DataStreamIn in = {};
+	in.data = std::vector<byte>(data.begin(), data.end());
+
+	uint32_t version, gameAmount;
+	in.ReadMultiple(version, gameAmount);
+	if (in.IsOverflown() || version != EPISODES_FORMAT_VERSION) {
+		RG_LOG("WARNING: ThreadAgentManager::DeserializeEpisodes(): Saved episodes are from a different version, ignoring them");
+		return 0;
+	}
+
+	// Split into each game's data first, so each agent can restore its games independently
+	std::vector<DataStreamIn> gameInputs = {};
+	for (uint32_t i = 0; i < gameAmount; i++) {
+		uint64_t size = in.Read<uint64_t>();
+		if (in.IsOverflown() || in.GetNumBytesLeft() < size)
+			break;
+
+		DataStreamIn gameIn = {};
+		gameIn.data = std::vector<byte>(in.data.begin() + in.pos, in.data.begin() + in.pos + size);
+		in.pos += size;
+		gameInputs.push_back(std::move(gameIn));
+	}
+
+	std::atomic<int> restoredAmount = 0;
+	std::vector<std::thread> threads = {};
+	size_t gameOffset = 0;
+	for (int i = 0; i < agents.size(); i++) {
+		threads.push_back(std::thread([this, i, gameOffset, &gameInputs, &restoredAmount] {
+			ThreadAgent* agent = agents[i];
+			std::lock_guard<std::mutex> lock(agent->gameStepMutex);
+			for (int j = 0; j < agent->gameInsts.size(); j++) {
+				if (gameOffset + j >= gameInputs.size())
+					break;
+
+				if (agent->gameInsts[j]->DeserializeEpisode(gameInputs[gameOffset + j]))
+					restoredAmount++;
+			}
+		}));
+		gameOffset += agents[i]->gameInsts.size();
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	size_t totalGames = gameOffset;
+	if (gameInputs.size() != totalGames)
+		RG_LOG("WARNING: ThreadAgentManager::DeserializeEpisodes(): Saved " << gameInputs.size() << " episodes, but there are " << totalGames << " games");
+
+	return restoredAmount;
+}
@@ -26,8 +26,21 @@ namespace RLGPC {
 
 		bool disableCollection = false; // Prevents new steps from being started
 
+		// Each agent thread samples hardware counters around inference, env stepping, and trajectory appending
+		bool perfCounters = false;
+
+		// Each agent thread prepares the reset states of its games in the background
+		bool asyncEnvReset = false;
+
+		// Incremented by the learner every time the policy is updated
+		// Every collected step is tagged with the version that was used to infer it
+		std::atomic<uint64_t> policyVersion = 0;
+
 		Timer iterationTimer = {};
 		double lastIterationTime = 0;
+
+		// Bytes of the agent trajectories (including spare capacity) plus their concatenation, from the last CollectTimesteps()
+		uint64_t lastTrajectoryBytes = 0;
 		WelfordRunningStat obsStats;
 
 		ThreadAgentManager(
@@ -51,10 +64,13 @@ namespace RLGPC {
 				agent->Stop();
 		}
 
-		void SetStepCallback(StepCallback callback) {
-			for (ThreadAgent* agent : agents)
-				for (GameInst* game : agent->gameInsts)
+		void SetStepCallbacks(StepCallback callback, MetricStepCallback metricCallback) {
+			for (ThreadAgent* agent : agents) {
+				for (GameInst* game : agent->gameInsts) {
 					game->stepCallback = callback;
+					game->metricStepCallback = metricCallback;
+				}
+			}
 		}
 
 		void GetMetrics(Report& report);
@@ -62,6 +78,14 @@ namespace RLGPC {
 
 		GameTrajectory CollectTimesteps(uint64_t amount);
 
+		// Serializes the current episode of every game, each agent's games are serialized on their own thread
+		std::string SerializeEpisodes();
+
+		// Restores episodes written by SerializeEpisodes(), in parallel across agents
+		// Games that can't be restored are reset instead
+		// Returns the amount of games restored
+		int DeserializeEpisodes(const std::string& data);
+
 		~ThreadAgentManager() {
 			for (ThreadAgent* agent : agents)
 				delete agent;
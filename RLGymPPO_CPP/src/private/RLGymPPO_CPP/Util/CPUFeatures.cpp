@@ -0,0 +1,101 @@
+#include "CPUFeatures.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define RG_HAS_CPUID_H
+#endif
+
+struct CPUIDRegs {
+	uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+};
+
+CPUIDRegs _CPUID(uint32_t leaf, uint32_t subLeaf) {
+	CPUIDRegs result = {};
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int regs[4];
+	__cpuidex(regs, leaf, subLeaf);
+	result = { (uint32_t)regs[0], (uint32_t)regs[1], (uint32_t)regs[2], (uint32_t)regs[3] };
+#elif defined(RG_HAS_CPUID_H)
+	unsigned int eax, ebx, ecx, edx;
+	if (__get_cpuid_count(leaf, subLeaf, &eax, &ebx, &ecx, &edx))
+		result = { eax, ebx, ecx, edx };
+#endif
+	return result;
+}
+
+// Leaf 7 holds all of the extended feature flags we care about
+const CPUIDRegs& _GetLeaf7(uint32_t subLeaf) {
+	static CPUIDRegs leaf7[2] = { _CPUID(7, 0), _CPUID(7, 1) };
+	return leaf7[subLeaf];
+}
+
+// Register states the OS saves on context switches (XCR0), 0 if it can't be read
+// CPUID only says the CPU supports an extension, using it faults unless the OS has also enabled its registers here
+uint64_t _GetXCR0() {
+	// OSXSAVE, the OS has enabled XGETBV
+	if (!((_CPUID(1, 0).ecx >> 27) & 1))
+		return 0;
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	return _xgetbv(0);
+#elif defined(RG_HAS_CPUID_H)
+	uint32_t eax, edx;
+	asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((uint64_t)edx << 32) | eax;
+#else
+	return 0;
+#endif
+}
+
+bool _HasOSState(uint64_t mask) {
+	static uint64_t xcr0 = _GetXCR0();
+	return (xcr0 & mask) == mask;
+}
+
+// SSE, AVX, opmask, and both halves of the ZMM registers
+constexpr uint64_t XCR0_AVX512_MASK = (1 << 1) | (1 << 2) | (1 << 5) | (1 << 6) | (1 << 7);
+
+// XTILECFG and XTILEDATA
+// On Linux, each process must also request AMX permission, which torch (oneDNN) does itself before using it
+constexpr uint64_t XCR0_AMX_MASK = (1 << 17) | (1 << 18);
+
+bool RLGPC::CPUFeatures::HasAVX512F() {
+	return ((_GetLeaf7(0).ebx >> 16) & 1) && _HasOSState(XCR0_AVX512_MASK);
+}
+
+bool RLGPC::CPUFeatures::HasAVX512BF16() {
+	return HasAVX512F() && ((_GetLeaf7(1).eax >> 5) & 1);
+}
+
+bool RLGPC::CPUFeatures::HasAMXBF16() {
+	// AMX-BF16 is bit 22, AMX-TILE is bit 24
+	uint32_t edx = _GetLeaf7(0).edx;
+	return ((edx >> 22) & 1) && ((edx >> 24) & 1) && _HasOSState(XCR0_AMX_MASK);
+}
+
+bool RLGPC::CPUFeatures::HasNativeBF16() {
+	return HasAVX512BF16() || HasAMXBF16();
+}
+
+std::string RLGPC::CPUFeatures::GetBF16FeatureStr() {
+	std::vector<std::string> names = {};
+	if (HasAVX512F())
+		names.push_back("AVX512F");
+	if (HasAVX512BF16())
+		names.push_back("AVX512-BF16");
+	if (HasAMXBF16())
+		names.push_back("AMX-BF16");
+
+	if (names.empty())
+		return "none";
+
+	std::string result;
+	for (int i = 0; i < names.size(); i++) {
+		if (i > 0)
+			result += ", ";
+		result += names[i];
+	}
+	return result;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <RLGymPPO_CPP/Framework.h>
+
+namespace RLGPC {
+	// Runtime x86 ISA detection, used to decide if CPU bf16 math will be native or emulated
+	// A feature is only reported if both the CPU supports it and the OS has enabled its register state
+	namespace CPUFeatures {
+		bool HasAVX512F();
+		bool HasAVX512BF16();
+		bool HasAMXBF16();
+
+		// True if the CPU has native bf16 matmul support (AVX512-BF16 or AMX-BF16)
+		bool HasNativeBF16();
+
+		// Comma-separated list of relevant supported features, for logging
+		std::string GetBF16FeatureStr();
+	}
+}
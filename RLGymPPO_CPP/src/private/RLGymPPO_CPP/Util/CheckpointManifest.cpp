@@ -0,0 +1,205 @@
+#include "CheckpointManifest.h"
+
+using namespace nlohmann;
+
+json RLGPC::CheckpointManifest::Entry::ToJSON() const {
+	json j = {};
+	j["timesteps"] = timesteps;
+	j["path"] = path;
+	j["skill_rating"] = skillRating;
+	j["file_sizes"] = fileSizes;
+	return j;
+}
+
+RLGPC::CheckpointManifest::Entry RLGPC::CheckpointManifest::Entry::FromJSON(const json& j) {
+	Entry entry = {};
+	entry.timesteps = j["timesteps"];
+	entry.path = j["path"];
+	if (j.contains("skill_rating"))
+		entry.skillRating = j["skill_rating"];
+	if (j.contains("file_sizes"))
+		entry.fileSizes = j["file_sizes"].get<std::map<std::string, uint64_t>>();
+	return entry;
+}
+
+bool RLGPC::CheckpointManifest::ReadFrom(std::filesystem::path folder) {
+	entries.clear();
+
+	std::ifstream fIn(folder / FILE_NAME);
+	if (!fIn.good())
+		return false;
+
+	std::string line;
+	while (std::getline(fIn, line)) {
+		if (line.empty())
+			continue;
+
+		try {
+			json j = json::parse(line);
+			int64_t timesteps = j["timesteps"];
+			if (j.value("removed", false)) {
+				entries.erase(timesteps);
+			} else {
+				entries[timesteps] = Entry::FromJSON(j);
+			}
+		} catch (...) {
+			// Partially-written line from a crash, skip it
+			RG_LOG("CheckpointManifest: Skipping invalid line in " << (folder / FILE_NAME));
+		}
+	}
+
+	return true;
+}
+
+// Timesteps of every checkpoint folder in folder (named by their timesteps), without reading any of them
+static std::map<int64_t, std::filesystem::path> _ListCheckpointFolders(std::filesystem::path folder) {
+	std::map<int64_t, std::filesystem::path> result = {};
+	if (!std::filesystem::is_directory(folder))
+		return result;
+
+	for (auto dirEntry : std::filesystem::directory_iterator(folder)) {
+		if (!dirEntry.is_directory())
+			continue;
+
+		std::string name = dirEntry.path().filename().string();
+		size_t parsedLength = 0;
+		int64_t timesteps;
+		try {
+			timesteps = std::stoll(name, &parsedLength);
+		} catch (...) {
+			continue;
+		}
+
+		if (parsedLength == name.size())
+			result[timesteps] = dirEntry.path();
+	}
+	return result;
+}
+
+static RLGPC::CheckpointManifest::Entry _ScanCheckpoint(int64_t timesteps, std::filesystem::path path, const char* statsFileName) {
+	RLGPC::CheckpointManifest::Entry entry = {};
+	entry.timesteps = timesteps;
+	entry.path = path.filename().string();
+
+	for (auto fileEntry : std::filesystem::directory_iterator(path))
+		if (fileEntry.is_regular_file())
+			entry.fileSizes[fileEntry.path().filename().string()] = fileEntry.file_size();
+
+	std::ifstream fIn(path / statsFileName);
+	if (fIn.good()) {
+		try {
+			json j = json::parse(fIn);
+			if (j.contains("skill_rating"))
+				entry.skillRating = j["skill_rating"];
+		} catch (...) {}
+	}
+
+	return entry;
+}
+
+void RLGPC::CheckpointManifest::RebuildFromScan(std::filesystem::path folder, const char* statsFileName) {
+	entries.clear();
+
+	for (auto& pair : _ListCheckpointFolders(folder))
+		entries[pair.first] = _ScanCheckpoint(pair.first, pair.second, statsFileName);
+}
+
+void RLGPC::CheckpointManifest::ReadOrRebuild(std::filesystem::path folder, const char* statsFileName) {
+	bool valid = ReadFrom(folder);
+
+	// Check every entry against the folder, the manifest can be out of date if checkpoints were moved, deleted, or edited by hand
+	// Entries of deleted checkpoints are pruned, a checkpoint that doesn't match its entry means we can't trust the manifest
+	// Checkpoints without an entry are added
+	if (valid) {
+		bool changed = false;
+		for (auto itr = entries.begin(); itr != entries.end() && valid;) {
+			std::filesystem::path checkpointPath = folder / itr->second.path;
+			if (!std::filesystem::is_directory(checkpointPath)) {
+				RG_LOG("CheckpointManifest: Pruning missing checkpoint " << checkpointPath);
+				itr = entries.erase(itr);
+				changed = true;
+				continue;
+			}
+
+			std::error_code ec;
+			for (auto& pair : itr->second.fileSizes) {
+				if (std::filesystem::file_size(checkpointPath / pair.first, ec) != pair.second || ec) {
+					RG_LOG("CheckpointManifest: Checkpoint " << checkpointPath << " doesn't match the manifest");
+					valid = false;
+					break;
+				}
+			}
+
+			itr++;
+		}
+
+		// A checkpoint is renamed into place before its manifest line is written, so a crash in between leaves it out of the manifest
+		if (valid) {
+			for (auto& pair : _ListCheckpointFolders(folder)) {
+				if (entries.find(pair.first) == entries.end()) {
+					RG_LOG("CheckpointManifest: Adding checkpoint " << pair.second << " that is missing from the manifest");
+					entries[pair.first] = _ScanCheckpoint(pair.first, pair.second, statsFileName);
+					changed = true;
+				}
+			}
+		}
+
+		if (valid && changed) {
+			try {
+				WriteAll(folder);
+			} catch (std::exception& e) {
+				RG_LOG("WARNING: CheckpointManifest: Failed to write updated manifest: " << e.what());
+			}
+		}
+	}
+
+	if (!valid) {
+		RG_LOG("CheckpointManifest: No valid manifest in " << folder << ", rebuilding from folder contents...");
+		RebuildFromScan(folder, statsFileName);
+
+		if (!entries.empty()) {
+			try {
+				WriteAll(folder);
+			} catch (std::exception& e) {
+				RG_LOG("WARNING: CheckpointManifest: Failed to write rebuilt manifest: " << e.what());
+			}
+		}
+	}
+}
+
+void RLGPC::CheckpointManifest::WriteAll(std::filesystem::path folder) const {
+	// Write to a temp file and rename, so an interrupted rewrite doesn't lose the old manifest
+	std::filesystem::path path = folder / FILE_NAME;
+	std::filesystem::path tempPath = path;
+	tempPath += ".tmp";
+
+	{
+		std::ofstream fOut(tempPath);
+		if (!fOut.good())
+			RG_ERR_CLOSE("CheckpointManifest::WriteAll(): Can't open file at " << tempPath);
+
+		for (auto& pair : entries)
+			fOut << pair.second.ToJSON().dump() << '\n';
+	}
+
+	std::filesystem::rename(tempPath, path);
+}
+
+static void _AppendLine(std::filesystem::path path, const json& j) {
+	std::ofstream fOut(path, std::ios::app);
+	if (!fOut.good())
+		RG_ERR_CLOSE("CheckpointManifest: Can't open file at " << path);
+
+	fOut << j.dump() << '\n';
+}
+
+void RLGPC::CheckpointManifest::AppendEntry(std::filesystem::path folder, const Entry& entry) {
+	_AppendLine(folder / FILE_NAME, entry.ToJSON());
+}
+
+void RLGPC::CheckpointManifest::AppendRemoval(std::filesystem::path folder, int64_t timesteps) {
+	json j = {};
+	j["timesteps"] = timesteps;
+	j["removed"] = true;
+	_AppendLine(folder / FILE_NAME, j);
+}
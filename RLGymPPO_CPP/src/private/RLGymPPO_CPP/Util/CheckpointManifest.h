@@ -0,0 +1,41 @@
+#pragma once
+#include <RLGymPPO_CPP/Framework.h>
+
+#include "../../libsrc/json/nlohmann/json.hpp"
+
+namespace RLGPC {
+	// Append-only index of the checkpoints in a checkpoint folder
+	// Lets the learner find checkpoints (and their ratings) without listing the folder and parsing every stats file
+	// Each line is a JSON object, either a saved checkpoint or the removal of one
+	struct CheckpointManifest {
+		constexpr static const char* FILE_NAME = "CHECKPOINT_MANIFEST.jsonl";
+
+		struct Entry {
+			int64_t timesteps;
+			std::string path; // Relative to the checkpoint folder
+			nlohmann::json skillRating = {}; // Null if the checkpoint has no rating
+			std::map<std::string, uint64_t> fileSizes = {};
+
+			nlohmann::json ToJSON() const;
+			static Entry FromJSON(const nlohmann::json& j);
+		};
+
+		std::map<int64_t, Entry> entries = {};
+
+		// Returns false if there is no manifest in the folder
+		bool ReadFrom(std::filesystem::path folder);
+
+		// Makes a new manifest by listing the folder and reading each checkpoint's stats file
+		void RebuildFromScan(std::filesystem::path folder, const char* statsFileName);
+
+		// Reads the manifest if it exists and matches the folder, otherwise rebuilds it and rewrites the manifest file
+		// Entries of checkpoints that no longer exist are pruned, and checkpoints missing from the manifest are added
+		void ReadOrRebuild(std::filesystem::path folder, const char* statsFileName);
+
+		// Overwrites the manifest file with all current entries
+		void WriteAll(std::filesystem::path folder) const;
+
+		static void AppendEntry(std::filesystem::path folder, const Entry& entry);
+		static void AppendRemoval(std::filesystem::path folder, int64_t timesteps);
+	};
+}
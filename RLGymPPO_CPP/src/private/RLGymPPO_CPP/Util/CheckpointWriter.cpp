@@ -0,0 +1,198 @@
+#include "CheckpointWriter.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Flushes a file or folder (its list of entries) to disk, so it survives a power loss
+// Renames are only durable once the folder containing them is synced
+static void _SyncToDisk(std::filesystem::path path, bool isFolder) {
+#ifdef _WIN32
+	// Windows can't flush folders, NTFS journals renames itself
+	if (isFolder)
+		return;
+
+	HANDLE handle = CreateFileW(path.wstring().c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+		RG_ERR_CLOSE("CheckpointWriter: Failed to open " << path << " to flush it");
+	bool success = FlushFileBuffers(handle);
+	CloseHandle(handle);
+#else
+	int fd = open(path.c_str(), isFolder ? (O_RDONLY | O_DIRECTORY) : O_RDONLY);
+	if (fd < 0)
+		RG_ERR_CLOSE("CheckpointWriter: Failed to open " << path << " to flush it");
+	bool success = fsync(fd) == 0;
+	close(fd);
+#endif
+
+	if (!success)
+		RG_ERR_CLOSE("CheckpointWriter: Failed to flush " << path << " to disk");
+}
+
+// Where an existing checkpoint is moved while it is being replaced
+// Must not parse as a number, same as TEMP_FOLDER_NAME
+static std::filesystem::path _GetAsidePath(std::filesystem::path saveFolder, int64_t timesteps) {
+	return saveFolder / (std::string(RLGPC::CheckpointWriter::ASIDE_FOLDER_PREFIX) + std::to_string(timesteps));
+}
+
+RLGPC::CheckpointWriter::CheckpointWriter(std::filesystem::path saveFolder, int checkpointsToKeep, const char* statsFileName)
+	: saveFolder(saveFolder), checkpointsToKeep(checkpointsToKeep) {
+
+	std::filesystem::create_directories(saveFolder);
+
+	// Left over from a save that never finished
+	std::error_code ec;
+	if (std::filesystem::remove_all(saveFolder / TEMP_FOLDER_NAME, ec) > 0)
+		RG_LOG("CheckpointWriter: Removed unfinished checkpoint in " << saveFolder);
+
+	// Left over from a save that was replacing an existing checkpoint
+	// If the replacement never made it into place, the old checkpoint is moved back
+	std::string asidePrefix = ASIDE_FOLDER_PREFIX;
+	for (auto dirEntry : std::filesystem::directory_iterator(saveFolder, ec)) {
+		std::string name = dirEntry.path().filename().string();
+		if (!dirEntry.is_directory() || name.rfind(asidePrefix, 0) != 0)
+			continue;
+
+		std::filesystem::path originalPath = saveFolder / name.substr(asidePrefix.size());
+		if (std::filesystem::exists(originalPath)) {
+			std::filesystem::remove_all(dirEntry.path(), ec);
+		} else {
+			RG_LOG("CheckpointWriter: Restoring checkpoint " << originalPath << " from an unfinished save");
+			std::filesystem::rename(dirEntry.path(), originalPath, ec);
+		}
+	}
+
+	manifest.ReadOrRebuild(saveFolder, statsFileName);
+
+	// Compact removals out of the manifest
+	if (!manifest.entries.empty())
+		manifest.WriteAll(saveFolder);
+
+	thread = std::thread(&CheckpointWriter::_ThreadEntry, this);
+}
+
+void RLGPC::CheckpointWriter::Write(int64_t timesteps, CheckpointSnapshot&& snapshot) {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if (hasPending) {
+		RG_LOG("CheckpointWriter: Previous checkpoint is still being written, waiting...");
+		condVar.wait(lock, [&] { return !hasPending; });
+	}
+
+	pendingTimesteps = timesteps;
+	pendingSnapshot = std::move(snapshot);
+	hasPending = true;
+	condVar.notify_all();
+}
+
+void RLGPC::CheckpointWriter::WaitUntilIdle() {
+	std::unique_lock<std::mutex> lock(mutex);
+	condVar.wait(lock, [&] { return !hasPending; });
+}
+
+RLGPC::CheckpointWriter::~CheckpointWriter() {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		shouldShutdown = true;
+		condVar.notify_all();
+	}
+
+	// The pending checkpoint is still written before the thread stops
+	thread.join();
+}
+
+void RLGPC::CheckpointWriter::_ThreadEntry() {
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condVar.wait(lock, [&] { return hasPending || shouldShutdown; });
+
+			if (!hasPending)
+				return; // Shutting down, nothing left to write
+		}
+
+		// Nothing else touches the pending checkpoint until hasPending is cleared
+		_WriteCheckpoint(pendingTimesteps, pendingSnapshot);
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			pendingSnapshot = {};
+			hasPending = false;
+			condVar.notify_all();
+		}
+	}
+}
+
+void RLGPC::CheckpointWriter::_WriteCheckpoint(int64_t timesteps, const CheckpointSnapshot& snapshot) {
+	constexpr const char* ERROR_PREFIX = "CheckpointWriter::_WriteCheckpoint(): ";
+
+	std::filesystem::path finalPath = saveFolder / std::to_string(timesteps);
+	std::filesystem::path tempPath = saveFolder / TEMP_FOLDER_NAME;
+
+	try {
+		std::filesystem::remove_all(tempPath);
+		std::filesystem::create_directories(tempPath);
+
+		for (auto& pair : snapshot.files) {
+			std::ofstream fOut(tempPath / pair.first, std::ios::binary);
+			fOut.write(pair.second.data(), pair.second.size());
+			fOut.close();
+			if (!fOut.good())
+				RG_ERR_CLOSE(ERROR_PREFIX << "Failed to write " << (tempPath / pair.first));
+
+			_SyncToDisk(tempPath / pair.first, false);
+		}
+		_SyncToDisk(tempPath, true);
+
+		// Any existing checkpoint at the same timesteps is moved aside, and only removed once its replacement is in place
+		std::filesystem::path asidePath = _GetAsidePath(saveFolder, timesteps);
+		bool replacing = std::filesystem::exists(finalPath);
+		if (replacing) {
+			std::filesystem::remove_all(asidePath);
+			std::filesystem::rename(finalPath, asidePath);
+		}
+
+		std::filesystem::rename(tempPath, finalPath);
+		_SyncToDisk(saveFolder, true);
+
+		if (replacing)
+			std::filesystem::remove_all(asidePath);
+	} catch (std::exception& e) {
+		RG_ERR_CLOSE(ERROR_PREFIX << "Failed to save checkpoint to " << finalPath << ", exception: " << e.what());
+	}
+
+	CheckpointManifest::Entry entry = {};
+	entry.timesteps = timesteps;
+	entry.path = std::to_string(timesteps);
+	entry.skillRating = snapshot.skillRating;
+	for (auto& pair : snapshot.files)
+		entry.fileSizes[pair.first] = pair.second.size();
+
+	manifest.entries[timesteps] = entry;
+	CheckpointManifest::AppendEntry(saveFolder, entry);
+
+	RG_LOG("CheckpointWriter: Saved checkpoint " << finalPath);
+
+	_PruneOld();
+}
+
+void RLGPC::CheckpointWriter::_PruneOld() {
+	if (checkpointsToKeep == -1)
+		return;
+
+	while ((int)manifest.entries.size() > checkpointsToKeep) {
+		int64_t lowest = manifest.entries.begin()->first;
+		std::filesystem::path removePath = saveFolder / manifest.entries.begin()->second.path;
+		try {
+			std::filesystem::remove_all(removePath);
+		} catch (std::exception& e) {
+			RG_ERR_CLOSE("Failed to remove old checkpoint from " << removePath << ", exception: " << e.what());
+		}
+		manifest.entries.erase(manifest.entries.begin());
+		CheckpointManifest::AppendRemoval(saveFolder, lowest);
+	}
+}
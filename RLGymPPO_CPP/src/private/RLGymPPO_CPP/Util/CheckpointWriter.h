@@ -0,0 +1,56 @@
+#pragma once
+#include <RLGymPPO_CPP/Framework.h>
+#include "CheckpointManifest.h"
+#include <condition_variable>
+
+namespace RLGPC {
+	// All files of a checkpoint, serialized in memory
+	struct CheckpointSnapshot {
+		std::map<std::string, std::string> files; // File name -> file data
+		nlohmann::json skillRating = {}; // Stored in the manifest
+	};
+
+	// Writes checkpoints on a background thread so saving doesn't stall learning
+	// Checkpoints are written to a temporary folder and flushed to disk, then renamed into place once complete,
+	//	so a crash mid-save never leaves a partial checkpoint that looks valid
+	struct CheckpointWriter {
+		// Checkpoints are written here before being renamed to their timesteps
+		// This name must not parse as a number, so loading will ignore an unfinished checkpoint
+		constexpr static const char* TEMP_FOLDER_NAME = "tmp_checkpoint";
+
+		// A checkpoint being replaced is moved to this prefix + its timesteps until the new one is in place
+		constexpr static const char* ASIDE_FOLDER_PREFIX = "replaced_checkpoint_";
+
+		std::filesystem::path saveFolder;
+		int checkpointsToKeep;
+
+		// Every checkpoint in saveFolder, used for pruning
+		// Updated on disk as checkpoints are written and removed
+		CheckpointManifest manifest = {};
+
+		std::thread thread;
+		std::mutex mutex = {};
+		std::condition_variable condVar = {};
+		bool shouldShutdown = false;
+
+		// Only one checkpoint can be pending at a time, Write() waits if one is still being written
+		bool hasPending = false;
+		int64_t pendingTimesteps = 0;
+		CheckpointSnapshot pendingSnapshot = {};
+
+		CheckpointWriter(std::filesystem::path saveFolder, int checkpointsToKeep, const char* statsFileName);
+
+		RG_NO_COPY(CheckpointWriter);
+
+		void Write(int64_t timesteps, CheckpointSnapshot&& snapshot);
+
+		// Waits until no checkpoint is being written
+		void WaitUntilIdle();
+
+		~CheckpointWriter();
+
+		void _ThreadEntry();
+		void _WriteCheckpoint(int64_t timesteps, const CheckpointSnapshot& snapshot);
+		void _PruneOld();
+	};
+}
@@ -0,0 +1,188 @@
+#include "FlatModel.h"
+
+#include <torch/nn/modules/linear.h>
+
+#include "MappedFile.h"
+
+using namespace RLGPC;
+using namespace RLGPC::FlatModel;
+
+constexpr const char* ERROR_PREFIX = "FlatModel: ";
+
+static uint64_t AlignUp(uint64_t val) {
+	return (val + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN;
+}
+
+static uint64_t FNV1a(const uint8_t* data, uint64_t size) {
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	for (uint64_t i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+static torch::ScalarType DTypeToScalarType(DType dtype) {
+	return (dtype == DType::BFLOAT16) ? torch::kBFloat16 : torch::kFloat32;
+}
+
+static std::vector<torch::nn::LinearImpl*> GetLinearLayers(torch::nn::Sequential& seq) {
+	std::vector<torch::nn::LinearImpl*> result = {};
+	for (auto& child : seq->children())
+		if (auto linear = child->as<torch::nn::Linear>())
+			result.push_back(linear);
+
+	if (result.empty())
+		RG_ERR_CLOSE(ERROR_PREFIX << "Model has no linear layers");
+	return result;
+}
+
+std::string RLGPC::FlatModel::Save(torch::nn::Sequential seq, DType dtype) {
+	RG_NOGRAD;
+
+	auto linears = GetLinearLayers(seq);
+	auto scalarType = DTypeToScalarType(dtype);
+
+	Header header = {};
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.formatVersion = FORMAT_VERSION;
+	header.dtype = dtype;
+	header.inputAmount = linears.front()->weight.size(1);
+	header.outputAmount = linears.back()->weight.size(0);
+	header.numLayers = linears.size() - 1;
+	header.dataOffset = AlignUp(sizeof(Header) + header.numLayers * sizeof(uint32_t));
+
+	std::vector<torch::Tensor> arrays = {};
+	for (auto linear : linears) {
+		arrays.push_back(linear->weight.detach().to(torch::kCPU, scalarType).contiguous());
+		arrays.push_back(linear->bias.detach().to(torch::kCPU, scalarType).contiguous());
+	}
+
+	uint64_t dataSize = 0;
+	for (auto& array : arrays)
+		dataSize = AlignUp(dataSize) + array.nbytes();
+	header.dataSize = dataSize;
+
+	std::string result = std::string(header.dataOffset + dataSize, '\0');
+	uint8_t* resultData = (uint8_t*)result.data();
+
+	uint32_t* layerSizes = (uint32_t*)(resultData + sizeof(Header));
+	for (int i = 0; i < header.numLayers; i++)
+		layerSizes[i] = linears[i]->weight.size(0);
+
+	uint8_t* data = resultData + header.dataOffset;
+	uint64_t offset = 0;
+	for (auto& array : arrays) {
+		offset = AlignUp(offset);
+		memcpy(data + offset, array.data_ptr(), array.nbytes());
+		offset += array.nbytes();
+	}
+
+	header.checksum = FNV1a(data, dataSize);
+	memcpy(resultData, &header, sizeof(Header));
+	return result;
+}
+
+static bool ReadHeaderFromMemory(const uint8_t* data, uint64_t size, Header& outHeader, IList& outLayerSizes) {
+	if (size < sizeof(Header))
+		return false;
+
+	memcpy(&outHeader, data, sizeof(Header));
+	if (memcmp(outHeader.magic, MAGIC, sizeof(MAGIC)) != 0)
+		return false;
+
+	if (outHeader.formatVersion != FORMAT_VERSION)
+		RG_ERR_CLOSE(ERROR_PREFIX << "Unsupported format version " << outHeader.formatVersion << " (expected " << FORMAT_VERSION << ")");
+
+	if (sizeof(Header) + outHeader.numLayers * sizeof(uint32_t) > size || outHeader.dataOffset + outHeader.dataSize > size)
+		return false;
+
+	outLayerSizes.resize(outHeader.numLayers);
+	const uint32_t* layerSizes = (const uint32_t*)(data + sizeof(Header));
+	for (int i = 0; i < outHeader.numLayers; i++)
+		outLayerSizes[i] = layerSizes[i];
+
+	return true;
+}
+
+bool RLGPC::FlatModel::ReadHeader(std::filesystem::path path, Header& outHeader, IList& outLayerSizes) {
+	std::ifstream in = std::ifstream(path, std::ios::binary);
+	if (!in.good())
+		return false;
+
+	std::vector<uint8_t> headerData = std::vector<uint8_t>(sizeof(Header));
+	in.read((char*)headerData.data(), sizeof(Header));
+	if (in.gcount() != sizeof(Header))
+		return false;
+
+	Header header;
+	memcpy(&header, headerData.data(), sizeof(Header));
+	headerData.resize(sizeof(Header) + header.numLayers * sizeof(uint32_t));
+	in.read((char*)headerData.data() + sizeof(Header), header.numLayers * sizeof(uint32_t));
+
+	// The data itself isn't read, so pretend the file is big enough to hold it
+	return ReadHeaderFromMemory(headerData.data(), UINT64_MAX, outHeader, outLayerSizes);
+}
+
+void RLGPC::FlatModel::Load(torch::nn::Sequential seq, std::filesystem::path path, bool zeroCopy, bool verifyChecksum) {
+	RG_NOGRAD;
+
+	auto mappedFile = std::make_shared<MappedFile>();
+	if (!mappedFile->Map(path))
+		RG_ERR_CLOSE(ERROR_PREFIX << "Failed to map " << path << ", file does not exist or can't be accessed");
+
+	Header header;
+	IList savedLayerSizes;
+	if (!ReadHeaderFromMemory(mappedFile->data, mappedFile->size, header, savedLayerSizes))
+		RG_ERR_CLOSE(ERROR_PREFIX << "File " << path << " is not a valid flat model, or is truncated");
+
+	// Check the architecture before touching any data
+	auto linears = GetLinearLayers(seq);
+	IList curLayerSizes = {};
+	for (int i = 0; i < linears.size() - 1; i++)
+		curLayerSizes.push_back(linears[i]->weight.size(0));
+	int curInputAmount = linears.front()->weight.size(1);
+	int curOutputAmount = linears.back()->weight.size(0);
+
+	if (header.inputAmount != curInputAmount || header.outputAmount != curOutputAmount || savedLayerSizes != curLayerSizes) {
+		std::stringstream stream;
+		stream << ERROR_PREFIX << "Saved model has different size than current model, cannot load model from " << path << ":\n";
+		for (int i = 0; i < 2; i++) {
+			stream << " > " << (i ? "Saved model:   " : "Current model: ");
+			stream << (i ? header.inputAmount : curInputAmount) << " -> [ ";
+			for (int size : (i ? savedLayerSizes : curLayerSizes))
+				stream << size << ' ';
+			stream << "] -> " << (i ? header.outputAmount : curOutputAmount);
+			if (i == 0)
+				stream << ",\n";
+		}
+		RG_ERR_CLOSE(stream.str());
+	}
+
+	uint8_t* data = mappedFile->data + header.dataOffset;
+	if (verifyChecksum && FNV1a(data, header.dataSize) != header.checksum)
+		RG_ERR_CLOSE(ERROR_PREFIX << "Checksum mismatch in " << path << ", file is corrupt");
+
+	auto scalarType = DTypeToScalarType(header.dtype);
+	uint64_t offset = 0;
+	for (auto linear : linears) {
+		for (int i = 0; i < 2; i++) {
+			torch::Tensor& param = i ? linear->bias : linear->weight;
+
+			offset = AlignUp(offset);
+			// Each tensor holds a reference to the mapping, so it is unmapped when they are all gone
+			torch::Tensor mappedTensor = torch::from_blob(
+				data + offset, param.sizes(),
+				[mappedFile](void*) {},
+				torch::TensorOptions().dtype(scalarType)
+			);
+			offset += mappedTensor.nbytes();
+
+			if (zeroCopy && param.device().is_cpu() && param.scalar_type() == scalarType) {
+				param.set_data(mappedTensor);
+			} else {
+				param.copy_(mappedTensor);
+			}
+		}
+	}
+}
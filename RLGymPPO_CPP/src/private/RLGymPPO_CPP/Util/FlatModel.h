@@ -0,0 +1,55 @@
+#pragma once
+#include <RLGymPPO_CPP/Lists.h>
+#include "../FrameworkTorch.h"
+
+namespace RLGPC {
+	// Flat model format, a fixed header followed by the raw weight arrays
+	// Unlike torch archives, this can be memory-mapped and used directly without parsing or copying
+	//
+	// Layout:
+	//	Header
+	//	uint32_t layerSizes[numLayers] (hidden layers)
+	//	Padding to DATA_ALIGN
+	//	For each linear layer: weight [out, in], then bias [out], each aligned to DATA_ALIGN
+	namespace FlatModel {
+		constexpr const char* POLICY_FILE_NAME = "PPO_POLICY.flat";
+		constexpr const char* CRITIC_FILE_NAME = "PPO_CRITIC.flat";
+		constexpr const char* FILE_EXTENSION = ".flat";
+
+		constexpr char MAGIC[8] = { 'R', 'G', 'P', 'F', 'L', 'A', 'T', 0 };
+		constexpr uint32_t FORMAT_VERSION = 1;
+		constexpr uint64_t DATA_ALIGN = 64;
+
+		enum class DType : uint32_t {
+			FLOAT32,
+			BFLOAT16
+		};
+
+		struct Header {
+			char magic[8];
+			uint32_t formatVersion;
+			DType dtype;
+			uint32_t inputAmount;
+			uint32_t outputAmount; // Action amount for policies, 1 for critics
+			uint32_t numLayers;
+			uint32_t _pad;
+			uint64_t dataOffset; // Offset of the first array from the start of the file
+			uint64_t dataSize;
+			uint64_t checksum; // FNV-1a of all bytes from dataOffset to the end
+		};
+		static_assert(sizeof(Header) == 56);
+
+		// Serializes the linear layers of seq
+		std::string Save(torch::nn::Sequential seq, DType dtype = DType::FLOAT32);
+
+		// Only reads the header and layer sizes
+		// Returns false if the file can't be read or isn't a flat model
+		bool ReadHeader(std::filesystem::path path, Header& outHeader, IList& outLayerSizes);
+
+		// Loads into seq, which must have the same architecture as the saved model (checked from the header)
+		// If zeroCopy is set and seq is on the CPU, the parameters will point directly into the mapped file
+		//	(the mapping is copy-on-write, so the file is never modified)
+		// verifyChecksum reads the whole file up front, which defeats the point of zeroCopy, so it is opt-in
+		void Load(torch::nn::Sequential seq, std::filesystem::path path, bool zeroCopy, bool verifyChecksum = false);
+	}
+}
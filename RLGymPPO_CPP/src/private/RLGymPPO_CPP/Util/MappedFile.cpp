@@ -0,0 +1,61 @@
+#include "MappedFile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool RLGPC::MappedFile::Map(std::filesystem::path path) {
+#ifdef _WIN32
+	fileHandle = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+		return false;
+	size = fileSize.QuadPart;
+
+	mappingHandle = CreateFileMappingW(fileHandle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	if (!mappingHandle)
+		return false;
+
+	data = (uint8_t*)MapViewOfFile(mappingHandle, FILE_MAP_COPY, 0, 0, 0);
+	return data != NULL;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+		close(fd);
+		return false;
+	}
+	size = fileStat.st_size;
+
+	void* mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd); // The mapping stays valid after the file is closed
+	if (mapped == MAP_FAILED)
+		return false;
+
+	data = (uint8_t*)mapped;
+	return true;
+#endif
+}
+
+RLGPC::MappedFile::~MappedFile() {
+#ifdef _WIN32
+	if (data)
+		UnmapViewOfFile(data);
+	if (mappingHandle)
+		CloseHandle(mappingHandle);
+	if (fileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(fileHandle);
+#else
+	if (data)
+		munmap(data, size);
+#endif
+}
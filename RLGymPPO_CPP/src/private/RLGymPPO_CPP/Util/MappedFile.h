@@ -0,0 +1,31 @@
+#pragma once
+#include <RLGymPPO_CPP/Framework.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#endif
+
+namespace RLGPC {
+	// Read-only file mapped with copy-on-write, so writes to the memory never reach the file
+	// Unmapped on destruction, hold it in a shared_ptr to keep it alive as long as something is using the memory
+	struct MappedFile {
+		uint8_t* data = NULL;
+		uint64_t size = 0;
+
+#ifdef _WIN32
+		HANDLE fileHandle = INVALID_HANDLE_VALUE;
+		HANDLE mappingHandle = NULL;
+#endif
+
+		MappedFile() = default;
+		RG_NO_COPY(MappedFile);
+
+		// Returns false if the file couldn't be mapped
+		bool Map(std::filesystem::path path);
+
+		~MappedFile();
+	};
+}
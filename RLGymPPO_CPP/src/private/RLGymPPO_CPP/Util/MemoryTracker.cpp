@@ -0,0 +1,64 @@
+#include "MemoryTracker.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#endif
+
+uint64_t RLGPC::MemoryTracker::GetModuleBytes(torch::nn::Module& module) {
+	uint64_t total = 0;
+	for (auto& param : module.parameters()) {
+		total += GetTensorBytes(param);
+		total += GetTensorBytes(param.grad());
+	}
+	return total;
+}
+
+uint64_t RLGPC::MemoryTracker::GetAdamStateBytes(torch::optim::Adam& optim) {
+	uint64_t total = 0;
+	for (auto& pair : optim.state()) {
+		auto& state = static_cast<torch::optim::AdamParamState&>(*pair.second);
+		total += GetTensorBytes(state.exp_avg());
+		total += GetTensorBytes(state.exp_avg_sq());
+		total += GetTensorBytes(state.max_exp_avg_sq());
+	}
+	return total;
+}
+
+uint64_t RLGPC::MemoryTracker::GetHeapBytes() {
+#if defined(_WIN32)
+	// Private bytes also includes things that aren't from the heap, but it's close enough for differences
+	PROCESS_MEMORY_COUNTERS_EX counters = {};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&counters, sizeof(counters)))
+		return counters.PrivateUsage;
+	return 0;
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	struct mallinfo2 info = mallinfo2();
+	return info.uordblks + info.hblkhd;
+#else
+	return 0;
+#endif
+}
+
+uint64_t RLGPC::MemoryTracker::GetProcessRSS() {
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters = {};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.WorkingSetSize;
+	return 0;
+#elif defined(__linux__)
+	std::ifstream in = std::ifstream("/proc/self/statm");
+	uint64_t totalPages = 0, residentPages = 0;
+	if (!(in >> totalPages >> residentPages))
+		return 0;
+	return residentPages * sysconf(_SC_PAGESIZE);
+#else
+	return 0;
+#endif
+}
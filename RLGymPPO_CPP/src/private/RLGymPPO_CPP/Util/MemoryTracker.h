@@ -0,0 +1,36 @@
+#pragma once
+#include <RLGymPPO_CPP/Util/MemoryUsage.h>
+#include "../FrameworkTorch.h"
+
+#include <torch/nn/module.h>
+#include <torch/optim/adam.h>
+
+namespace RLGPC {
+	namespace MemoryTracker {
+		inline uint64_t GetTensorBytes(const torch::Tensor& tensor) {
+			return tensor.defined() ? tensor.nbytes() : 0;
+		}
+
+		// Works with any of the tensor containers (TrajectoryTensors, ExperienceTensors, etc.)
+		template <typename T>
+		inline uint64_t GetTensorsBytes(const T& tensors) {
+			uint64_t total = 0;
+			for (const torch::Tensor& tensor : tensors)
+				total += GetTensorBytes(tensor);
+			return total;
+		}
+
+		// Parameters and their gradients
+		uint64_t GetModuleBytes(torch::nn::Module& module);
+
+		// First and second moment estimates (and the max second moment with amsgrad)
+		uint64_t GetAdamStateBytes(torch::optim::Adam& optim);
+
+		// Bytes currently allocated from the heap by the whole process, 0 if unsupported on this platform
+		// Only useful as a difference, e.g. around creating an environment
+		uint64_t GetHeapBytes();
+
+		// Resident memory of the whole process, 0 if unsupported on this platform
+		uint64_t GetProcessRSS();
+	}
+}
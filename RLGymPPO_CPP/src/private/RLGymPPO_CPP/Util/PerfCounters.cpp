@@ -0,0 +1,128 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace RLGPC;
+using namespace RLGPC::PerfCounters;
+
+#ifdef __linux__
+static int OpenCounter(Counter counter, int groupFD, bool excludeKernel) {
+	perf_event_attr attr = {};
+	attr.size = sizeof(attr);
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	attr.exclude_kernel = excludeKernel;
+	attr.exclude_hv = 1;
+
+	switch (counter) {
+	case CYCLES:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CPU_CYCLES;
+		break;
+	case INSTRUCTIONS:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+		break;
+	case LLC_MISSES:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		break;
+	case BRANCH_MISSES:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+		break;
+	case CONTEXT_SWITCHES:
+		attr.type = PERF_TYPE_SOFTWARE;
+		attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+		break;
+	default:
+		return -1;
+	}
+
+	// pid = 0, cpu = -1: The calling thread, on any CPU
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, groupFD, 0);
+}
+#endif
+
+RLGPC::PerfCounters::ThreadGroup::ThreadGroup() {
+	for (int& fd : fds)
+		fd = -1;
+
+#ifdef __linux__
+	for (int i = 0; i < COUNTER_AMOUNT; i++) {
+		Counter counter = (Counter)i;
+
+		// Context switches happen in the kernel, so they need kernel counting
+		// That isn't allowed on locked-down kernels, so fall back to user-only (which may read as zero)
+		int fd = -1;
+		if (counter == CONTEXT_SWITCHES)
+			fd = OpenCounter(counter, leaderFD, false);
+		if (fd < 0)
+			fd = OpenCounter(counter, leaderFD, true);
+
+		if (fd < 0)
+			continue;
+
+		if (leaderFD < 0)
+			leaderFD = fd;
+
+		fds[i] = fd;
+		available[i] = true;
+		readOrder[numOpened] = counter;
+		numOpened++;
+	}
+#endif
+}
+
+RawValues RLGPC::PerfCounters::ThreadGroup::Read() const {
+	RawValues result = {};
+
+#ifdef __linux__
+	if (leaderFD < 0)
+		return result;
+
+	// Group read format: nr, time_enabled, time_running, values[nr]
+	uint64_t data[3 + COUNTER_AMOUNT] = {};
+	if (read(leaderFD, data, sizeof(data)) < (ssize_t)(sizeof(uint64_t) * 3))
+		return result;
+
+	uint64_t nr = RS_MIN(data[0], (uint64_t)numOpened);
+	result.timeEnabled = data[1];
+	result.timeRunning = data[2];
+
+	for (uint64_t i = 0; i < nr; i++)
+		result.counts[readOrder[i]] = data[3 + i];
+#endif
+
+	return result;
+}
+
+Values RLGPC::PerfCounters::GetScaledDelta(const RawValues& start, const RawValues& end) {
+	// Scaling the cumulative counts before subtracting would mix two different running ratios, and could go negative
+	uint64_t timeEnabled = (end.timeEnabled > start.timeEnabled) ? end.timeEnabled - start.timeEnabled : 0;
+	uint64_t timeRunning = (end.timeRunning > start.timeRunning) ? end.timeRunning - start.timeRunning : 0;
+	double scale = (timeRunning > 0 && timeRunning < timeEnabled) ? (double)timeEnabled / timeRunning : 1;
+
+	Values result = {};
+	for (int i = 0; i < COUNTER_AMOUNT; i++)
+		if (end.counts[i] > start.counts[i])
+			result[i] = (uint64_t)((end.counts[i] - start.counts[i]) * scale);
+	return result;
+}
+
+RLGPC::PerfCounters::ThreadGroup::~ThreadGroup() {
+#ifdef __linux__
+	for (int fd : fds)
+		if (fd >= 0)
+			close(fd);
+#endif
+}
+
+void RLGPC::PerfCounters::AddToReport(Report& report, const std::string& prefix, const Values& values) {
+	for (int i = 0; i < COUNTER_AMOUNT; i++)
+		report[prefix + " " + COUNTER_NAMES[i]] = (double)values[i];
+	report[prefix + " IPC"] = values.GetIPC();
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <RLGymPPO_CPP/Util/Report.h>
+
+namespace RLGPC {
+	// Hardware performance counters for the calling thread, using Linux perf_event_open()
+	// On other platforms, or if the kernel doesn't allow it (see /proc/sys/kernel/perf_event_paranoid), counters just read as zero
+	namespace PerfCounters {
+		enum Counter {
+			CYCLES,
+			INSTRUCTIONS,
+			LLC_MISSES,
+			BRANCH_MISSES,
+			CONTEXT_SWITCHES,
+
+			COUNTER_AMOUNT
+		};
+
+		constexpr const char* COUNTER_NAMES[COUNTER_AMOUNT] = {
+			"Cycles",
+			"Instructions",
+			"LLC Misses",
+			"Branch Misses",
+			"Context Switches"
+		};
+
+		struct Values {
+			uint64_t vals[COUNTER_AMOUNT] = {};
+
+			uint64_t& operator[](size_t index) { return vals[index]; }
+			uint64_t operator[](size_t index) const { return vals[index]; }
+
+			Values operator-(const Values& other) const {
+				Values result = {};
+				for (int i = 0; i < COUNTER_AMOUNT; i++)
+					result[i] = vals[i] - other[i];
+				return result;
+			}
+
+			Values& operator+=(const Values& other) {
+				for (int i = 0; i < COUNTER_AMOUNT; i++)
+					vals[i] += other[i];
+				return *this;
+			}
+
+			// Instructions per cycle, 0 if cycles weren't counted
+			double GetIPC() const {
+				return vals[CYCLES] ? (double)vals[INSTRUCTIONS] / vals[CYCLES] : 0;
+			}
+		};
+
+		// Unscaled cumulative counts from one group read, with the times the group was enabled and actually counting
+		struct RawValues {
+			Values counts = {};
+			uint64_t timeEnabled = 0, timeRunning = 0;
+		};
+
+		// Change in counts from start to end
+		// Counters that were multiplexed by the kernel are scaled up to estimate the full count, using the running ratio over just this interval
+		Values GetScaledDelta(const RawValues& start, const RawValues& end);
+
+		// Counters for the thread that created this, must only be read from that thread
+		// All counters are read together with one syscall
+		class ThreadGroup {
+		public:
+			int leaderFD = -1;
+			int fds[COUNTER_AMOUNT];
+			bool available[COUNTER_AMOUNT] = {};
+
+			// Position of each opened counter in the group read, in opening order
+			Counter readOrder[COUNTER_AMOUNT];
+			int numOpened = 0;
+
+			ThreadGroup();
+			RG_NO_COPY(ThreadGroup);
+
+			bool IsAvailable() const { return numOpened > 0; }
+
+			RawValues Read() const;
+
+			~ThreadGroup();
+		};
+
+		// Adds the counter changes over its lifetime to a total
+		// Does nothing if the group is NULL, so it can be left in when counters are disabled
+		struct ScopedSample {
+			const ThreadGroup* group;
+			Values* total;
+			RawValues start;
+
+			ScopedSample(const ThreadGroup* group, Values* total) : group(group), total(total) {
+				if (group)
+					start = group->Read();
+			}
+
+			~ScopedSample() {
+				if (group)
+					*total += GetScaledDelta(start, group->Read());
+			}
+		};
+
+		// Adds "<prefix> <counter name>" for each counter, and "<prefix> IPC"
+		void AddToReport(Report& report, const std::string& prefix, const Values& values);
+	}
+}
@@ -0,0 +1,349 @@
+#include "RolloutRecorder.h"
+#include "MappedFile.h"
+
+using namespace RLGPC;
+using namespace RLGPC::RolloutFormat;
+
+static uint64_t AlignUp(uint64_t val) {
+	return (val + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN;
+}
+
+static DType DTypeFromScalarType(torch::ScalarType scalarType) {
+	switch (scalarType) {
+	case torch::kInt64:
+		return DType::INT64;
+	case torch::kInt32:
+		return DType::INT32;
+	case torch::kUInt8:
+	case torch::kBool:
+		return DType::UINT8;
+	default:
+		return DType::FLOAT32;
+	}
+}
+
+static torch::ScalarType DTypeToScalarType(DType dtype) {
+	switch (dtype) {
+	case DType::INT64:
+		return torch::kInt64;
+	case DType::INT32:
+		return torch::kInt32;
+	case DType::UINT8:
+		return torch::kUInt8;
+	default:
+		return torch::kFloat32;
+	}
+}
+
+// Groups byte N of every element together, so the (often identical) high bytes of floats form long runs
+static void ByteShuffle(const uint8_t* in, uint8_t* out, uint64_t size, uint64_t elemSize) {
+	uint64_t numElems = size / elemSize;
+	for (uint64_t b = 0; b < elemSize; b++)
+		for (uint64_t i = 0; i < numElems; i++)
+			out[b * numElems + i] = in[i * elemSize + b];
+}
+
+static void ByteUnshuffle(const uint8_t* in, uint8_t* out, uint64_t size, uint64_t elemSize) {
+	uint64_t numElems = size / elemSize;
+	for (uint64_t b = 0; b < elemSize; b++)
+		for (uint64_t i = 0; i < numElems; i++)
+			out[i * elemSize + b] = in[b * numElems + i];
+}
+
+// PackBits-style run-length encoding
+// Control byte N < 128: N+1 literal bytes follow
+// Control byte N >= 128: the next byte is repeated N-126 times (2 to 129)
+static std::vector<uint8_t> RLEncode(const uint8_t* in, uint64_t size) {
+	std::vector<uint8_t> out = {};
+	out.reserve(size / 2);
+
+	uint64_t i = 0;
+	while (i < size) {
+		uint64_t runLen = 1;
+		while (i + runLen < size && runLen < 129 && in[i + runLen] == in[i])
+			runLen++;
+
+		if (runLen >= 2) {
+			out.push_back((uint8_t)(runLen + 126));
+			out.push_back(in[i]);
+			i += runLen;
+		} else {
+			// Collect literals until the next run of at least 2
+			uint64_t litStart = i;
+			while (i < size && (i - litStart) < 128) {
+				if (i + 1 < size && in[i + 1] == in[i])
+					break;
+				i++;
+			}
+			out.push_back((uint8_t)(i - litStart - 1));
+			out.insert(out.end(), in + litStart, in + i);
+		}
+	}
+
+	return out;
+}
+
+// Returns false if the data is malformed
+static bool RLDecode(const uint8_t* in, uint64_t inSize, uint8_t* out, uint64_t outSize) {
+	uint64_t i = 0, o = 0;
+	while (i < inSize) {
+		uint8_t control = in[i++];
+		if (control < 128) {
+			uint64_t litLen = control + 1;
+			if (i + litLen > inSize || o + litLen > outSize)
+				return false;
+			memcpy(out + o, in + i, litLen);
+			i += litLen;
+			o += litLen;
+		} else {
+			uint64_t runLen = control - 126;
+			if (i >= inSize || o + runLen > outSize)
+				return false;
+			memset(out + o, in[i++], runLen);
+			o += runLen;
+		}
+	}
+	return o == outSize;
+}
+
+//////////////////////////////////////////////////////////
+
+RLGPC::RolloutRecorder::RolloutRecorder(std::filesystem::path folder, int maxQueued, bool compress)
+	: folder(folder), maxQueued(maxQueued), compress(compress) {
+
+	RG_ASSERT(maxQueued > 0);
+
+	std::filesystem::create_directories(folder);
+
+	// Continue after any chunks from a previous run
+	for (auto& entry : std::filesystem::directory_iterator(folder)) {
+		if (entry.path().extension() != FILE_EXTENSION)
+			continue;
+
+		try {
+			uint64_t index = std::stoull(entry.path().stem().string());
+			nextChunkIndex = RS_MAX(nextChunkIndex, index + 1);
+		} catch (...) {}
+	}
+
+	thread = std::thread(&RolloutRecorder::_ThreadEntry, this);
+}
+
+void RLGPC::RolloutRecorder::Record(const GameTrajectory& traj) {
+	if (traj.size == 0)
+		return;
+
+	// No copies here, the collected tensors are never modified after collection
+	RolloutChunk chunk = {};
+	chunk.obs = traj.data.states.slice(0, 0, traj.size);
+	chunk.actions = traj.data.actions.slice(0, 0, traj.size);
+	chunk.logProbs = traj.data.logProbs.slice(0, 0, traj.size);
+	chunk.rewards = traj.data.rewards.slice(0, 0, traj.size);
+	chunk.dones = traj.data.dones.slice(0, 0, traj.size);
+	chunk.truncateds = traj.data.truncateds.slice(0, 0, traj.size);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (queue.size() >= maxQueued) {
+			chunksDropped++;
+			RG_LOG("WARNING: RolloutRecorder: Writer is falling behind, dropped a chunk of " << traj.size << " steps");
+			return;
+		}
+		queue.push_back(std::move(chunk));
+	}
+	condVar.notify_all();
+}
+
+void RLGPC::RolloutRecorder::WaitUntilIdle() {
+	std::unique_lock<std::mutex> lock(mutex);
+	condVar.wait(lock, [this] { return queue.empty() && !isWriting; });
+}
+
+RLGPC::RolloutRecorder::~RolloutRecorder() {
+	WaitUntilIdle();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		shouldShutdown = true;
+	}
+	condVar.notify_all();
+
+	if (thread.joinable())
+		thread.join();
+}
+
+void RLGPC::RolloutRecorder::_ThreadEntry() {
+	while (true) {
+		RolloutChunk chunk;
+		uint64_t index;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condVar.wait(lock, [this] { return shouldShutdown || !queue.empty(); });
+			if (queue.empty())
+				return;
+
+			chunk = std::move(queue.front());
+			queue.pop_front();
+			index = nextChunkIndex++;
+			isWriting = true;
+		}
+
+		_WriteChunk(index, chunk);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			isWriting = false;
+		}
+		condVar.notify_all();
+	}
+}
+
+void RLGPC::RolloutRecorder::_WriteChunk(uint64_t index, const RolloutChunk& chunk) {
+	constexpr const char* ERROR_PREFIX = "RolloutRecorder::_WriteChunk(): ";
+
+	RG_NOGRAD;
+
+	FileHeader fileHeader = {};
+	memcpy(fileHeader.magic, MAGIC, sizeof(MAGIC));
+	fileHeader.formatVersion = FORMAT_VERSION;
+	fileHeader.columnAmount = RolloutChunk::COLUMN_AMOUNT;
+	fileHeader.numSteps = chunk.GetSize();
+
+	ColumnHeader columnHeaders[RolloutChunk::COLUMN_AMOUNT] = {};
+	std::vector<uint8_t> columnData[RolloutChunk::COLUMN_AMOUNT] = {};
+
+	uint64_t offset = AlignUp(sizeof(FileHeader) + sizeof(columnHeaders));
+	for (int i = 0; i < RolloutChunk::COLUMN_AMOUNT; i++) {
+		ColumnHeader& header = columnHeaders[i];
+		strncpy(header.name, RolloutChunk::COLUMN_NAMES[i], sizeof(header.name) - 1);
+
+		torch::Tensor t = chunk[i];
+		header.dtype = DTypeFromScalarType(t.scalar_type());
+		t = t.to(torch::kCPU, DTypeToScalarType(header.dtype)).contiguous();
+		header.rowSize = (t.dim() > 1) ? (t.numel() / t.size(0)) : 0;
+		header.rawSize = t.nbytes();
+
+		const uint8_t* rawData = (const uint8_t*)t.data_ptr();
+		header.codec = Codec::NONE;
+		if (compress) {
+			std::vector<uint8_t> shuffled = std::vector<uint8_t>(header.rawSize);
+			ByteShuffle(rawData, shuffled.data(), header.rawSize, t.element_size());
+			std::vector<uint8_t> encoded = RLEncode(shuffled.data(), shuffled.size());
+
+			// Only keep it compressed if it actually got smaller
+			if (encoded.size() < header.rawSize) {
+				header.codec = Codec::SHUFFLE_RLE;
+				columnData[i] = std::move(encoded);
+			}
+		}
+
+		if (header.codec == Codec::NONE)
+			columnData[i] = std::vector<uint8_t>(rawData, rawData + header.rawSize);
+
+		header.storedSize = columnData[i].size();
+		header.dataOffset = offset;
+		offset = AlignUp(offset + header.storedSize);
+	}
+
+	// Write to a temporary file first so a partially-written chunk is never read
+	std::filesystem::path finalPath = folder / (std::to_string(index) + FILE_EXTENSION);
+	std::filesystem::path tempPath = folder / (std::to_string(index) + ".tmp");
+	try {
+		std::ofstream out = std::ofstream(tempPath, std::ios::binary);
+		if (!out.good())
+			RG_ERR_CLOSE(ERROR_PREFIX << "Failed to open " << tempPath << " for writing");
+
+		out.write((const char*)&fileHeader, sizeof(FileHeader));
+		out.write((const char*)columnHeaders, sizeof(columnHeaders));
+
+		uint64_t pos = sizeof(FileHeader) + sizeof(columnHeaders);
+		for (int i = 0; i < RolloutChunk::COLUMN_AMOUNT; i++) {
+			std::string padding = std::string(columnHeaders[i].dataOffset - pos, '\0');
+			out.write(padding.data(), padding.size());
+			out.write((const char*)columnData[i].data(), columnData[i].size());
+			pos = columnHeaders[i].dataOffset + columnHeaders[i].storedSize;
+		}
+
+		out.close();
+		if (out.fail())
+			RG_ERR_CLOSE(ERROR_PREFIX << "Failed to write " << tempPath);
+
+		std::filesystem::rename(tempPath, finalPath);
+		bytesWritten += pos;
+	} catch (std::exception& e) {
+		RG_ERR_CLOSE(ERROR_PREFIX << "Failed to save chunk to " << finalPath << ", exception: " << e.what());
+	}
+
+	chunksWritten++;
+}
+
+//////////////////////////////////////////////////////////
+
+RLGPC::RolloutReader::RolloutReader(std::filesystem::path folder) {
+	std::map<uint64_t, std::filesystem::path> sortedPaths = {};
+	if (std::filesystem::is_directory(folder)) {
+		for (auto& entry : std::filesystem::directory_iterator(folder)) {
+			if (entry.path().extension() != FILE_EXTENSION)
+				continue;
+
+			try {
+				sortedPaths[std::stoull(entry.path().stem().string())] = entry.path();
+			} catch (...) {}
+		}
+	}
+
+	for (auto& pair : sortedPaths)
+		chunkPaths.push_back(pair.second);
+}
+
+RolloutChunk RLGPC::RolloutReader::ReadChunk(size_t index) const {
+	constexpr const char* ERROR_PREFIX = "RolloutReader::ReadChunk(): ";
+
+	RG_ASSERT(index < chunkPaths.size());
+	auto& path = chunkPaths[index];
+
+	auto mappedFile = std::make_shared<MappedFile>();
+	if (!mappedFile->Map(path))
+		RG_ERR_CLOSE(ERROR_PREFIX << "Failed to map " << path);
+
+	const uint8_t* data = mappedFile->data;
+	FileHeader fileHeader;
+	if (mappedFile->size < sizeof(FileHeader))
+		RG_ERR_CLOSE(ERROR_PREFIX << "File " << path << " is truncated");
+	memcpy(&fileHeader, data, sizeof(FileHeader));
+
+	if (memcmp(fileHeader.magic, MAGIC, sizeof(MAGIC)) != 0 || fileHeader.formatVersion != FORMAT_VERSION)
+		RG_ERR_CLOSE(ERROR_PREFIX << "File " << path << " is not a rollout chunk or is from a different format version");
+
+	if (fileHeader.columnAmount != RolloutChunk::COLUMN_AMOUNT)
+		RG_ERR_CLOSE(ERROR_PREFIX << "File " << path << " has " << fileHeader.columnAmount << " columns, expected " << RolloutChunk::COLUMN_AMOUNT);
+
+	RolloutChunk result = {};
+	for (int i = 0; i < RolloutChunk::COLUMN_AMOUNT; i++) {
+		ColumnHeader header;
+		memcpy(&header, data + sizeof(FileHeader) + i * sizeof(ColumnHeader), sizeof(ColumnHeader));
+		if (header.dataOffset + header.storedSize > mappedFile->size)
+			RG_ERR_CLOSE(ERROR_PREFIX << "File " << path << " is truncated");
+
+		std::vector<int64_t> shape = { (int64_t)fileHeader.numSteps };
+		if (header.rowSize > 0)
+			shape.push_back(header.rowSize);
+
+		auto options = torch::TensorOptions().dtype(DTypeToScalarType(header.dtype));
+		uint8_t* columnData = mappedFile->data + header.dataOffset;
+
+		if (header.codec == Codec::NONE) {
+			// The tensor holds a reference to the mapping, so it stays mapped as long as the tensor exists
+			result[i] = torch::from_blob(columnData, shape, [mappedFile](void*) {}, options);
+		} else {
+			torch::Tensor decoded = torch::empty(shape, options);
+			std::vector<uint8_t> shuffled = std::vector<uint8_t>(header.rawSize);
+			if (decoded.nbytes() != header.rawSize || !RLDecode(columnData, header.storedSize, shuffled.data(), header.rawSize))
+				RG_ERR_CLOSE(ERROR_PREFIX << "Column \"" << header.name << "\" in " << path << " is corrupt");
+
+			ByteUnshuffle(shuffled.data(), (uint8_t*)decoded.data_ptr(), header.rawSize, decoded.element_size());
+			result[i] = decoded;
+		}
+	}
+
+	return result;
+}
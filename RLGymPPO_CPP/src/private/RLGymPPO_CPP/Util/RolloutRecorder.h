@@ -0,0 +1,124 @@
+#pragma once
+#include "../Threading/GameTrajectory.h"
+#include <condition_variable>
+#include <deque>
+
+namespace RLGPC {
+	// Recorded rollout data, one row per step
+	struct RolloutChunk {
+		torch::Tensor
+			obs,
+			actions,
+			logProbs,
+			rewards,
+			dones,
+			truncateds;
+
+		constexpr static size_t COLUMN_AMOUNT = 6;
+		constexpr static const char* COLUMN_NAMES[COLUMN_AMOUNT] = {
+			"obs", "actions", "logProbs", "rewards", "dones", "truncateds"
+		};
+
+		torch::Tensor* begin() { return &obs; }
+		const torch::Tensor* begin() const { return &obs; }
+		torch::Tensor* end() { return &obs + COLUMN_AMOUNT; }
+		const torch::Tensor* end() const { return &obs + COLUMN_AMOUNT; }
+
+		torch::Tensor& operator[](size_t index) { return *(begin() + index); }
+		const torch::Tensor& operator[](size_t index) const { return *(begin() + index); }
+
+		int64_t GetSize() const { return obs.defined() ? obs.size(0) : 0; }
+	};
+
+	// Columnar chunk file, one per recorded iteration
+	//
+	// Layout:
+	//	FileHeader
+	//	ColumnHeader[columnAmount]
+	//	Column data, each aligned to DATA_ALIGN
+	//
+	// Uncompressed columns can be used straight from the mapped file
+	// Compressed columns are byte-shuffled (byte N of every element grouped together), then run-length encoded
+	namespace RolloutFormat {
+		constexpr const char* FILE_EXTENSION = ".rgroll";
+		constexpr char MAGIC[8] = { 'R', 'G', 'P', 'R', 'O', 'L', 'L', 0 };
+		constexpr uint32_t FORMAT_VERSION = 1;
+		constexpr uint64_t DATA_ALIGN = 64;
+
+		enum class DType : uint32_t {
+			FLOAT32,
+			INT64,
+			INT32,
+			UINT8
+		};
+
+		enum class Codec : uint32_t {
+			NONE,
+			SHUFFLE_RLE
+		};
+
+		struct FileHeader {
+			char magic[8];
+			uint32_t formatVersion;
+			uint32_t columnAmount;
+			uint64_t numSteps;
+		};
+
+		struct ColumnHeader {
+			char name[16];
+			DType dtype;
+			Codec codec;
+			uint64_t rowSize; // Elements per step, 0 if each step is a single scalar
+			uint64_t dataOffset;
+			uint64_t storedSize;
+			uint64_t rawSize;
+		};
+	}
+
+	// Records every collected step to disk on a background thread
+	// Recording only holds references to the collected tensors, all conversion, compression and I/O happens on the writer thread
+	// If the writer falls too far behind, chunks are dropped instead of slowing down collection
+	class RolloutRecorder {
+	public:
+		std::filesystem::path folder;
+		int maxQueued;
+		bool compress;
+
+		std::thread thread;
+		std::mutex mutex = {};
+		std::condition_variable condVar = {};
+		bool shouldShutdown = false;
+		bool isWriting = false;
+		std::deque<RolloutChunk> queue = {};
+
+		uint64_t nextChunkIndex = 0;
+		std::atomic<uint64_t> chunksWritten = 0, chunksDropped = 0, bytesWritten = 0;
+
+		RolloutRecorder(std::filesystem::path folder, int maxQueued, bool compress);
+
+		RG_NO_COPY(RolloutRecorder);
+
+		void Record(const GameTrajectory& traj);
+
+		// Waits until every queued chunk has been written
+		void WaitUntilIdle();
+
+		~RolloutRecorder();
+
+		void _ThreadEntry();
+		void _WriteChunk(uint64_t index, const RolloutChunk& chunk);
+	};
+
+	// Streams chunks back from a folder written by RolloutRecorder
+	class RolloutReader {
+	public:
+		std::vector<std::filesystem::path> chunkPaths;
+
+		RolloutReader(std::filesystem::path folder);
+
+		size_t GetChunkAmount() const { return chunkPaths.size(); }
+
+		// Uncompressed columns point directly into the mapped file (copy-on-write) instead of being copied
+		RolloutChunk ReadChunk(size_t index) const;
+	};
+}
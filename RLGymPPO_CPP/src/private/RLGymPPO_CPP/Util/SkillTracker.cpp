@@ -93,6 +93,7 @@ void RunThread(
 		auto& game = *gamePtr;
 		auto& gameInst = game.gameInst;
 		gameInst->stepCallback = self->config.stepCallback;
+		gameInst->metricStepCallback = self->config.metricStepCallback;
 
 		DiscretePolicy* oldPolicy = self->oldPolicies[game.oldPolicyIndex];
 		int tickSkip = gameInst->gym->tickSkip;
@@ -107,7 +108,7 @@ void RunThread(
 
 			FList2 teamObsSets[2] = {};
 			for (int j = 0; j < gameInst->match->playerAmount; j++)
-				teamObsSets[(int)gameInst->gym->prevState.players[j].team].push_back(curObsSet[j]);
+				teamObsSets[(int)gameInst->gym->prevState->players[j].team].push_back(curObsSet[j]);
 
 			auto bluePolicy = game.teamSwap ? oldPolicy : curPolicy;
 			auto orangePolicy = game.teamSwap ? curPolicy : oldPolicy;
@@ -120,7 +121,7 @@ void RunThread(
 
 			IList allActions = {};
 			for (int j = 0, blueIdx = 0, orangeIdx = 0; j < gameInst->match->playerAmount; j++) {
-				Team playerTeam = gameInst->gym->prevState.players[j].team;
+				Team playerTeam = gameInst->gym->prevState->players[j].team;
 				if (playerTeam == Team::BLUE) {
 					allActions.push_back(blueActions[blueIdx]);
 					blueIdx++;
@@ -130,9 +131,9 @@ void RunThread(
 				}
 			}
 
-			auto stepResult = gameInst->Step(allActions);
-			if (RLGSC::Math::IsBallScored(stepResult.state.ball.pos)) {
-				auto scoringPolicy = (stepResult.state.ball.pos.y > 0) ? bluePolicy : orangePolicy;
+			auto& stepResult = gameInst->Step(allActions);
+			if (RLGSC::Math::IsBallScored(stepResult.state->ball.pos)) {
+				auto scoringPolicy = (stepResult.state->ball.pos.y > 0) ? bluePolicy : orangePolicy;
 				std::string modeName = ModeNameFromGameInst(game.gameInst);
 				if (!self->config.perModeRatings)
 					modeName = "";
@@ -152,7 +153,7 @@ void RunThread(
 				game.Reset(self->oldPolicies.size());
 
 			if (self->renderSender && threadIdx == 0) {
-				self->renderSender->Send(stepResult.state, gameInst->match->prevActions);
+				self->renderSender->Send(*stepResult.state, gameInst->match->prevActions);
 				float sleepTime = gameInst->gym->tickSkip / 120.f;
 				std::this_thread::sleep_for(std::chrono::microseconds(int64_t(sleepTime * 1000 * 1000)));
 			}
@@ -2,6 +2,11 @@
 #include "Learner.h"
 
 #include "../../private/RLGymPPO_CPP/Util/SkillTracker.h"
+#include "../../private/RLGymPPO_CPP/Util/CheckpointWriter.h"
+#include "../../private/RLGymPPO_CPP/Util/CheckpointManifest.h"
+#include "../../private/RLGymPPO_CPP/Util/RolloutRecorder.h"
+#include "../../private/RLGymPPO_CPP/Util/PerfCounters.h"
+#include "../../private/RLGymPPO_CPP/Util/MemoryTracker.h"
 
 #include <RLGymPPO_CPP/PPO/PPOLearner.h>
 #include <RLGymPPO_CPP/PPO/ExperienceBuffer.h>
@@ -9,17 +14,88 @@
 
 #include <torch/cuda.h>
 #include "../libsrc/json/nlohmann/json.hpp"
+#ifndef RG_NO_PYTHON
 #include <pybind11/embed.h>
+#endif
 
 #ifdef RG_CUDA_SUPPORT
 #include <c10/cuda/CUDACachingAllocator.h>
 #endif
 
+// Different than RLGym-PPO to show that they are not compatible
+constexpr const char* STATS_FILE_NAME = "RUNNING_STATS.json";
+constexpr const char* EPISODES_FILE_NAME = "EPISODES.rsbin";
+
+static uint64_t GetLinearParamAmount(int inputAmount, const RLGSC::IList& layerSizes, int outputAmount) {
+	uint64_t total = 0;
+	int prevSize = inputAmount;
+	for (int layerSize : layerSizes) {
+		total += (uint64_t)(prevSize + 1) * layerSize;
+		prevSize = layerSize;
+	}
+	total += (uint64_t)(prevSize + 1) * outputAmount;
+	return total;
+}
+
+static RLGPC::MemoryUsage EstimateMemoryFromEnv(const RLGPC::LearnerConfig& config, int obsSize, int actionAmount, uint64_t bytesPerEnv) {
+	RLGPC::MemoryUsage result = {};
+
+	// All float32, see GameTrajectory and ExperienceTensors
+	uint64_t stepBytes = (uint64_t)obsSize * 4 * 2 // states, nextStates
+		+ 4 * 7 // actions, logProbs, rewards, dones, truncated, values, advantages
+		+ sizeof(float); // policyVersions
+
+	result.arenas = bytesPerEnv * config.numThreads * config.numGamesPerThread;
+
+	// Agent trajectories grow up to the max collect amount, then get concatenated into one more trajectory
+	uint64_t maxCollect = (uint64_t)(config.timestepsPerIteration * 1.5f);
+	result.trajectories = maxCollect * 2 * stepBytes;
+
+	result.experienceBuffer = config.expBufferSize * (stepBytes + (config.ppo.offPolicyCorrection || config.asyncLearn ? 4 : 0));
+
+	// Each parameter has a gradient and two Adam moments
+	uint64_t paramAmount =
+		GetLinearParamAmount(obsSize, config.ppo.policyLayerSizes, actionAmount) +
+		GetLinearParamAmount(obsSize, config.ppo.criticLayerSizes, 1);
+	result.models = paramAmount * 4 * 4;
+	if (config.ppo.halfPrecModels)
+		result.models += paramAmount * 2;
+
+	// Every full batch gets a shuffled copy of its states, actions, logProbs, values, advantages, policyVersions, and proxLogProbs
+	int64_t batchSize = RS_MIN(config.ppo.batchSize, config.expBufferSize);
+	uint64_t batchedSteps = batchSize > 0 ? (config.expBufferSize / batchSize) * batchSize : 0;
+	result.minibatchStaging = batchedSteps * ((uint64_t)obsSize * 4 + 4 * 5 + sizeof(float));
+
+	return result;
+}
+
+RLGPC::MemoryUsage RLGPC::Learner::EstimateMemory(EnvCreateFn envCreateFn, const LearnerConfig& config) {
+	uint64_t heapBefore = MemoryTracker::GetHeapBytes();
+	auto envCreateResult = envCreateFn();
+	uint64_t bytesPerEnv = MemoryTracker::GetHeapBytes() - heapBefore;
+
+	auto obsSet = envCreateResult.gym->Reset();
+	int obsSize = obsSet[0].size();
+	int actionAmount = envCreateResult.match->actionParser->GetActionAmount();
+	delete envCreateResult.gym;
+	delete envCreateResult.match;
+
+	return EstimateMemoryFromEnv(config, obsSize, actionAmount, bytesPerEnv);
+}
+
 RLGPC::Learner::Learner(EnvCreateFn envCreateFn, LearnerConfig _config) :
 	envCreateFn(envCreateFn),
 	config(_config)
 {
-	pybind11::initialize_interpreter();
+	// Python is only needed by the python metrics sink
+	if (config.sendMetrics && config.metricsSink == MetricSinkType::PYTHON) {
+#ifdef RG_NO_PYTHON
+		RG_ERR_CLOSE("Learner::Learner(): Python metrics are unavailable, RLGymPPO_CPP was built with RG_NO_PYTHON");
+#else
+		pybind11::initialize_interpreter();
+		_pythonStarted = true;
+#endif
+	}
 
 #ifndef NDEBUG
 	RG_LOG("===========================");
@@ -34,6 +110,15 @@ RLGPC::Learner::Learner(EnvCreateFn envCreateFn, LearnerConfig _config) :
 	if (config.standardizeOBS)
 		RG_ERR_CLOSE("LearnerConfig.standardizeOBS has not yet been implemented, sorry");
 
+	if (config.asyncLearn) {
+		config.collectionDuringLearn = true;
+		config.ppo.offPolicyCorrection = true;
+
+		// Async steps are always collected at least one version behind, a max lag of 0 would ignore every step
+		if (config.ppo.maxPolicyLag == 0)
+			RG_ERR_CLOSE("LearnerConfig: ppo.maxPolicyLag must be at least 1 (or -1 to disable) with asyncLearn");
+	}
+
 	RG_LOG("Learner::Learner():");
 
 	if (config.renderMode && !config.renderDuringTraining) {
@@ -99,7 +184,10 @@ RLGPC::Learner::Learner(EnvCreateFn envCreateFn, LearnerConfig _config) :
 
 	{
 		RG_LOG("\tCreating test environment to determine OBS size and action amount...")
+		uint64_t heapBefore = MemoryTracker::GetHeapBytes();
 		auto envCreateResult = envCreateFn();
+		_bytesPerEnv = MemoryTracker::GetHeapBytes() - heapBefore;
+
 		auto obsSet = envCreateResult.gym->Reset();
 		obsSize = obsSet[0].size();
 		actionAmount = envCreateResult.match->actionParser->GetActionAmount();
@@ -109,6 +197,11 @@ RLGPC::Learner::Learner(EnvCreateFn envCreateFn, LearnerConfig _config) :
 		delete envCreateResult.match;
 	}
 
+	{
+		MemoryUsage estimate = EstimateMemoryFromEnv(config, obsSize, actionAmount, _bytesPerEnv);
+		RG_LOG("\tEstimated peak memory usage:\n" << estimate.ToString());
+	}
+
 	RG_LOG("\tCreating experience buffer...");
 	expBuffer = new ExperienceBuffer(config.expBufferSize, config.randomSeed, device);
 
@@ -125,9 +218,11 @@ RLGPC::Learner::Learner(EnvCreateFn envCreateFn, LearnerConfig _config) :
 
 	RG_LOG("\tCreating " << config.numThreads << " agents...");
 	agentMgr->CreateAgents(envCreateFn, config.numThreads, config.numGamesPerThread);
+	agentMgr->perfCounters = config.perfCounters;
+	agentMgr->asyncEnvReset = config.asyncEnvReset;
 
 	if (config.renderMode) {
-		renderSender = new RenderSender();
+		renderSender = new RenderSender(config.renderShmName);
 		agentMgr->renderSender = renderSender;
 		agentMgr->renderTimeScale = config.renderTimeScale;
 		agentMgr->renderDuringTraining = config.renderDuringTraining;
@@ -147,13 +242,44 @@ RLGPC::Learner::Learner(EnvCreateFn envCreateFn, LearnerConfig _config) :
 	if (!config.checkpointLoadFolder.empty())
 		Load();
 
+	if (!config.checkpointSaveFolder.empty()) {
+		checkpointWriter = new CheckpointWriter(config.checkpointSaveFolder, config.checkpointsToKeep, STATS_FILE_NAME);
+	} else {
+		checkpointWriter = NULL;
+	}
+
+	if (!config.rolloutRecordFolder.empty()) {
+		RG_LOG("\tRecording rollouts to " << config.rolloutRecordFolder);
+		rolloutRecorder = new RolloutRecorder(config.rolloutRecordFolder, config.rolloutRecordMaxQueued, config.rolloutRecordCompress);
+	} else {
+		rolloutRecorder = NULL;
+	}
+
+	if (config.traceDumpInterval > 0) {
+#ifdef RG_TRACING
+		RG_LOG("\tWriting traces to " << config.traceFolder << " every " << config.traceDumpInterval << " iteration(s)");
+		RLGSC::Tracing::g_Enabled = true;
+#else
+		RG_LOG("\tWARNING: config.traceDumpInterval is set, but tracing isn't compiled in (build with RG_TRACING)");
+#endif
+	}
+
 	if (config.sendMetrics) {
 		if (!runID.empty())
 			RG_LOG("\tRun ID: " << runID);
-		metricSender = new MetricSender(config.metricsProjectName, config.metricsGroupName, config.metricsRunName, runID);
+		metricSender = new MetricSender(
+			config.metricsProjectName, config.metricsGroupName, config.metricsRunName, runID,
+			config.metricsSink, config.metricsSinkPath
+		);
 	} else {
 		metricSender = NULL;
 	}
+
+#ifndef RG_NO_PYTHON
+	// Release the GIL so the metrics and render threads can use python without the learner thread holding it
+	if (_pythonStarted)
+		_pyThreadState = PyEval_SaveThread();
+#endif
 }
 
 template <typename T>
@@ -169,33 +295,41 @@ nlohmann::json MakeJSONArray(const std::vector<T> list) {
 	return result;
 }
 
-void RLGPC::Learner::SaveStats(std::filesystem::path path) {
-	using namespace nlohmann;
+nlohmann::json MakeSkillRatingJSON(RLGPC::SkillTracker* skillTracker) {
+	if (skillTracker->config.perModeRatings) {
+		nlohmann::json ratings = {};
+		for (auto& pair : skillTracker->curRating.data)
+			ratings[pair.first] = pair.second;
+		return ratings;
+	} else {
+		return skillTracker->curRating.data[""];
+	}
+}
 
+void RLGPC::Learner::SaveStats(std::filesystem::path path) {
 	constexpr const char* ERROR_PREFIX = "Learner::SaveStats(): ";
 
 	std::ofstream fOut(path);
 	if (!fOut.good())
 		RG_ERR_CLOSE(ERROR_PREFIX << "Can't open file at " << path);
 
+	fOut << SaveStatsToString();
+}
+
+std::string RLGPC::Learner::SaveStatsToString() {
+	using namespace nlohmann;
+
 	json j = {};
 	j["cumulative_timesteps"] = totalTimesteps;
 	j["cumulative_model_updates"] = ppo->cumulativeModelUpdates;
 	j["epoch"] = totalEpochs;
 	
-	if (skillTracker) {
-		if (skillTracker->config.perModeRatings) {
-			json ratings = {};
-			for (auto& pair : skillTracker->curRating.data)
-				ratings[pair.first] = pair.second;
-			j["skill_rating"] = ratings;
-		} else {
-			j["skill_rating"] = skillTracker->curRating.data[""];
-		}
-	}
+	if (skillTracker)
+		j["skill_rating"] = MakeSkillRatingJSON(skillTracker);
 
 	auto& rrs = j["reward_running_stats"];
 	{
+		std::lock_guard<std::mutex> lock(returnStatsMutex);
 		rrs["mean"] = MakeJSONArray(returnStats.runningMean);
 		rrs["var"] = MakeJSONArray(returnStats.runningVariance);
 		rrs["shape"] = returnStats.shape;
@@ -205,8 +339,7 @@ void RLGPC::Learner::SaveStats(std::filesystem::path path) {
 	if (config.sendMetrics)
 		j["run_id"] = metricSender->curRunID;
 
-	std::string jStr = j.dump(4);
-	fOut << jStr;
+	return j.dump(4);
 }
 
 void RLGPC::Learner::LoadStats(std::filesystem::path path) {
@@ -240,47 +373,26 @@ void RLGPC::Learner::LoadStats(std::filesystem::path path) {
 		runID = j["run_id"];
 }
 
-// Different than RLGym-PPO to show that they are not compatible
-constexpr const char* STATS_FILE_NAME = "RUNNING_STATS.json";
-
 void RLGPC::Learner::Save() {
 	if (config.checkpointSaveFolder.empty())
 		RG_ERR_CLOSE("Learner::Save(): Cannot save because config.checkpointSaveFolder is not set");
 
-	std::filesystem::path saveFolder = config.checkpointSaveFolder / std::to_string(totalTimesteps);
-	std::filesystem::create_directories(saveFolder);
+	if (!checkpointWriter)
+		checkpointWriter = new CheckpointWriter(config.checkpointSaveFolder, config.checkpointsToKeep, STATS_FILE_NAME);
 
-	RG_LOG("Saving to folder " << saveFolder << "...");
-	SaveStats(saveFolder / STATS_FILE_NAME);
-	ppo->SaveTo(saveFolder);
+	RG_LOG("Saving checkpoint at " << totalTimesteps << " timesteps...");
 
-	// Remove old checkpoints
-	if (config.checkpointsToKeep != -1) {
-		int numCheckpoints = 0;
-		int64_t lowestCheckpointTS = INT64_MAX;
-
-		for (auto entry : std::filesystem::directory_iterator(config.checkpointLoadFolder)) {
-			if (entry.is_directory()) {
-				auto name = entry.path().filename();
-				try {
-					int64_t nameVal = std::stoll(name);
-					lowestCheckpointTS = RS_MIN(nameVal, lowestCheckpointTS);
-					numCheckpoints++;
-				} catch (...) {}
-			}
-		}
-
-		if (numCheckpoints > config.checkpointsToKeep) {
-			std::filesystem::path removePath = config.checkpointLoadFolder / std::to_string(lowestCheckpointTS);
-			try {
-				std::filesystem::remove_all(removePath);
-			} catch (std::exception& e) {
-				RG_ERR_CLOSE("Failed to remove old checkpoint from " << removePath << ", exception: " << e.what());
-			}
-		}
-	}
+	// Serialize everything in memory, the checkpoint writer will write it to disk in the background
+	CheckpointSnapshot snapshot = {};
+	snapshot.files[STATS_FILE_NAME] = SaveStatsToString();
+	if (skillTracker)
+		snapshot.skillRating = MakeSkillRatingJSON(skillTracker);
+	ppo->SaveToSnapshot(snapshot);
+	if (config.saveEpisodeStates)
+		snapshot.files[EPISODES_FILE_NAME] = agentMgr->SerializeEpisodes();
 
-	RG_LOG(" > Done.");
+	checkpointWriter->Write(totalTimesteps, std::move(snapshot));
+	RG_LOG(" > Queued for writing.");
 }
 
 void RLGPC::Learner::Load() {
@@ -289,24 +401,23 @@ void RLGPC::Learner::Load() {
 
 	RG_LOG("Loading most recent checkpoint in " << config.checkpointLoadFolder << "...");
 
-	int64_t highest = -1;
-	if (std::filesystem::is_directory(config.checkpointLoadFolder)) {
-		for (auto entry : std::filesystem::directory_iterator(config.checkpointLoadFolder)) {
-			if (entry.is_directory()) {
-				auto name = entry.path().filename();
-				try {
-					int64_t nameVal = std::stoll(name);
-					highest = RS_MAX(nameVal, highest);
-				} catch (...) {}
-			}
-		}
-	}
+	// Use the manifest to find checkpoints, so we don't need to list the folder and parse every stats file
+	CheckpointManifest manifest = {};
+	manifest.ReadOrRebuild(config.checkpointLoadFolder, STATS_FILE_NAME);
 
-	if (highest != -1) {
-		std::filesystem::path loadFolder = config.checkpointLoadFolder / std::to_string(highest);
+	if (!manifest.entries.empty()) {
+		std::filesystem::path loadFolder = config.checkpointLoadFolder / manifest.entries.rbegin()->second.path;
 		RG_LOG(" > Loading checkpoint " << loadFolder << "...");
 		LoadStats(loadFolder / STATS_FILE_NAME);
 		ppo->LoadFrom(loadFolder);
+
+		std::filesystem::path episodesPath = loadFolder / EPISODES_FILE_NAME;
+		if (config.saveEpisodeStates && std::filesystem::exists(episodesPath)) {
+			std::ifstream episodesIn = std::ifstream(episodesPath, std::ios::binary);
+			std::string episodesData = std::string(std::istreambuf_iterator<char>(episodesIn), std::istreambuf_iterator<char>());
+			int restoredAmount = agentMgr->DeserializeEpisodes(episodesData);
+			RG_LOG(" > Restored " << restoredAmount << " episode(s).");
+		}
 		RG_LOG(" > Done.");
 
 		if (config.skillTrackerConfig.loadOldVersionsFromCheckpoints) {
@@ -322,29 +433,20 @@ void RLGPC::Learner::Load() {
 				
 				nlohmann::json bestRating = {};
 				int64_t bestTimesteps = -1;
-				for (auto entry : std::filesystem::directory_iterator(config.checkpointLoadFolder)) {
-					if (entry.is_directory()) {
-						auto name = entry.path().filename();
-						try {
-							int64_t nameVal = std::stoll(name);
-
-							if (nameVal < targetTimesteps + targetInterval) {
-								if (bestTimesteps == -1 || abs(nameVal - targetTimesteps) < abs(bestTimesteps - targetTimesteps)) {
-
-									std::ifstream fIn(entry.path() / STATS_FILE_NAME);
-									if (fIn.good()) {
-										using namespace nlohmann;
-										json j = json::parse(fIn);
-
-										if (j.contains("skill_rating")) {
-											bestRating = j["skill_rating"];
-											bestTimesteps = nameVal;
-										}
-									}
-								}
-							}
-
-						} catch (...) {}
+				std::string bestPath = {};
+				for (auto& pair : manifest.entries) {
+					int64_t nameVal = pair.first;
+					auto& entry = pair.second;
+
+					if (entry.skillRating.is_null())
+						continue;
+
+					if (nameVal < targetTimesteps + targetInterval) {
+						if (bestTimesteps == -1 || abs(nameVal - targetTimesteps) < abs(bestTimesteps - targetTimesteps)) {
+							bestRating = entry.skillRating;
+							bestTimesteps = nameVal;
+							bestPath = entry.path;
+						}
 					}
 				}
 
@@ -355,7 +457,7 @@ void RLGPC::Learner::Load() {
 						"rating: " << bestRating
 					);
 
-					auto oldPolicy = ppo->LoadAdditionalPolicy(config.checkpointLoadFolder / std::to_string(bestTimesteps));
+					auto oldPolicy = ppo->LoadAdditionalPolicy(config.checkpointLoadFolder / bestPath);
 
 					if (oldPolicy) {
 						skillTracker->AppendOldPolicy(
@@ -376,6 +478,50 @@ void RLGPC::Learner::Load() {
 	}
 }
 
+// Experience that has been collected and processed, and is waiting to be learned on
+struct PendingExperience {
+	RLGPC::ExperienceTensors tensors;
+	RLGPC::Report report;
+	uint64_t timestepsCollected;
+	double collectionTime;
+};
+
+// Hands off experience from the async experience thread to the learning thread
+// Holds at most one pending iteration, so collection is held back if learning is slower
+struct AsyncExperienceQueue {
+	std::mutex mutex = {};
+	std::condition_variable cv = {};
+	std::optional<PendingExperience> pending = {};
+	bool stop = false;
+
+	// Returns false if the queue was stopped
+	bool Push(PendingExperience&& exp) {
+		std::unique_lock<std::mutex> lock(mutex);
+		cv.wait(lock, [&] { return !pending.has_value() || stop; });
+		if (stop)
+			return false;
+
+		pending = std::move(exp);
+		cv.notify_all();
+		return true;
+	}
+
+	PendingExperience Pop() {
+		std::unique_lock<std::mutex> lock(mutex);
+		cv.wait(lock, [&] { return pending.has_value(); });
+		PendingExperience result = std::move(*pending);
+		pending.reset();
+		cv.notify_all();
+		return result;
+	}
+
+	void Stop() {
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+		cv.notify_all();
+	}
+};
+
 // Prints the metrics report in a similar way to rlgym-ppo
 void DisplayReport(const RLGPC::Report& report) {
 	// FORMAT:
@@ -401,6 +547,8 @@ void DisplayReport(const RLGPC::Report& report) {
 		"Consumption Time",
 		"-PPO Learn Time",
 		"Collect-Consume Overlap Time",
+		"Mean IS Weight",
+		"Stale Step Fraction",
 		// TODO: These timers don't work due to non-blocking mode
 		//"--PPO Value Estimate Time",
 		//"--PPO Backprop Data Time",
@@ -427,7 +575,8 @@ void DisplayReport(const RLGPC::Report& report) {
 				prefix += " - ";
 			}
 
-			RG_LOG(prefix << report.SingleToString(name, true));
+			if (report.Has(name))
+				RG_LOG(prefix << report.SingleToString(name, true));
 		} else {
 			RG_LOG("");
 		}
@@ -442,43 +591,114 @@ void RLGPC::Learner::Learn() {
 #endif
 
 	RG_LOG("\tStarting agents...");
-	agentMgr->SetStepCallback(stepCallback);
+	agentMgr->SetStepCallbacks(stepCallback, metricStepCallback);
 	agentMgr->StartAgents();
 
 	auto device = ppo->device;
 
+	// In async mode, a separate thread collects timesteps and processes them into experience
+	AsyncExperienceQueue asyncExpQueue = {};
+	std::thread asyncExpThread;
+	if (config.asyncLearn) {
+		RG_LOG("\tStarting async experience thread...");
+		asyncExpThread = std::thread([&] {
+			RG_TRACE_THREAD_NAME("Async Experience");
+			while (true) {
+				GameTrajectory timesteps;
+				{
+					RG_TRACE_SCOPE("Learner/Collect");
+					timesteps = agentMgr->CollectTimesteps(config.timestepsPerIteration);
+				}
+				if (rolloutRecorder)
+					rolloutRecorder->Record(timesteps);
+
+				PendingExperience pending = {};
+				pending.timestepsCollected = timesteps.size;
+				pending.collectionTime = agentMgr->lastIterationTime;
+				try {
+					RG_TRACE_SCOPE("Learner/AddExperience");
+					AddNewExperience(timesteps, pending.report, &pending.tensors);
+				} catch (std::exception& e) {
+					RG_ERR_CLOSE("Exception during Learner::AddNewExperience(): " << e.what());
+				}
+
+				if (!asyncExpQueue.Push(std::move(pending)))
+					break;
+			}
+		});
+	}
+
 	RG_LOG("\tBeginning learning loop:");
+	RG_TRACE_THREAD_NAME("Learner");
 	int64_t tsSinceSave = 0;
+
+	// Opened on the learner thread, so CPU learning done by the minibatch thread pool isn't counted
+	std::unique_ptr<PerfCounters::ThreadGroup> learnPerfGroup = NULL;
+	if (config.perfCounters)
+		learnPerfGroup = std::make_unique<PerfCounters::ThreadGroup>();
+	int64_t iterationsSinceTraceDump = 0;
 	Timer epochTimer = {};
 	while (totalTimesteps < config.timestepLimit || config.timestepLimit == 0) {
 		Report report = {};
 
-		agentMgr->SetStepCallback(stepCallback);
+		agentMgr->SetStepCallbacks(stepCallback, metricStepCallback);
+
+		uint64_t timestepsCollected;
+		double relCollectionTime;
+		double asyncCollectionTime = 0;
+		if (config.asyncLearn) {
+			// Wait for the next iteration of experience to be ready
+			PendingExperience pending;
+			{
+				RG_TRACE_SCOPE("Learner/WaitForExperience");
+				pending = asyncExpQueue.Pop();
+			}
+			relCollectionTime = epochTimer.Elapsed();
+			timestepsCollected = pending.timestepsCollected;
+			asyncCollectionTime = pending.collectionTime;
+			totalTimesteps += timestepsCollected;
+
+			if (config.ppo.policyLR == 0 && config.ppo.criticLR == 0) {
+				RG_LOG("\tBoth LRs are set to zero. Skipping consumption!");
+				continue;
+			}
+
+			report += pending.report;
+			expBuffer->SubmitExperience(pending.tensors);
+		} else {
+			// Collect the desired timesteps from our agents
+			GameTrajectory timesteps;
+			{
+				RG_TRACE_SCOPE("Learner/Collect");
+				timesteps = agentMgr->CollectTimesteps(config.timestepsPerIteration);
+			}
+			relCollectionTime = epochTimer.Elapsed();
+			timestepsCollected = timesteps.size; // Use actual size instead of target size
 
-		// Collect the desired timesteps from our agents
-		GameTrajectory timesteps = agentMgr->CollectTimesteps(config.timestepsPerIteration);
-		double relCollectionTime = epochTimer.Elapsed();
-		uint64_t timestepsCollected = timesteps.size; // Use actual size instead of target size
+			if (rolloutRecorder)
+				rolloutRecorder->Record(timesteps);
 
-		totalTimesteps += timestepsCollected;
+			totalTimesteps += timestepsCollected;
 
-		if (config.ppo.policyLR == 0 && config.ppo.criticLR == 0) {
-			RG_LOG("\tBoth LRs are set to zero. Skipping consumption!");
+			if (config.ppo.policyLR == 0 && config.ppo.criticLR == 0) {
+				RG_LOG("\tBoth LRs are set to zero. Skipping consumption!");
 #ifdef RG_CUDA_SUPPORT
-			if (ppo->device.is_cuda())
-				c10::cuda::CUDACachingAllocator::emptyCache();
+				if (ppo->device.is_cuda())
+					c10::cuda::CUDACachingAllocator::emptyCache();
 #endif
-			continue;
-		}
+				continue;
+			}
 
-		if (!config.collectionDuringLearn)
-			agentMgr->disableCollection = true;
+			if (!config.collectionDuringLearn)
+				agentMgr->disableCollection = true;
 
-		// Add it to our experience buffer, also computing GAE in the process
-		try {
-			AddNewExperience(timesteps, report);
-		} catch (std::exception& e) {
-			RG_ERR_CLOSE("Exception during Learner::AddNewExperience(): " << e.what());
+			// Add it to our experience buffer, also computing GAE in the process
+			try {
+				RG_TRACE_SCOPE("Learner/AddExperience");
+				AddNewExperience(timesteps, report);
+			} catch (std::exception& e) {
+				RG_ERR_CLOSE("Exception during Learner::AddNewExperience(): " << e.what());
+			}
 		}
 
 		Timer ppoLearnTimer = {};
@@ -487,7 +707,8 @@ void RLGPC::Learner::Learn() {
 		// This is because learning is very GPU intensive, and letting iterations collect during that time slows it down
 		// On CPU, learning is its own thread, it's better to keep collecting
 		// Also, if config.collectionDuringLearn is false, we ignore this
-		bool blockAgentInferDuringLearn = config.collectionDuringLearn && !device.is_cpu();
+		// In async mode, collection always continues
+		bool blockAgentInferDuringLearn = config.collectionDuringLearn && !config.asyncLearn && !device.is_cpu();
 		{ // Run the actual PPO learning on the experience we have collected
 			
 			if (config.deterministic) {
@@ -501,7 +722,10 @@ void RLGPC::Learner::Learn() {
 			if (blockAgentInferDuringLearn)
 				agentMgr->disableCollection = true;
 
+			PerfCounters::Values learnPerf = {};
 			try {
+				RG_TRACE_SCOPE("Learner/PPOLearn");
+				PerfCounters::ScopedSample perfSample = PerfCounters::ScopedSample(learnPerfGroup.get(), &learnPerf);
 				ppo->Learn(expBuffer, report);
 			} catch (std::exception& e) {
 				RG_ERR_CLOSE("Exception during PPOLearner::Learn(): " << e.what());
@@ -510,7 +734,13 @@ void RLGPC::Learner::Learn() {
 			if (blockAgentInferDuringLearn)
 				agentMgr->disableCollection = false;
 
+			// New steps will now be tagged with the updated policy version
+			agentMgr->policyVersion = ppo->policyVersion;
+
 			totalEpochs += config.ppo.epochs;
+
+			if (learnPerfGroup)
+				PerfCounters::AddToReport(report, "Perf PPO Learn", learnPerf);
 		}
 
 		// Free CUDA cache
@@ -527,9 +757,12 @@ void RLGPC::Learner::Learn() {
 
 		if (skillTracker) {
 			RG_LOG("Running skill eval game(s)...");
+			RG_TRACE_SCOPE("Learner/SkillTracker");
 
-			if (config.skillTrackerConfig.stepCallback == NULL)
+			if (config.skillTrackerConfig.stepCallback == NULL && config.skillTrackerConfig.metricStepCallback == NULL) {
 				skillTracker->config.stepCallback = stepCallback;
+				skillTracker->config.metricStepCallback = metricStepCallback;
+			}
 
 			skillTracker->RunGames(ppo->policy, timestepsCollected);
 			for (auto& pair : skillTracker->curRating.data) {
@@ -541,13 +774,36 @@ void RLGPC::Learner::Learn() {
 		// Get all metrics from agent manager
 		agentMgr->GetMetrics(report);
 
+		{ // Add memory usage to report
+			MemoryUsage memUsage = GetMemoryUsage();
+			_memPeak.UpdatePeak(memUsage);
+			_memPeakTotal = RS_MAX(_memPeakTotal, memUsage.GetTotal());
+
+			memUsage.AddToReport(report);
+			_memPeak.AddToReport(report, "Memory Peak");
+			// Peak of the total, rather than the sum of each subsystem's peak
+			report["Memory Peak Total MB"] = _memPeakTotal / (1000.0 * 1000.0);
+			report["Memory Process RSS MB"] = MemoryTracker::GetProcessRSS() / (1000.0 * 1000.0);
+		}
+
+		if (rolloutRecorder) {
+			report["Rollout Chunks Written"] = (int64_t)rolloutRecorder->chunksWritten;
+			report["Rollout Chunks Dropped"] = (int64_t)rolloutRecorder->chunksDropped;
+			report["Rollout MB Written"] = rolloutRecorder->bytesWritten / (1000.0 * 1000.0);
+		}
+
 		if (!config.collectionDuringLearn) {
 			agentMgr->disableCollection = false;
 		}
 
 		// If we collect during consuption, don't just measure the time we waited for to collect for steps
 		// Because of collection during learn, this time could be near-zero, resulting in SPS showing some crazy number
-		double trueCollectionTime = config.collectionDuringLearn ? agentMgr->lastIterationTime : relCollectionTime;
+		double trueCollectionTime;
+		if (config.asyncLearn) {
+			trueCollectionTime = asyncCollectionTime;
+		} else {
+			trueCollectionTime = config.collectionDuringLearn ? agentMgr->lastIterationTime : relCollectionTime;
+		}
 		if (blockAgentInferDuringLearn)
 			trueCollectionTime -= ppoLearnTime; // We couldn't have been collecting during this time
 		trueCollectionTime = RS_MAX(trueCollectionTime, relCollectionTime);
@@ -593,20 +849,41 @@ void RLGPC::Learner::Learn() {
 		// Save if needed
 		tsSinceSave += timestepsCollected;
 		if (tsSinceSave > config.timestepsPerSave && !config.checkpointSaveFolder.empty()) {
+			RG_TRACE_SCOPE("Learner/Save");
 			Save();
 			tsSinceSave = 0;
 		}
 
+#ifdef RG_TRACING
+		if (config.traceDumpInterval > 0 && ++iterationsSinceTraceDump >= config.traceDumpInterval) {
+			std::filesystem::create_directories(config.traceFolder);
+			auto tracePath = config.traceFolder / RS_STR("trace_" << totalTimesteps << ".json");
+			if (!RLGSC::Tracing::DumpChromeTrace(tracePath))
+				RG_LOG("WARNING: Failed to write trace to " << tracePath);
+			iterationsSinceTraceDump = 0;
+		}
+#endif
+
 		// Reset everything
 		agentMgr->ResetMetrics();
 	}
 	
 	RG_LOG("Learner: Timestep limit of " << config.timestepLimit << " reached, stopping");
+	if (config.asyncLearn) {
+		RG_LOG("\tStopping async experience thread...");
+		asyncExpQueue.Stop();
+		asyncExpThread.join();
+	}
 	RG_LOG("\tStopping agents...");
 	agentMgr->StopAgents();
+
+	if (checkpointWriter) {
+		RG_LOG("\tWaiting for checkpoint writer...");
+		checkpointWriter->WaitUntilIdle();
+	}
 }
 
-void RLGPC::Learner::AddNewExperience(GameTrajectory& gameTraj, Report& report) {
+void RLGPC::Learner::AddNewExperience(GameTrajectory& gameTraj, Report& report, ExperienceTensors* outTensors) {
 	RG_NOGRAD;
 
 	RG_LOG("Adding experience...");
@@ -635,7 +912,9 @@ void RLGPC::Learner::AddNewExperience(GameTrajectory& gameTraj, Report& report)
 			auto finalNextState = torch::unsqueeze(trajData.nextStates[count - 1], 0);
 			statesPart = torch::cat({ statesPart, finalNextState });
 		}
+		ppo->paramMutex.lock();
 		auto valPredsPart = ppo->valueNet->Forward(statesPart.to(ppo->device, true, true)).cpu().flatten();
+		ppo->paramMutex.unlock();
 		RG_ASSERT(valPredsPart.size(0) == (end - start));
 		valPredsTensor.slice(0, start, end).copy_(valPredsPart, true);
 	}
@@ -649,6 +928,7 @@ void RLGPC::Learner::AddNewExperience(GameTrajectory& gameTraj, Report& report)
 		c10::cuda::CUDACachingAllocator::emptyCache();
 #endif
 	
+	std::lock_guard<std::mutex> returnStatsLock(returnStatsMutex);
 	float retStd = (config.standardizeReturns ? returnStats.GetSTD()[0] : 1);
 
 	// Compute GAE stuff
@@ -695,12 +975,18 @@ void RLGPC::Learner::AddNewExperience(GameTrajectory& gameTraj, Report& report)
 			trajData.nextStates,
 			trajData.dones,
 			trajData.truncateds,
+			trajData.policyVersions,
 			valueTargets,
 			advantages
 	};
-	expBuffer->SubmitExperience(
-		expTensors
-	);
+
+	if (outTensors) {
+		*outTensors = expTensors;
+	} else {
+		expBuffer->SubmitExperience(
+			expTensors
+		);
+	}
 }
 
 void RLGPC::Learner::UpdateLearningRates(float policyLR, float criticLR) {
@@ -725,21 +1011,70 @@ std::vector<RLGPC::Report> RLGPC::Learner::GetAllGameMetrics() {
 	std::vector<Report> reports = {};
 
 	for (auto agent : agentMgr->agents) {
-		agent->gameStepMutex.lock();
+		// Metric shards can be read while the games are stepping, but reports from StepCallback can't
+		bool needLock = false;
 		for (auto game : agent->gameInsts)
-			if (!game->_metrics.data.empty())
-				reports.push_back(game->_metrics);
-		agent->gameStepMutex.unlock();
+			needLock |= (game->stepCallback != NULL);
+
+		if (needLock)
+			agent->gameStepMutex.lock();
+		for (auto game : agent->gameInsts) {
+			Report report = game->_metrics;
+			game->_metricShard.AddToReport(report);
+			if (!report.data.empty())
+				reports.push_back(report);
+		}
+		if (needLock)
+			agent->gameStepMutex.unlock();
 	}
 
 	return reports;
 }
 
+RLGPC::Report RLGPC::Learner::GetMergedGameMetrics() {
+	Report report = {};
+	for (auto& gameReport : GetAllGameMetrics())
+		for (auto& pair : gameReport.data)
+			report.Accum(pair.first, pair.second);
+	return report;
+}
+
+RLGPC::MemoryUsage RLGPC::Learner::GetMemoryUsage() {
+	MemoryUsage result = {};
+
+	for (auto agent : agentMgr->agents)
+		result.arenas += _bytesPerEnv * agent->gameInsts.size();
+
+	result.trajectories = agentMgr->lastTrajectoryBytes;
+
+	result.experienceBuffer = 
+		MemoryTracker::GetTensorsBytes(expBuffer->data) + MemoryTracker::GetTensorBytes(expBuffer->proxLogProbs);
+
+	torch::nn::Module* models[] = { ppo->policy, ppo->policyHalf, ppo->valueNet, ppo->valueNetHalf };
+	for (torch::nn::Module* model : models)
+		if (model)
+			result.models += MemoryTracker::GetModuleBytes(*model);
+	result.models += MemoryTracker::GetAdamStateBytes(*ppo->policyOptimizer);
+	result.models += MemoryTracker::GetAdamStateBytes(*ppo->valueOptimizer);
+
+	result.minibatchStaging = ppo->lastStagingBytes;
+
+	return result;
+}
+
 RLGPC::Learner::~Learner() {
+	delete checkpointWriter; // Finishes writing any pending checkpoint
+	delete rolloutRecorder; // Finishes writing any queued chunks
 	delete ppo;
 	delete agentMgr;
 	delete expBuffer;
 	delete metricSender;
 	delete renderSender;
-	pybind11::finalize_interpreter();
+
+#ifndef RG_NO_PYTHON
+	if (_pythonStarted) {
+		PyEval_RestoreThread((PyThreadState*)_pyThreadState);
+		pybind11::finalize_interpreter();
+	}
+#endif
 }
\ No newline at end of file
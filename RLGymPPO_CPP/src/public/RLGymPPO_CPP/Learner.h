@@ -4,6 +4,7 @@
 #include "Util/WelfordRunningStat.h"
 #include "Util/MetricSender.h"
 #include "Util/RenderSender.h"
+#include "Util/MemoryUsage.h"
 #include "LearnerConfig.h"
 
 namespace RLGPC {
@@ -23,21 +24,33 @@ namespace RLGPC {
 		RenderSender* renderSender;
 
 		struct SkillTracker* skillTracker;
+		struct CheckpointWriter* checkpointWriter;
+		class RolloutRecorder* rolloutRecorder;
 
 		int obsSize;
 		int actionAmount;
 
 		std::string runID = {};
 
+		bool _pythonStarted = false;
+		void* _pyThreadState = NULL; // Saved when the learner thread releases the GIL
+
 		uint64_t
 			totalTimesteps = 0,
 			totalEpochs = 0;
+
+		// Heap growth from creating one environment, measured with the test environment
+		uint64_t _bytesPerEnv = 0;
+		MemoryUsage _memPeak = {};
+		uint64_t _memPeakTotal = 0;
 			
 		WelfordRunningStat returnStats = WelfordRunningStat(1);
+		std::mutex returnStatsMutex = {};
 
 		Learner(EnvCreateFn envCreateFunc, LearnerConfig config);
 		void Learn();
-		void AddNewExperience(class GameTrajectory& gameTraj, Report& report);
+		// If outTensors is set, the processed experience is written there instead of being submitted to the experience buffer
+		void AddNewExperience(class GameTrajectory& gameTraj, Report& report, struct ExperienceTensors* outTensors = NULL);
 
 		void UpdateLearningRates(float policyLR, float criticLR);
 
@@ -46,13 +59,25 @@ namespace RLGPC {
 
 		std::vector<Report> GetAllGameMetrics();
 
+		// All game metrics summed into one report (averages from AccumAvg() are combined across games)
+		Report GetMergedGameMetrics();
+
+		// Current bytes used by each subsystem
+		MemoryUsage GetMemoryUsage();
+
+		// Dry run: estimates the peak memory of each subsystem for this config without creating a learner
+		// Only creates one environment (RocketSim must be initialized first)
+		static MemoryUsage EstimateMemory(EnvCreateFn envCreateFn, const LearnerConfig& config);
+
 		void Save();
 		void Load();
 		void SaveStats(std::filesystem::path path);
+		std::string SaveStatsToString();
 		void LoadStats(std::filesystem::path path);
 
 		IterationCallback iterationCallback = NULL;
 		StepCallback stepCallback = NULL;
+		MetricStepCallback metricStepCallback = NULL; // Can be used alongside stepCallback
 
 		RG_NO_COPY(Learner);
 
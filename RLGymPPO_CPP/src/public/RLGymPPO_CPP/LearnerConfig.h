@@ -2,6 +2,7 @@
 #include "Lists.h"
 #include "PPO/PPOLearnerConfig.h"
 #include <RLGymPPO_CPP/Util/SkillTrackerConfig.h>
+#include <RLGymPPO_CPP/Util/MetricSender.h>
 
 namespace RLGPC {
 	enum class LearnerDeviceType {
@@ -23,9 +24,13 @@ namespace RLGPC {
 		float renderTimeScale = 1.5f; 
 
 		// Enable rendering during training
-		// WARNING: This can cause tons of lag and another issues, and sometimes crashes due to python lagging out
+		// One agent thread is dedicated to a single rendered game, which doesn't collect any steps
 		bool renderDuringTraining = false;
 
+		// Name of the shared memory that render frames are written to
+		// Run python_scripts/render_receiver.py with the same name to view them
+		std::string renderShmName = "rlgymppo_render";
+
 		// Set to 0 to disable
 		uint64_t timestepLimit = 0;
 
@@ -45,6 +50,13 @@ namespace RLGPC {
 		// Note that, once the learning phase completes and the policy is updated, these additional steps are from the old policy
 		bool collectionDuringLearn = false;
 
+		// Fully pipeline the learning loop:
+		//	collection of the next iteration, experience processing (GAE) of the current iteration, and PPO learning all run at once
+		// Steps collected by older policies are corrected with ppo.offPolicyCorrection, which this enables
+		// Use ppo.maxPolicyLag to limit how old these steps can be
+		// This overrides collectionDuringLearn to true
+		bool asyncLearn = false;
+
 		PPOLearnerConfig ppo = {};
 
 		float gaeLambda = 0.95f;
@@ -62,10 +74,36 @@ namespace RLGPC {
 		std::filesystem::path checkpointSaveFolder = "checkpoints"; 
 		bool saveFolderAddUnixTimestamp = false; // Appends the unix time to checkpointSaveFolder
 
+		// Also save the current episode of every game with checkpoints (arenas, match stats, terminal condition progress)
+		// When loaded, the games continue those episodes instead of all resetting at once
+		bool saveEpisodeStates = false;
+
 		// Save every timestep
 		// Set to zero to just use timestepsPerIteration
 		int64_t timestepsPerSave = 500 * 1000;
 
+		// Record every collected step (obs, action, log prob, reward, done, truncated) to this folder for offline use
+		// Each iteration is written as one compressed columnar chunk on a background thread, see RolloutReader to read them back
+		// Set empty to disable recording
+		std::filesystem::path rolloutRecordFolder = {};
+		int rolloutRecordMaxQueued = 4; // Chunks waiting to be written, more than this and new chunks are dropped
+		bool rolloutRecordCompress = true;
+
+		// Writes a Chrome trace (chrome://tracing or Perfetto) of collection, env steps, and learning every N iterations
+		// Requires building with RG_TRACING, 0 to disable
+		int traceDumpInterval = 0;
+		std::filesystem::path traceFolder = "traces";
+
+		// Reports hardware counters (cycles, instructions, LLC misses, branch misses, context switches) for each agent thread's
+		//	policy inference, env stepping, and trajectory appending, as well as for PPO learning (learner thread only)
+		// Linux only, uses perf_event_open()
+		bool perfCounters = false;
+
+		// Each agent thread gets a background thread that runs the state setters of its games ahead of time,
+		//	so a done game only has to apply an already generated state when it resets
+		// Only helps with expensive state setters (e.g. ones that simulate the arena), state setters must not share data between games
+		bool asyncEnvReset = false;
+
 		int randomSeed = 123;
 		int checkpointsToKeep = 5; // Checkpoint storage limit before old checkpoints are deleted, set to -1 to disable
 		LearnerDeviceType deviceType = LearnerDeviceType::AUTO; // Auto will use your CUDA GPU if available
@@ -77,6 +115,12 @@ namespace RLGPC {
 		std::string metricsGroupName = "unnamed-runs"; // Group name for the python metrics receiver
 		std::string metricsRunName = "rlgymppo-cpp-run"; // Run name for the python metrics receiver
 
+		// Where metrics are sent, metrics are always sent from a background thread
+		// The python interpreter is only started for the PYTHON sink
+		// For the other sinks, run python_scripts/metric_receiver.py separately to forward them to wandb
+		MetricSinkType metricsSink = MetricSinkType::PYTHON;
+		std::filesystem::path metricsSinkPath = "metrics.ndjson"; // File or socket path for non-python sinks
+
 		SkillTrackerConfig skillTrackerConfig = {};
 	};
 }
\ No newline at end of file
@@ -15,6 +15,8 @@ namespace RLGPC {
 		int64_t miniBatchSize = 0; // Set to 0 to just use batchSize
 
 		// Experimental, improves PPO learn speed
+		// Runs the forward/backward passes in bf16, weights and loss reductions stay fp32
+		// On CPU, this requires AVX512-BF16 or AMX-BF16 (it is disabled with a warning otherwise)
 		// If this causes your learning to collapse, please let me know
 		bool autocastLearn = false;
 
@@ -24,6 +26,18 @@ namespace RLGPC {
 		// Temperature of the policy's softmax distribution
 		float policyTemperature = 1;
 
+		// Off-policy correction for steps collected by older versions of the policy (decoupled PPO)
+		// The PPO clip is centered on the proximal policy (the policy from before the learn step) instead of the behavior policy (the one that collected the step),
+		//	and each step is weighted by (proximal prob / behavior prob), truncated to offPolicyWeightClip
+		// Enabled automatically with LearnerConfig::asyncLearn
+		bool offPolicyCorrection = false;
+		float offPolicyWeightClip = 1.f;
+
+		// Steps collected by a policy more than this many versions behind the current policy are ignored
+		// Set to -1 to disable
+		// With LearnerConfig::asyncLearn, every step is at least 1 version behind, so 1 is the minimum
+		int maxPolicyLag = -1;
+
 		// https://openai.com/index/how-ai-training-scales/
 		// Measures the noise of both policy and critic gradients every epoch
 		bool measureGradientNoise = false;
@@ -1,15 +1,53 @@
 #include "GameInst.h"
 
 void RLGPC::GameInst::Start() {
+	if (_episodeRestored) {
+		_episodeRestored = false;
+		return;
+	}
+
 	curObs = gym->Reset();
 }
 
-RLGSC::Gym::StepResult RLGPC::GameInst::Step(const IList& actions) {
+void RLGPC::GameInst::SerializeEpisode(DataStreamOut& out) {
+	gym->SerializeEpisode(out);
+	out.Write<float>(curEpRew);
+}
+
+bool RLGPC::GameInst::DeserializeEpisode(DataStreamIn& in) {
+	bool restored;
+	try {
+		restored = gym->DeserializeEpisode(in);
+	} catch (std::exception& e) {
+		restored = false;
+	}
+
+	if (restored) {
+		curEpRew = in.Read<float>();
+		curObs = match->BuildObservations(*gym->prevState);
+	} else {
+		curEpRew = 0;
+		curObs = gym->Reset();
+	}
+
+	_episodeRestored = true;
+	return restored;
+}
+
+const RLGSC::Gym::StepResult& RLGPC::GameInst::Step(const IList& actions) {
 
 	// Step with agent actions
-	auto stepResult = gym->Step(actions);
+	gym->Step(actions);
+
+	return FinishStep();
+}
+
+RLGSC::Gym::StepResult& RLGPC::GameInst::StepWithoutRewards(const IList& actions) {
+	return gym->StepWithoutRewards(actions);
+}
 
-	auto& nextObs = stepResult.obs;
+const RLGSC::Gym::StepResult& RLGPC::GameInst::FinishStep() {
+	auto& stepResult = gym->_stepResult;
 
 	{ // Update avg rewards
 		float totalRew = 0;
@@ -22,16 +60,19 @@ RLGSC::Gym::StepResult RLGPC::GameInst::Step(const IList& actions) {
 
 	if (stepCallback)
 		stepCallback(this, stepResult, _metrics);
+	if (metricStepCallback)
+		metricStepCallback(this, stepResult, _metricShard);
 
 	// Environment ending
 	if (stepResult.done) {
-		nextObs = gym->Reset();
+		curObs = gym->Reset();
 		
 		avgEpRew += curEpRew;
 		curEpRew = 0;
+	} else {
+		curObs = stepResult.obs; // Same shape every step, so this reuses curObs's capacity
 	}
 
-	curObs = nextObs;
 	totalSteps++;
 
 	return stepResult;
@@ -2,10 +2,16 @@
 #include "../Lists.h"
 #include "../Util/AvgTracker.h"
 #include "../Util/Report.h"
+#include "../Util/MetricRegistry.h"
 
 namespace RLGPC {
 	typedef std::function<void(class GameInst*, const RLGSC::Gym::StepResult&, Report&)> StepCallback;
 
+	// Faster alternative to StepCallback, the metrics support the same Accum()/AccumAvg() calls as Report,
+	//	but are written without locking and can be read while the game is stepping
+	// For the hottest metrics, intern the key once with MetricRegistry::Intern() and pass that instead of the name
+	typedef std::function<void(class GameInst*, const RLGSC::Gym::StepResult&, MetricShard&)> MetricStepCallback;
+
 	// Environment creation func for each ThreadAgent
 	struct EnvCreateResult {
 		RLGSC::Match* match;
@@ -30,9 +36,14 @@ namespace RLGPC {
 		AvgTracker avgStepRew, avgEpRew;
 
 		// Will be reset every iteration, when ResetMetrics() is called
-		Report _metrics = {};
+		Report _metrics = {}; // Written by stepCallback
+		MetricShard _metricShard = {}; // Written by metricStepCallback, can be read from other threads while the game is stepping
 
 		StepCallback stepCallback = NULL;
+		MetricStepCallback metricStepCallback = NULL;
+
+		// Set when an episode is restored before Start(), so Start() continues it instead of resetting
+		bool _episodeRestored = false;
 
 		// NOTE: Gym and match will be deleted when GameInst is deleted
 		GameInst(RLGSC::Gym* gym, RLGSC::Match* match) : gym(gym), match(match) {
@@ -45,10 +56,21 @@ namespace RLGPC {
 			avgStepRew.Reset();
 			avgEpRew.Reset();
 			_metrics.Clear();
+			_metricShard.Reset();
 		}
 
 		void Start();
-		RLGSC::Gym::StepResult Step(const IList& actions);
+		// The result is owned by the gym, and only valid until the next step
+		const RLGSC::Gym::StepResult& Step(const IList& actions);
+
+		// Step() split in two, so the rewards of many games can be filled in between (see RLGSC::RewardBatch)
+		// The reward of the result must be filled in before calling FinishStep()
+		RLGSC::Gym::StepResult& StepWithoutRewards(const IList& actions);
+		const RLGSC::Gym::StepResult& FinishStep();
+
+		// Save/restore the current episode, see RLGSC::Gym::SerializeEpisode()
+		void SerializeEpisode(DataStreamOut& out);
+		bool DeserializeEpisode(DataStreamIn& in); // Returns false if the game was reset instead
 
 		~GameInst() {
 			delete gym;
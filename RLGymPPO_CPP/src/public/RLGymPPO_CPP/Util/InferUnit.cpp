@@ -2,6 +2,7 @@
 
 #include <RLGymPPO_CPP/PPO/DiscretePolicy.h>
 #include <RLGymPPO_CPP/PPO/ValueEstimator.h>
+#include <RLGymPPO_CPP/Util/FlatModel.h>
 #include <RLGymPPO_CPP/FrameworkTorch.h>
 #include <torch/csrc/api/include/torch/serialize.h>
 
@@ -26,9 +27,17 @@ RLGPC::InferUnit::InferUnit(
 		critic = new ValueEstimator(obsSize, layerSizes, device);
 	}
 	RG_LOG(" > Loading policy/critic...");
+	auto seq = policy ? policy->seq : critic->seq;
+	if (modelPath.extension() == FlatModel::FILE_EXTENSION) {
+		// Maps the file and uses the weights in-place (on CPU), architecture is checked from the header
+		FlatModel::Load(seq, modelPath, true);
+		RG_LOG(" > Done!");
+		return;
+	}
+
 	try {
 		auto streamIn = std::ifstream(modelPath, std::ios::binary);
-		torch::load(policy ? policy->seq : critic->seq, streamIn, device);
+		torch::load(seq, streamIn, device);
 	} catch (std::exception& e) {
 		RG_ERR_CLOSE(
 			"Failed to load model, checkpoint may be corrupt or of different model arch.\n" <<
@@ -12,6 +12,8 @@ namespace RLGPC {
 		class DiscretePolicy* policy;
 		class ValueEstimator* critic;
 
+		// modelPath can be a torch model (.lt) or a flat model (.flat)
+		// Flat models are memory-mapped and used without copying when inferring on the CPU
 		InferUnit(
 			RLGSC::OBSBuilder* obsBuilder, RLGSC::ActionParser* actionParser, 
 			std::filesystem::path modelPath, bool isPolicy, int obsSize, const RLGPC::IList& layerSizes, bool gpu = false);
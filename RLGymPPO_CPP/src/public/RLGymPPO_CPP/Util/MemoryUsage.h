@@ -0,0 +1,57 @@
+#pragma once
+#include "Report.h"
+
+namespace RLGPC {
+	// Bytes used by each of the learner's big memory consumers
+	struct MemoryUsage {
+		uint64_t
+			arenas = 0,				// RocketSim arenas (Bullet pools) and everything else in each env
+			trajectories = 0,		// Agent trajectories (including spare capacity) and their concatenation when collected
+			experienceBuffer = 0,
+			models = 0,				// Parameters, gradients, and optimizer state
+			minibatchStaging = 0;	// Shuffled batch copies made for each epoch
+
+		constexpr static size_t SUBSYSTEM_AMOUNT = 5;
+		constexpr static const char* SUBSYSTEM_NAMES[SUBSYSTEM_AMOUNT] = {
+			"Arenas", "Trajectories", "Experience Buffer", "Models", "Minibatch Staging"
+		};
+
+		uint64_t* begin() { return &arenas; }
+		const uint64_t* begin() const { return &arenas; }
+		uint64_t* end() { return &arenas + SUBSYSTEM_AMOUNT; }
+		const uint64_t* end() const { return &arenas + SUBSYSTEM_AMOUNT; }
+
+		uint64_t GetTotal() const {
+			uint64_t total = 0;
+			for (uint64_t bytes : *this)
+				total += bytes;
+			return total;
+		}
+
+		// Keeps the max of each subsystem
+		void UpdatePeak(const MemoryUsage& other) {
+			uint64_t* bytes = begin();
+			const uint64_t* otherBytes = other.begin();
+			for (size_t i = 0; i < SUBSYSTEM_AMOUNT; i++)
+				bytes[i] = RS_MAX(bytes[i], otherBytes[i]);
+		}
+
+		// Adds "<prefix> <subsystem> MB" for each subsystem, and "<prefix> Total MB"
+		void AddToReport(Report& report, const std::string& prefix = "Memory") const {
+			const uint64_t* bytes = begin();
+			for (size_t i = 0; i < SUBSYSTEM_AMOUNT; i++)
+				report[prefix + " " + SUBSYSTEM_NAMES[i] + " MB"] = bytes[i] / (1000.0 * 1000.0);
+			report[prefix + " Total MB"] = GetTotal() / (1000.0 * 1000.0);
+		}
+
+		std::string ToString() const {
+			std::stringstream stream;
+			stream << std::fixed << std::setprecision(1);
+			const uint64_t* bytes = begin();
+			for (size_t i = 0; i < SUBSYSTEM_AMOUNT; i++)
+				stream << SUBSYSTEM_NAMES[i] << ": " << (bytes[i] / (1000.0 * 1000.0)) << "MB\n";
+			stream << "Total: " << (GetTotal() / (1000.0 * 1000.0)) << "MB";
+			return stream.str();
+		}
+	};
+}
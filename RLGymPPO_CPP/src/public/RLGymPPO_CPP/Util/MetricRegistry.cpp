@@ -0,0 +1,113 @@
+#include "MetricRegistry.h"
+
+using namespace RLGPC;
+
+constexpr const char* ERROR_PREFIX = "MetricRegistry: ";
+
+// Names are never removed or moved, so readers can use them without locking
+static std::string g_KeyNames[MetricRegistry::MAX_KEYS];
+static std::atomic<uint32_t> g_KeyAmount = 0;
+static std::mutex g_InternMutex = {};
+static std::unordered_map<std::string, uint32_t> g_KeyMap = {};
+
+MetricKey RLGPC::MetricRegistry::Intern(const std::string& name) {
+	thread_local std::unordered_map<std::string, uint32_t> localCache = {};
+
+	auto itr = localCache.find(name);
+	if (itr != localCache.end())
+		return MetricKey{ itr->second };
+
+	uint32_t index;
+	{
+		std::lock_guard<std::mutex> lock(g_InternMutex);
+		auto globalItr = g_KeyMap.find(name);
+		if (globalItr != g_KeyMap.end()) {
+			index = globalItr->second;
+		} else {
+			index = g_KeyAmount.load(std::memory_order_relaxed);
+			if (index >= MAX_KEYS)
+				RG_ERR_CLOSE(ERROR_PREFIX << "Too many metric keys (max " << MAX_KEYS << "), failed to add \"" << name << "\"");
+
+			g_KeyNames[index] = name;
+			g_KeyMap[name] = index;
+			g_KeyAmount.store(index + 1, std::memory_order_release);
+		}
+	}
+
+	localCache[name] = index;
+	return MetricKey{ index };
+}
+
+const std::string& RLGPC::MetricRegistry::GetName(MetricKey key) {
+	RG_ASSERT(key.index < g_KeyAmount.load(std::memory_order_acquire));
+	return g_KeyNames[key.index];
+}
+
+uint32_t RLGPC::MetricRegistry::GetKeyAmount() {
+	return g_KeyAmount.load(std::memory_order_acquire);
+}
+
+void RLGPC::MetricShard::AddToReport(Report& report) const {
+	_ForEachSlot(
+		[&](uint32_t index, const Slot& slot) {
+			uint8_t flags = slot.flags.load(std::memory_order_relaxed);
+			if (!flags)
+				return;
+
+			double total = slot.total.load(std::memory_order_relaxed);
+			double count = slot.count.load(std::memory_order_relaxed);
+			if (index < _baseline.size()) {
+				total -= _baseline[index].total;
+				count -= _baseline[index].count;
+			}
+
+			const std::string& name = MetricRegistry::GetName(MetricKey{ index });
+			if (flags & FLAG_AVG) {
+				if (count > 0) {
+					report.Accum(name + "_avg_total", total);
+					report.Accum(name + "_avg_count", count);
+				}
+			} else if (total != 0 || index >= _baseline.size()) {
+				report.Accum(name, total);
+			}
+		}
+	);
+}
+
+bool RLGPC::MetricShard::IsEmpty() const {
+	bool empty = true;
+	_ForEachSlot(
+		[&](uint32_t index, const Slot& slot) {
+			if (!empty || !slot.flags.load(std::memory_order_relaxed))
+				return;
+
+			if (index >= _baseline.size()) {
+				empty = false;
+			} else {
+				empty =
+					slot.total.load(std::memory_order_relaxed) == _baseline[index].total &&
+					slot.count.load(std::memory_order_relaxed) == _baseline[index].count;
+			}
+		}
+	);
+	return empty;
+}
+
+void RLGPC::MetricShard::Reset() {
+	_ForEachSlot(
+		[&](uint32_t index, const Slot& slot) {
+			if (index >= _baseline.size())
+				_baseline.resize(index + 1, SlotValue{ 0, 0 });
+
+			_baseline[index] = {
+				slot.total.load(std::memory_order_relaxed),
+				slot.count.load(std::memory_order_relaxed)
+			};
+		}
+	);
+}
+
+RLGPC::MetricShard::~MetricShard() {
+	for (auto& block : blocks)
+		delete block.load();
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include "Report.h"
+
+namespace RLGPC {
+	// Handle to an interned metric name
+	// Interning is done once, after that writing a metric is just an array index
+	struct MetricKey {
+		uint32_t index = UINT32_MAX;
+
+		bool IsValid() const { return index != UINT32_MAX; }
+	};
+
+	// Global name <-> key table, shared by every MetricShard
+	namespace MetricRegistry {
+		constexpr uint32_t MAX_KEYS = 4096;
+
+		// Thread-safe, uses a thread-local cache so repeated lookups of the same name never lock
+		RG_IMEXPORT MetricKey Intern(const std::string& name);
+
+		RG_IMEXPORT const std::string& GetName(MetricKey key);
+		RG_IMEXPORT uint32_t GetKeyAmount();
+	}
+
+	// Metrics written by a single thread (e.g. the step callback of one game)
+	// Writing never locks or allocates (apart from the first time a key is used)
+	// Any other thread can read it at the same time without stopping the writer
+	//
+	// Slots only ever grow, the reader keeps a baseline so it can report the change since the last Reset()
+	class RG_IMEXPORT MetricShard {
+	public:
+		constexpr static uint32_t BLOCK_SIZE = 64;
+		constexpr static uint32_t MAX_BLOCKS = MetricRegistry::MAX_KEYS / BLOCK_SIZE;
+
+		enum : uint8_t {
+			FLAG_ACCUM = 1 << 0,
+			FLAG_AVG = 1 << 1
+		};
+
+		struct Slot {
+			std::atomic<double> total = 0, count = 0;
+			std::atomic<uint8_t> flags = 0;
+		};
+
+		struct Block {
+			Slot slots[BLOCK_SIZE];
+		};
+
+		// Written only by the owning thread, published with release so readers see fully constructed blocks
+		std::atomic<Block*> blocks[MAX_BLOCKS] = {};
+
+		struct SlotValue {
+			double total, count;
+		};
+		std::vector<SlotValue> _baseline = {}; // Only touched by the reader
+
+		MetricShard() = default;
+		RG_NO_COPY(MetricShard);
+
+		// Writer side
+
+		void Accum(MetricKey key, double val) {
+			Slot& slot = _GetSlot(key);
+			slot.total.store(slot.total.load(std::memory_order_relaxed) + val, std::memory_order_relaxed);
+			_SetFlag(slot, FLAG_ACCUM);
+		}
+
+		// Same as Report::AccumAvg(), but the total and count live in one slot
+		void AccumAvg(MetricKey key, double val) {
+			Slot& slot = _GetSlot(key);
+			slot.total.store(slot.total.load(std::memory_order_relaxed) + val, std::memory_order_relaxed);
+			slot.count.store(slot.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			_SetFlag(slot, FLAG_AVG);
+		}
+
+		// Slower (hashes the name), prefer caching the key from MetricRegistry::Intern()
+		void Accum(const std::string& key, double val) {
+			Accum(MetricRegistry::Intern(key), val);
+		}
+		void AccumAvg(const std::string& key, double val) {
+			AccumAvg(MetricRegistry::Intern(key), val);
+		}
+
+		// Reader side
+
+		// Adds everything written since the last Reset() to the report, using the same keys as Report::Accum() and Report::AccumAvg()
+		// If multiple shards are added to the same report, their values are summed
+		void AddToReport(Report& report) const;
+
+		Report ToReport() const {
+			Report report = {};
+			AddToReport(report);
+			return report;
+		}
+
+		bool IsEmpty() const;
+
+		// Makes the current values the new baseline, doesn't touch the slots themselves
+		void Reset();
+
+		~MetricShard();
+
+		Slot& _GetSlot(MetricKey key) {
+			uint32_t blockIdx = key.index / BLOCK_SIZE;
+			Block* block = blocks[blockIdx].load(std::memory_order_relaxed);
+			if (!block) {
+				block = new Block();
+				blocks[blockIdx].store(block, std::memory_order_release);
+			}
+			return block->slots[key.index % BLOCK_SIZE];
+		}
+
+		static void _SetFlag(Slot& slot, uint8_t flag) {
+			uint8_t flags = slot.flags.load(std::memory_order_relaxed);
+			if (!(flags & flag))
+				slot.flags.store(flags | flag, std::memory_order_relaxed);
+		}
+
+		template <typename FN>
+		void _ForEachSlot(FN fn) const {
+			for (uint32_t i = 0; i < MAX_BLOCKS; i++) {
+				Block* block = blocks[i].load(std::memory_order_acquire);
+				if (!block)
+					continue;
+				for (uint32_t j = 0; j < BLOCK_SIZE; j++)
+					fn(i * BLOCK_SIZE + j, block->slots[j]);
+			}
+		}
+	};
+}
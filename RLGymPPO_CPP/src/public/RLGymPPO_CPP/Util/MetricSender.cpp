@@ -1,46 +1,213 @@
 #include "MetricSender.h"
 
 #include "Timer.h"
+#include "../../libsrc/json/nlohmann/json.hpp"
 
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef RG_NO_PYTHON
 namespace py = pybind11;
+#endif
 using namespace RLGPC;
 
-RLGPC::MetricSender::MetricSender(std::string _projectName, std::string _groupName, std::string _runName, std::string runID) :
-	projectName(_projectName), groupName(_groupName), runName(_runName) {
+// Makes an ID in the same style as wandb, so the receiver can resume the run with it
+std::string MakeRunID() {
+	constexpr const char CHARS[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+	std::random_device randDevice;
+	std::string result = {};
+	for (int i = 0; i < 8; i++)
+		result += CHARS[randDevice() % (sizeof(CHARS) - 1)];
+	return result;
+}
+
+RLGPC::MetricSender::MetricSender(
+	std::string _projectName, std::string _groupName, std::string _runName, std::string runID,
+	MetricSinkType sinkType, std::filesystem::path sinkPath) :
+	projectName(_projectName), groupName(_groupName), runName(_runName), sinkType(sinkType), sinkPath(sinkPath) {
 
 	RG_LOG("Initializing MetricSender...");
 
-	try {
-		pyMod = py::module::import("python_scripts.metric_receiver");
-	} catch (std::exception& e) {
-		RG_ERR_CLOSE("MetricSender: Failed to import metrics receiver, exception: " << e.what());
-	}
+	if (sinkType == MetricSinkType::PYTHON) {
+#ifdef RG_NO_PYTHON
+		RG_ERR_CLOSE("MetricSender: Can't use the python metrics sink, RLGymPPO_CPP was built with RG_NO_PYTHON");
+#else
+		// The learner thread may have released the GIL
+		py::gil_scoped_acquire gil;
+
+		try {
+			pyMod = py::module::import("python_scripts.metric_receiver");
+		} catch (std::exception& e) {
+			RG_ERR_CLOSE("MetricSender: Failed to import metrics receiver, exception: " << e.what());
+		}
 
-	try {
-		auto returedRunID = pyMod.attr("init")(PY_EXEC_PATH, projectName, groupName, runName, runID);
-		curRunID = returedRunID.cast<std::string>();
+		try {
+			auto returedRunID = pyMod.attr("init")(PY_EXEC_PATH, projectName, groupName, runName, runID);
+			curRunID = returedRunID.cast<std::string>();
+			RG_LOG(" > " << (runID.empty() ? "Starting" : "Continuing") << " run with ID : \"" << curRunID << "\"...");
+
+		} catch (std::exception& e) {
+			RG_ERR_CLOSE("MetricSender: Failed to initialize in Python, exception: " << e.what());
+		}
+#endif
+	} else {
+		if (sinkPath.empty())
+			RG_ERR_CLOSE("MetricSender: A sink path is required for non-python metric sinks");
+
+		curRunID = runID.empty() ? MakeRunID() : runID;
 		RG_LOG(" > " << (runID.empty() ? "Starting" : "Continuing") << " run with ID : \"" << curRunID << "\"...");
 
-	} catch (std::exception& e) {
-		RG_ERR_CLOSE("MetricSender: Failed to initialize in Python, exception: " << e.what());
+		if (sinkType == MetricSinkType::NDJSON_FILE) {
+			fileOut = std::ofstream(sinkPath, std::ios::app);
+			if (!fileOut.good())
+				RG_ERR_CLOSE("MetricSender: Failed to open metrics file " << sinkPath);
+			RG_LOG(" > Writing metrics to " << sinkPath);
+		} else {
+#ifdef _WIN32
+			RG_ERR_CLOSE("MetricSender: Unix socket metric sinks are not supported on Windows");
+#else
+			if (!_ConnectSocket())
+				RG_LOG(" > WARNING: Failed to connect to metrics socket " << sinkPath << ", will retry on each send");
+#endif
+		}
+
+		// Tells the receiver which run these metrics belong to
+		nlohmann::json initJSON = {};
+		initJSON["type"] = "init";
+		initJSON["project"] = projectName;
+		initJSON["group"] = groupName;
+		initJSON["name"] = runName;
+		initJSON["run_id"] = curRunID;
+		_WriteLine(initJSON.dump());
 	}
 
+	thread = std::thread(&MetricSender::_ThreadEntry, this);
+
 	RG_LOG(" > MetricSender initalized.");
 }
 
 void RLGPC::MetricSender::Send(const Report& report) {
-	py::dict reportDict = {};
+	uint64_t writeIdx = queueWriteIdx.load(std::memory_order_relaxed);
+	if (writeIdx - queueReadIdx.load(std::memory_order_acquire) >= QUEUE_CAPACITY) {
+		droppedAmount++;
+		RG_LOG("WARNING: MetricSender: Metrics sink is falling behind, dropped a report");
+		return;
+	}
+
+	queue[writeIdx % QUEUE_CAPACITY] = report;
+	queueWriteIdx.store(writeIdx + 1, std::memory_order_release);
+
+	wakeCounter++;
+	wakeCounter.notify_one();
+}
 
-	for (auto& pair : report.data)
-		reportDict[pair.first.c_str()] = pair.second;
+void RLGPC::MetricSender::_ThreadEntry() {
+	while (true) {
+		uint64_t wakeVal = wakeCounter.load();
 
-	try {
-		pyMod.attr("add_metrics")(reportDict);
-	} catch (std::exception& e) {
-		RG_ERR_CLOSE("MetricSender: Failed to add metrics, exception: " << e.what());
+		uint64_t readIdx = queueReadIdx.load(std::memory_order_relaxed);
+		while (readIdx < queueWriteIdx.load(std::memory_order_acquire)) {
+			_SendToSink(queue[readIdx % QUEUE_CAPACITY]);
+			readIdx++;
+			queueReadIdx.store(readIdx, std::memory_order_release);
+		}
+
+		if (shouldShutdown)
+			return;
+
+		wakeCounter.wait(wakeVal);
 	}
 }
 
+void RLGPC::MetricSender::_SendToSink(const Report& report) {
+	if (sinkType == MetricSinkType::PYTHON) {
+#ifndef RG_NO_PYTHON
+		py::gil_scoped_acquire gil;
+
+		py::dict reportDict = {};
+		for (auto& pair : report.data)
+			reportDict[pair.first.c_str()] = pair.second;
+
+		try {
+			pyMod.attr("add_metrics")(reportDict);
+		} catch (std::exception& e) {
+			RG_ERR_CLOSE("MetricSender: Failed to add metrics, exception: " << e.what());
+		}
+#endif
+	} else {
+		nlohmann::json j = {};
+		j["type"] = "metrics";
+		j["metrics"] = report.data;
+		_WriteLine(j.dump());
+	}
+}
+
+void RLGPC::MetricSender::_WriteLine(const std::string& line) {
+	if (sinkType == MetricSinkType::NDJSON_FILE) {
+		fileOut << line << '\n';
+		fileOut.flush();
+	} else if (sinkType == MetricSinkType::UNIX_SOCKET) {
+#ifndef _WIN32
+		if (socketFD < 0 && !_ConnectSocket())
+			return; // Receiver isn't there, drop it
+
+		std::string data = line + '\n';
+		size_t sent = 0;
+		while (sent < data.size()) {
+			ssize_t result = ::send(socketFD, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+			if (result <= 0) {
+				// Receiver went away, reconnect next time
+				close(socketFD);
+				socketFD = -1;
+				return;
+			}
+			sent += result;
+		}
+#endif
+	}
+}
+
+bool RLGPC::MetricSender::_ConnectSocket() {
+#ifdef _WIN32
+	return false;
+#else
+	socketFD = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (socketFD < 0)
+		return false;
+
+	sockaddr_un addr = {};
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, sinkPath.c_str(), sizeof(addr.sun_path) - 1);
+	if (connect(socketFD, (sockaddr*)&addr, sizeof(addr)) != 0) {
+		close(socketFD);
+		socketFD = -1;
+		return false;
+	}
+
+	return true;
+#endif
+}
+
 RLGPC::MetricSender::~MetricSender() {
-	
-}
\ No newline at end of file
+	// Finish sending everything that's queued
+	shouldShutdown = true;
+	wakeCounter++;
+	wakeCounter.notify_one();
+	if (thread.joinable())
+		thread.join();
+
+#ifndef _WIN32
+	if (socketFD >= 0)
+		close(socketFD);
+#endif
+
+#ifndef RG_NO_PYTHON
+	if (pyMod) {
+		py::gil_scoped_acquire gil;
+		pyMod = {};
+	}
+#endif
+}
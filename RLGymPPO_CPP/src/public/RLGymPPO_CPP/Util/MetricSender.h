@@ -1,19 +1,55 @@
 #pragma once
 #include "Report.h"
+#ifndef RG_NO_PYTHON
 #include <pybind11/pybind11.h>
+#endif
 
 namespace RLGPC {
+	enum class MetricSinkType {
+		PYTHON,			// Calls the embedded python metrics receiver
+		NDJSON_FILE,	// Appends one JSON object per line to a file, python_scripts/metric_receiver.py can follow it
+		UNIX_SOCKET		// Sends the same lines as NDJSON_FILE to a Unix socket (e.g. python_scripts/metric_receiver.py --socket)
+	};
+
+	// Sends metrics on a background thread, so a slow receiver (e.g. wandb) never stalls learning
+	// Send() only pushes the report into a lock-free single-producer queue
 	struct RG_IMEXPORT MetricSender {
 		std::string curRunID;
 		std::string projectName, groupName, runName;
+
+		MetricSinkType sinkType;
+		std::filesystem::path sinkPath; // File or socket path for non-python sinks
+
+#ifndef RG_NO_PYTHON
 		pybind11::module pyMod;
+#endif
+
+		constexpr static size_t QUEUE_CAPACITY = 64;
+		Report queue[QUEUE_CAPACITY];
+		std::atomic<uint64_t> queueWriteIdx = 0, queueReadIdx = 0;
+		std::atomic<uint64_t> wakeCounter = 0; // Waited on by the sink thread
+		std::atomic<uint64_t> droppedAmount = 0;
+		std::atomic<bool> shouldShutdown = false;
+		std::thread thread;
+
+		std::ofstream fileOut;
+		int socketFD = -1;
+
+		MetricSender(
+			std::string projectName = {}, std::string groupName = {}, std::string runName = {}, std::string runID = {},
+			MetricSinkType sinkType = MetricSinkType::PYTHON, std::filesystem::path sinkPath = {}
+		);
 
-		MetricSender(std::string projectName = {}, std::string groupName = {}, std::string runName = {}, std::string runID = {});
-		
 		RG_NO_COPY(MetricSender);
 
+		// Never blocks, if the sink is too far behind the report is dropped
 		void Send(const Report& report);
 
 		~MetricSender();
+
+		void _ThreadEntry();
+		void _SendToSink(const Report& report);
+		void _WriteLine(const std::string& line);
+		bool _ConnectSocket();
 	};
-}
\ No newline at end of file
+}
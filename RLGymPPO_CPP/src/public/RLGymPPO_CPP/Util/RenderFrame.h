@@ -0,0 +1,67 @@
+#pragma once
+#include "../Framework.h"
+
+// Binary layout of the shared-memory render ring written by RenderSender
+// Read by python_scripts/render_receiver.py, so any change here must be mirrored there (and RENDER_RING_VERSION bumped)
+//
+// Shared memory layout:
+//	RenderRingHeader
+//	RenderRingSlot[slotAmount]
+//
+// Each slot is a seqlock: its seq is odd while a frame is being written, and even once it's complete
+// A reader copies the slot of the latest frame, then checks that the seq didn't change while copying
+// Writers never wait on readers, if a reader is too slow it just misses frames
+
+namespace RLGPC {
+	constexpr uint32_t RENDER_RING_MAGIC = 0x46524752; // "RGRF"
+	constexpr uint32_t RENDER_RING_VERSION = 1;
+	constexpr uint32_t RENDER_RING_SLOT_AMOUNT = 8;
+
+	constexpr int RENDER_MAX_PLAYERS = 8; // Players past this are not rendered
+	constexpr int RENDER_MAX_BOOST_PADS = 34;
+
+	struct RenderPhys {
+		float pos[3], forward[3], right[3], up[3], vel[3], angVel[3];
+	};
+	static_assert(sizeof(RenderPhys) == 72);
+
+	struct RenderPlayer {
+		uint32_t carId;
+		uint8_t team, isDemoed, onGround, ballTouched, hasFlip, _pad[3];
+		float boostAmount;
+		RenderPhys phys;
+		float action[8];
+	};
+	static_assert(sizeof(RenderPlayer) == 120);
+
+	struct RenderFrame {
+		uint64_t frameIndex;
+		uint32_t gameMode; // Index into GAMEMODE_STRS
+		uint32_t playerAmount;
+		uint32_t boostPadAmount;
+		int32_t teamGoals[2];
+		uint32_t _pad;
+		RenderPhys ball;
+		uint8_t boostPads[RENDER_MAX_BOOST_PADS];
+		uint8_t _pad2[6];
+		RenderPlayer players[RENDER_MAX_PLAYERS];
+	};
+	static_assert(sizeof(RenderFrame) == 1104);
+
+	struct alignas(64) RenderRingHeader {
+		uint32_t magic, version, slotAmount, slotSize;
+		std::atomic<uint64_t> nextFrame; // Index of the next frame to be claimed by a writer
+		std::atomic<uint64_t> latestFrame; // Index + 1 of the newest complete frame, 0 if none yet
+		std::atomic<uint64_t> droppedFrames; // Frames skipped because their slot was still being written
+	};
+	static_assert(sizeof(RenderRingHeader) == 64);
+
+	struct alignas(64) RenderRingSlot {
+		std::atomic<uint64_t> seq;
+		RenderFrame frame;
+	};
+	static_assert(sizeof(RenderRingSlot) == 1152);
+
+	// Lock-free and address-free, so it works across processes
+	static_assert(std::atomic<uint64_t>::is_always_lock_free);
+}
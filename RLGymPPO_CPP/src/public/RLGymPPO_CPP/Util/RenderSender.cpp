@@ -1,100 +1,145 @@
 #include "RenderSender.h"
 
-#include "../../libsrc/json/nlohmann/json.hpp"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
-namespace py = pybind11;
-using namespace nlohmann;
 using namespace RLGSC;
 
-RLGPC::RenderSender::RenderSender() {
-	RG_LOG("Initializing RenderSender...");
-
-	try {
-		RG_LOG("Current dir: " << std::filesystem::current_path());
-		pyMod = py::module::import("python_scripts.render_receiver");
-	} catch (std::exception& e) {
-		RG_ERR_CLOSE("RenderSender: Failed to import render receiver, exception: " << e.what());
-	}
-
-	RG_LOG(" > RenderSender initalized.");
-}
-
-FList VecToList(const Vec& vec) {
-	return FList({ vec.x, vec.y, vec.z });
-}
-
-json PhysToJSON(const PhysObj& obj) {
-	json j = {};
-
-	j["pos"] = VecToList(obj.pos);
-
-	j["forward"] = VecToList(obj.rotMat.forward);
-	j["right"] = VecToList(obj.rotMat.right);
-	j["up"] = VecToList(obj.rotMat.up);
-
-	j["vel"] = VecToList(obj.vel);
-	j["ang_vel"] = VecToList(obj.angVel);
-
-	return j;
-}
-
-json PlayerToJSON(const PlayerData& player) {
-	json j = {};
+constexpr const char* ERROR_PREFIX = "RenderSender: ";
 
-	j["car_id"] = player.carId;
-	j["team_num"] = (int)player.team;
-	j["phys"] = PhysToJSON(player.phys);
-	j["boost_pickups"] = player.boostPickups;
-	j["is_demoed"] = player.carState.isDemoed;
-	j["on_ground"] = player.carState.isOnGround;
-	j["ball_touched"] = player.ballTouchedStep;
-	j["has_flip"] = player.hasFlip;
-	j["boost_amount"] = player.boostFraction;
+RLGPC::RenderSender::RenderSender(std::string shmName) : shmName(shmName) {
+	RG_LOG("Initializing RenderSender...");
 
-	return j;
+	mappingSize = sizeof(RenderRingHeader) + sizeof(RenderRingSlot) * RENDER_RING_SLOT_AMOUNT;
+
+	void* mapping;
+#ifdef _WIN32
+	HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)mappingSize, shmName.c_str());
+	if (!handle)
+		RG_ERR_CLOSE(ERROR_PREFIX << "Failed to create shared memory \"" << shmName << "\" (error " << GetLastError() << ")");
+	_mappingHandle = handle;
+
+	mapping = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, mappingSize);
+	if (!mapping)
+		RG_ERR_CLOSE(ERROR_PREFIX << "Failed to map shared memory \"" << shmName << "\" (error " << GetLastError() << ")");
+#else
+	std::string posixName = "/" + shmName;
+	int fd = shm_open(posixName.c_str(), O_CREAT | O_RDWR, 0666);
+	if (fd == -1)
+		RG_ERR_CLOSE(ERROR_PREFIX << "Failed to create shared memory \"" << posixName << "\" (errno " << errno << ")");
+
+	if (ftruncate(fd, mappingSize) == -1)
+		RG_ERR_CLOSE(ERROR_PREFIX << "Failed to resize shared memory \"" << posixName << "\" (errno " << errno << ")");
+
+	mapping = mmap(NULL, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+		RG_ERR_CLOSE(ERROR_PREFIX << "Failed to map shared memory \"" << posixName << "\" (errno " << errno << ")");
+#endif
+
+	// Might be left over from a previous run, so clear it before writing the header
+	memset(mapping, 0, mappingSize);
+	header = new (mapping) RenderRingHeader();
+	slots = (RenderRingSlot*)((uint8_t*)mapping + sizeof(RenderRingHeader));
+	for (uint32_t i = 0; i < RENDER_RING_SLOT_AMOUNT; i++)
+		new (&slots[i]) RenderRingSlot();
+
+	header->version = RENDER_RING_VERSION;
+	header->slotAmount = RENDER_RING_SLOT_AMOUNT;
+	header->slotSize = sizeof(RenderRingSlot);
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = RENDER_RING_MAGIC;
+
+	RG_LOG(" > RenderSender initalized, writing frames to shared memory \"" << shmName << "\".");
 }
 
-json GameStateToJSON(const GameState& state) {
-	json j = {};
-	
-	j["ball"] = PhysToJSON(state.ball);
-
-	std::vector<json> players;
-	for (auto& player : state.players)
-		players.push_back(PlayerToJSON(player));
-
-	j["players"] = players;
-	j["boost_pads"] = state.boostPads;
-	j["team_goals"] = state.scoreLine.teamGoals;
-
-	return j;
+static void WritePhys(RLGPC::RenderPhys& out, const PhysObj& obj) {
+	auto fnWriteVec = [](float* out, const Vec& vec) {
+		out[0] = vec.x;
+		out[1] = vec.y;
+		out[2] = vec.z;
+	};
+
+	fnWriteVec(out.pos, obj.pos);
+	fnWriteVec(out.forward, obj.rotMat.forward);
+	fnWriteVec(out.right, obj.rotMat.right);
+	fnWriteVec(out.up, obj.rotMat.up);
+	fnWriteVec(out.vel, obj.vel);
+	fnWriteVec(out.angVel, obj.angVel);
 }
 
-std::vector<json> ActionSetToJSON(const ActionSet& actions) {
-	std::vector<json> js = {};
-	for (auto& action : actions) {
-		FList vals  = FList(action.begin(), action.end());
-		js.push_back(json(vals));
+static void WriteFrame(RLGPC::RenderFrame& frame, uint64_t frameIndex, const GameState& state, const ActionSet& actions) {
+	frame.frameIndex = frameIndex;
+	frame.gameMode = state.lastArena ? (uint32_t)state.lastArena->gameMode : (uint32_t)GameMode::SOCCAR;
+	frame.teamGoals[0] = state.scoreLine.teamGoals[0];
+	frame.teamGoals[1] = state.scoreLine.teamGoals[1];
+
+	WritePhys(frame.ball, state.ball);
+
+	frame.boostPadAmount = RS_MIN(state.boostPads.size(), (size_t)RLGPC::RENDER_MAX_BOOST_PADS);
+	for (uint32_t i = 0; i < frame.boostPadAmount; i++)
+		frame.boostPads[i] = state.boostPads[i];
+
+	frame.playerAmount = RS_MIN(state.players.size(), (size_t)RLGPC::RENDER_MAX_PLAYERS);
+	for (uint32_t i = 0; i < frame.playerAmount; i++) {
+		auto& player = state.players[i];
+		auto& out = frame.players[i];
+
+		out.carId = player.carId;
+		out.team = (uint8_t)player.team;
+		out.isDemoed = player.carState.isDemoed;
+		out.onGround = player.carState.isOnGround;
+		out.ballTouched = player.ballTouchedStep;
+		out.hasFlip = player.hasFlip;
+		out.boostAmount = player.boostFraction;
+		WritePhys(out.phys, player.phys);
+
+		if (i < actions.size()) {
+			std::copy(actions[i].begin(), actions[i].end(), out.action);
+		} else {
+			std::fill(std::begin(out.action), std::end(out.action), 0.f);
+		}
 	}
-
-	return js;
 }
 
 void RLGPC::RenderSender::Send(const GameState& state, const ActionSet& actions) {
-	json j = {};
-	j["gamemode"] = state.lastArena ? GAMEMODE_STRS[(int)state.lastArena->gameMode] : "soccar";
-	j["state"] = GameStateToJSON(state);
-	j["actions"] = ActionSetToJSON(actions);
-	
-	std::string jStr = j.dump();
-
-	try {
-		pyMod.attr("render_state")(jStr);
-	} catch (std::exception& e) {
-		RG_ERR_CLOSE("RenderSender: Failed to send gamestate, exception: " << e.what());
+	uint64_t frameIndex = header->nextFrame.fetch_add(1, std::memory_order_relaxed);
+	RenderRingSlot& slot = slots[frameIndex % RENDER_RING_SLOT_AMOUNT];
+
+	// Claim the slot by making its seq odd
+	uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+	if ((seq & 1) || !slot.seq.compare_exchange_strong(seq, seq + 1, std::memory_order_relaxed)) {
+		// Another thread is still writing to this slot, the newest frame wins anyway
+		header->droppedFrames.fetch_add(1, std::memory_order_relaxed);
+		return;
 	}
+	std::atomic_thread_fence(std::memory_order_release);
+
+	WriteFrame(slot.frame, frameIndex, state, actions);
+
+	slot.seq.store(seq + 2, std::memory_order_release);
+
+	// Publish, unless a newer frame was already published by another thread
+	uint64_t latest = header->latestFrame.load(std::memory_order_relaxed);
+	while (latest < frameIndex + 1 && !header->latestFrame.compare_exchange_weak(latest, frameIndex + 1, std::memory_order_release));
 }
 
 RLGPC::RenderSender::~RenderSender() {
-
-}
\ No newline at end of file
+	if (!header)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(header);
+	CloseHandle((HANDLE)_mappingHandle);
+#else
+	munmap(header, mappingSize);
+	shm_unlink(("/" + shmName).c_str());
+#endif
+}
@@ -1,19 +1,27 @@
 #pragma once
 #include "Report.h"
-#include <pybind11/pybind11.h>
+#include "RenderFrame.h"
 #include <RLGymSim_CPP/Utils/Gamestates/GameState.h>
 #include <RLGymSim_CPP/Utils/BasicTypes/Action.h>
 
 namespace RLGPC {
+	// Writes frames into a shared-memory ring (see RenderFrame.h) for a separate viewer process to read
+	// Run python_scripts/render_receiver.py to forward frames to RocketSimVis
 	struct RG_IMEXPORT RenderSender {
-		pybind11::module pyMod;
+		std::string shmName;
 
-		RenderSender();
+		RenderRingHeader* header = NULL;
+		RenderRingSlot* slots = NULL;
+		size_t mappingSize = 0;
+		void* _mappingHandle = NULL; // Windows only
+
+		RenderSender(std::string shmName);
 
 		RG_NO_COPY(RenderSender);
 
+		// Never blocks, the frame is dropped if its slot is still being written by another thread
 		void Send(const RLGSC::GameState& state, const RLGSC::ActionSet& actions);
 
 		~RenderSender();
 	};
-}
\ No newline at end of file
+}
@@ -11,9 +11,10 @@ namespace RLGPC {
 		// If NULL, the learner's env create func is used
 		EnvCreateFn envCreateFunc = NULL;
 
-		// Step callback for eval environments
-		// If NULL, the learner's step callback func is used
+		// Step callbacks for eval environments
+		// If both are NULL, the learner's step callbacks are used
 		StepCallback stepCallback = NULL;
+		MetricStepCallback metricStepCallback = NULL;
 
 		int numEnvs = 4; // Number of environments for evaluation
 		float simTime = 60; // Time (in seconds) to simulate each iteration
@@ -17,19 +17,24 @@ using namespace RLGSC; // RLGymSim
 // WARNING: This is called from multiple threads, often simultaneously, 
 //	so don't access things apart from these arguments unless you know what you're doing.
 // gameMetrics: The metrics for this specific game
-void OnStep(GameInst* gameInst, const RLGSC::Gym::StepResult& stepResult, Report& gameMetrics) {
-
-	auto& gameState = stepResult.state;
+void OnStep(GameInst* gameInst, const RLGSC::Gym::StepResult& stepResult, MetricShard& gameMetrics) {
+	// Metric names are interned once, so accumulating them is just an array write
+	static const MetricKey
+		KEY_PLAYER_SPEED = MetricRegistry::Intern("player_speed"),
+		KEY_BALL_TOUCH_RATIO = MetricRegistry::Intern("ball_touch_ratio"),
+		KEY_IN_AIR_RATIO = MetricRegistry::Intern("in_air_ratio");
+
+	auto& gameState = *stepResult.state;
 	for (auto& player : gameState.players) {
 		// Track average player speed
 		float speed = player.phys.vel.Length();
-		gameMetrics.AccumAvg("player_speed", speed);
+		gameMetrics.AccumAvg(KEY_PLAYER_SPEED, speed);
 
 		// Track ball touch ratio
-		gameMetrics.AccumAvg("ball_touch_ratio", player.ballTouchedStep);
+		gameMetrics.AccumAvg(KEY_BALL_TOUCH_RATIO, player.ballTouchedStep);
 
 		// Track in-air ratio
-		gameMetrics.AccumAvg("in_air_ratio", !player.carState.isOnGround);
+		gameMetrics.AccumAvg(KEY_IN_AIR_RATIO, !player.carState.isOnGround);
 	}
 }
 
@@ -141,7 +146,7 @@ int main() {
 	Learner learner = Learner(EnvCreateFunc, cfg);
 
 	// Set up our callbacks
-	learner.stepCallback = OnStep;
+	learner.metricStepCallback = OnStep;
 	learner.iterationCallback = OnIteration;
 
 	// Start learning!